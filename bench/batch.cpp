@@ -0,0 +1,128 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file batch.cpp (benchmark)
+ *
+ * Batch operations (menu option 24): a random file of seguir/deixar/remover lines is
+ * applied with run_batch(), one operation at a time (follow(), unfollow(), remove_node())
+ * and by replaying the trace recorded by run_batch(); the three graphs must match.
+ * Then the time of a batch of follows against single follows is measured on SQLite.
+ * Build: g++ -O2 bench/batch.cpp -o bench_batch -lsqlite3
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../src/SocialMedia/socialmedia.cpp"
+
+/// @brief Users and links of a network, sorted (comparable between instances)
+static std::string dump(const socialmedia::SocialMedia &sm){
+    std::vector<std::string> rows;
+    sm.visit([&](const std::string &mail, auto&&...){ rows.push_back(mail); },
+             [&](const std::string &src, const std::string &dest, const auto&){ rows.push_back(src + ">" + dest); });
+    std::sort(rows.begin(), rows.end());
+    std::string out;
+    for(const auto &r : rows) out += r + "\n";
+    return out;
+}
+
+static void add_users(socialmedia::SocialMedia &sm, storage::Storage &db, unsigned int n){
+    for(unsigned int i = 0; i < n; i++){
+        std::string mail = "user" + std::to_string(i) + "@bench";
+        if(!sm.insert_node(mail, "Usuario", "01/01/2000", "000", "Cidade").flag)
+            db.save_user(mail, "Usuario", "01/01/2000", "000", "Cidade");
+    }
+}
+
+int main(){
+    const unsigned int USERS = 2000, LINES = 20000;
+    const std::string ops = "/tmp/bench_batch.txt", trace_path = "/tmp/bench_batch.trace";
+    std::mt19937 rng(42);
+    auto mail = [&](){ return "user" + std::to_string(rng() % (USERS + 10)) + "@bench"; };   // Some don't exist
+    std::vector<std::vector<std::string>> lines;
+    for(unsigned int i = 0; i < LINES; i++){
+        unsigned int kind = rng() % 100;
+        if(kind < 2) lines.push_back({"remover", mail()});
+        else lines.push_back({kind < 70 ? "seguir" : "deixar", mail(), mail()});
+        if(rng() % 8 == 0) lines.push_back(lines.back());   // Runs of the same command
+    }
+    {
+        std::ofstream out(ops);
+        for(const auto &l : lines){
+            for(size_t k = 0; k < l.size(); k++) out << (k ? " " : "") << l[k];
+            out << "\n";
+        }
+    }
+    int bad = 0;
+
+    storage::MemoryStorage mem;
+    std::string batched;
+    {
+        socialmedia::SocialMedia sm;
+        add_users(sm, mem, USERS);
+        sm.record_trace(trace_path);
+        sm.run_batch(ops, mem);
+        batched = dump(sm);
+    }
+
+    socialmedia::SocialMedia single;
+    add_users(single, mem, USERS);
+    for(const auto &l : lines){
+        if(l[0] == "seguir") single.follow(l[1], l[2]);
+        else if(l[0] == "deixar") single.unfollow(l[1], l[2]);
+        else single.remove_node(l[1]);
+    }
+    if(dump(single) != batched){
+        std::printf("run_batch() differs from the single operations\n");
+        bad++;
+    }
+
+    std::vector<trace::record_t> records;
+    socialmedia::SocialMedia replayed;
+    add_users(replayed, mem, USERS);
+    if(!trace::load(trace_path, records) || records.empty()) bad++;
+    for(const auto &r : records) replayed.execute(r, mem);
+    if(dump(replayed) != batched){
+        std::printf("Replayed batch records differ from run_batch()\n");
+        bad++;
+    }
+    std::printf("%zu lines, %zu batch records, %s\n", lines.size(), records.size(), bad ? "FALHOU" : "ok");
+
+    // SQLite: one transaction per batch against one per follow
+    const unsigned int FOLLOWS = 2000;
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for(unsigned int i = 0; i < FOLLOWS; i++)
+        pairs.emplace_back("user" + std::to_string(rng() % USERS) + "@bench",
+                           "user" + std::to_string(rng() % USERS) + "@bench");
+    double secs[2];
+    for(int mode = 0; mode < 2; mode++){
+        std::string path = "/tmp/bench_batch" + std::to_string(mode) + ".db";
+        ::unlink(path.c_str());
+        socialmedia::SocialMedia sm;
+        database::Database db(sm, path);
+        db.begin();
+        add_users(sm, db, USERS);
+        db.commit();
+        auto start = std::chrono::steady_clock::now();
+        if(mode) sm.follow_many(pairs, db);
+        else{
+            for(const auto &p : pairs){
+                if(sm.follow(p.first, p.second).flag) continue;
+                const auto *l = sm.link(p.first, p.second);
+                db.save_link(p.first, p.second, l->time, l->weight);
+            }
+        }
+        secs[mode] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ::unlink(path.c_str());
+    }
+    std::printf("SQLite, %u follows: one by one %.1f ms, follow_many %.1f ms (%.1fx)\n",
+                FOLLOWS, secs[0] * 1e3, secs[1] * 1e3, secs[0] / secs[1]);
+    ::unlink(ops.c_str());
+    ::unlink(trace_path.c_str());
+    return bad ? 1 : 0;
+}
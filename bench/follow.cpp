@@ -0,0 +1,55 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file follow.cpp (benchmark)
+ *
+ * Heap allocations and time per follow()/unfollow() on the steady-state path: the users
+ * and their link lists already exist, so every round trip only reuses capacity.
+ * Build: g++ -O2 bench/follow.cpp -o bench_follow -lsqlite3
+ *
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "../src/SocialMedia/socialmedia.cpp"
+
+static size_t allocations = 0;
+
+// Replacements kept out of line: inlined, GCC pairs free() with the new expression
+__attribute__((noinline)) void* operator new(size_t n){
+    allocations++;
+    if(void *p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+int main(int argc, char **argv){
+    const unsigned int USERS = 10000, ROUNDS = argc > 1 ? std::atoi(argv[1]) : 200000;
+    network::Network net;
+    std::vector<std::string> mails;
+    for(unsigned int i = 0; i < USERS; i++){
+        mails.push_back("user" + std::to_string(i) + "@bench");
+        net.insert_node(mails.back(), "Usuario", "01/01/2000", "000", "Cidade");
+    }
+    for(unsigned int i = 0; i < USERS; i++){   // Warm up: give every list its capacity
+        net.follow(mails[i], mails[(i + 1) % USERS]);
+        net.unfollow(mails[i], mails[(i + 1) % USERS]);
+    }
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    size_t failed = 0;
+    for(unsigned int r = 0; r < ROUNDS; r++){
+        const std::string &a = mails[r % USERS], &b = mails[(r % USERS + 1) % USERS];
+        failed += net.follow(a, b).flag;
+        failed += net.unfollow(a, b).flag;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t allocs = allocations - before;
+    std::printf("follow()+unfollow(): %u rounds, %.1f ns/round, %.3f allocations/round, %zu failed\n",
+                ROUNDS, secs * 1e9 / ROUNDS, (double)allocs / ROUNDS, failed);
+    return allocs || failed ? 1 : 0;
+}
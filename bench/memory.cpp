@@ -0,0 +1,98 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file memory.cpp (benchmark)
+ *
+ * Memory report (option 9) against the real heap: operator new is replaced to track the
+ * live bytes and blocks, and networks of growing size (users, links, posts and the
+ * cached layouts) are built. The accounted total must stay within TOLERANCE of the
+ * measured heap. The soft limit warning is checked too.
+ * Build: g++ -O2 bench/memory.cpp -o bench_memory -lsqlite3
+ *
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include "../src/SocialMedia/socialmedia.cpp"
+
+static size_t live_bytes = 0, live_blocks = 0;
+static const size_t HEADER = 16;   // Keeps the returned blocks 16 byte aligned
+
+// Replacements kept out of line: inlined, GCC pairs free() with the new expression
+__attribute__((noinline)) void* operator new(size_t n){
+    char *p = static_cast<char*>(std::malloc(n + HEADER));
+    if(!p) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(p) = n;
+    live_bytes += n;
+    live_blocks++;
+    return p + HEADER;
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept{
+    if(!p) return;
+    char *b = static_cast<char*>(p) - HEADER;
+    live_bytes -= *reinterpret_cast<size_t*>(b);
+    live_blocks--;
+    std::free(b);
+}
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { operator delete(p); }
+
+int main(){
+    const double TOLERANCE = 0.25;
+    std::mt19937 rng(9);
+    int bad = 0;
+    std::printf("%10s %10s %12s %12s %8s %10s %10s %8s\n", "usuarios", "ligacoes", "contabil.", "heap real",
+                "erro", "B/usuario", "B/ligacao", "blocos");
+    for(unsigned int users : {1000u, 10000u, 100000u}){
+        size_t base_bytes = live_bytes, base_blocks = live_blocks;
+        {
+            socialmedia::SocialMedia sm;
+            std::vector<std::string> mails;
+            for(unsigned int i = 0; i < users; i++){
+                mails.push_back("user" + std::to_string(i) + "@bench.example.com");
+                sm.insert_node(mails.back(), "Usuario " + std::to_string(i), "01/01/2000", "54999990000", "Passo Fundo");
+            }
+            std::vector<std::pair<std::string, std::string>> pairs;
+            for(unsigned int i = 0; i < 8 * users; i++) pairs.emplace_back(mails[rng() % users], mails[rng() % users]);
+            sm.insert_links(pairs);
+            for(unsigned int i = 0; i < users / 4; i++) sm.publish(mails[rng() % users], "post de teste " + std::to_string(i), 1700000000 + i);
+            sm.strong_components();        // CSR snapshot and reachability index
+            sm.links_between(0);           // Time index
+            size_t own = 0;                // Allocated by this benchmark, not by the application
+            for(const auto &m : mails) own += network::MemoryReport::heap(m);
+            own += mails.capacity() * sizeof(std::string);
+            for(const auto &p : pairs) own += network::MemoryReport::heap(p.first) + network::MemoryReport::heap(p.second);
+            own += pairs.capacity() * sizeof(pairs[0]);
+            network::MemoryReport r = sm.memory_report();
+            double real = live_bytes - base_bytes - own;
+            double error = (r.total() - real) / real;
+            std::printf("%10zu %10zu %12zu %12.0f %+7.1f%% %10.1f %10.1f %8zu\n", r.users, r.links, r.total(), real,
+                        100 * error, (double)r.total() / r.users, r.links ? (double)r.total() / r.links : 0.0,
+                        live_blocks - base_blocks);
+            if(std::fabs(error) > TOLERANCE) bad++;
+            if(users == 100000){
+                std::ostringstream detail;
+                detail << r;
+                std::printf("\n%s\n", detail.str().c_str());
+            }
+        }
+    }
+
+    // Soft limit: 1 MB is crossed by any network above, the warning must be shown once
+    socialmedia::SocialMedia sm;
+    sm.memory_limit(1);
+    std::ostringstream captured;
+    std::streambuf *old = std::cout.rdbuf(captured.rdbuf());
+    for(unsigned int i = 0; i < 20000; i++) sm.insert_node("user" + std::to_string(i) + "@bench.example.com", "Usuario", "01/01/2000", "54999990000", "Cidade");
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for(unsigned int i = 0; i < 20000; i++) pairs.emplace_back("user" + std::to_string(i) + "@bench.example.com", "user0@bench.example.com");
+    sm.insert_links(pairs);
+    std::cout.rdbuf(old);
+    bool warned = captured.str().find("Aviso") != std::string::npos;
+    std::printf("Aviso do limite de memória (1 MB): %s\n", warned ? "exibido" : "NÃO exibido");
+    if(!warned) bad++;
+    return bad ? 1 : 0;
+}
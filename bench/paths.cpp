@@ -0,0 +1,105 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file paths.cpp (benchmark)
+ *
+ * Batch path queries ("caminho" lines of menu option 24, PATH_MANY in the traces):
+ * shortest_paths() must give the same distance as distance() for every query, with the
+ * plain and the compressed layout, and the returned paths must be made of existing links.
+ * The recorded trace of run_batch() must replay with the same result. Then the time of
+ * the batch against one query at a time is measured.
+ * Build: g++ -O2 bench/paths.cpp -o bench_paths -lsqlite3
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/SocialMedia/socialmedia.cpp"
+
+int main(){
+    const unsigned int USERS = 20000, LINKS = 80000, QUERIES = 4000;
+    const std::string ops = "/tmp/bench_paths.txt", trace_path = "/tmp/bench_paths.trace";
+    std::mt19937 rng(7);
+    auto mail = [](unsigned int i){ return "user" + std::to_string(i) + "@bench.example.com"; };
+    socialmedia::SocialMedia sm;
+    for(unsigned int i = 0; i < USERS; i++) sm.insert_node(mail(i), "Usuario", "01/01/2000", "54999990000", "Cidade");
+    std::vector<std::pair<std::string, std::string>> links;
+    for(unsigned int i = 0; i < LINKS; i++) links.emplace_back(mail(rng() % USERS), mail(rng() % USERS));
+    sm.insert_links(links);
+
+    std::vector<std::pair<std::string, std::string>> queries;
+    for(unsigned int i = 0; i < QUERIES; i++){
+        unsigned int src = rng() % 64;   // Few sources: queries share their searches
+        queries.emplace_back(mail(src), i % 50 ? mail(rng() % (USERS + 20)) : mail(src));   // Some don't exist
+    }
+
+    int bad = 0;
+    std::vector<int> expected;
+    auto start = std::chrono::steady_clock::now();
+    for(const auto &q : queries) expected.push_back(sm.distance(q.first, q.second));
+    double single = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for(bool packed : {false, true}){
+        sm.compressed_layout(packed);
+        start = std::chrono::steady_clock::now();
+        auto found = sm.shortest_paths(queries);
+        double batched = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        auto traced = sm.shortest_paths(queries, true);
+        unsigned int wrong = 0, reachable = 0;
+        for(size_t i = 0; i < queries.size(); i++){
+            const auto &p = traced[i].path;
+            bool ok = found[i].distance == expected[i] && traced[i].distance == expected[i];
+            if(ok && expected[i] >= 0){
+                reachable++;
+                ok = p.size() == (size_t)expected[i] + 1 && p.front() == queries[i].first && p.back() == queries[i].second;
+                for(size_t k = 0; ok && k + 1 < p.size(); k++) ok = sm.link(p[k], p[k + 1]) != nullptr;
+            }
+            wrong += !ok;
+        }
+        std::printf("%s: %u consultas (%u com caminho), %u divergentes; uma a uma %.1f ms, em lote %.1f ms (%.1fx)\n",
+                    packed ? "Topologia compactada" : "Topologia contígua", QUERIES, reachable, wrong,
+                    single, batched, single / batched);
+        bad += wrong > 0;
+    }
+    sm.compressed_layout(false);
+
+    // Menu option 24 with "caminho" lines, recorded and replayed
+    {
+        std::ofstream out(ops);
+        for(const auto &q : queries) out << "caminho " << q.first << " " << q.second << "\n";
+    }
+    std::remove(trace_path.c_str());
+    storage::MemoryStorage db;
+    std::ostringstream shown;
+    {
+        socialmedia::SocialMedia recorded;   // The trace is flushed when it is destroyed
+        for(unsigned int i = 0; i < USERS; i++) recorded.insert_node(mail(i), "Usuario", "01/01/2000", "54999990000", "Cidade");
+        recorded.insert_links(links);
+        recorded.record_trace(trace_path);
+        std::streambuf *old = std::cout.rdbuf(shown.rdbuf());
+        recorded.run_batch(ops, db);
+        std::cout.rdbuf(old);
+    }
+    size_t distances = 0, none = 0;
+    std::istringstream lines(shown.str());
+    for(std::string line; std::getline(lines, line);){
+        distances += line.rfind("Distância de ", 0) == 0;
+        none += line.rfind("Não há caminho", 0) == 0;
+    }
+    size_t reachable = std::count_if(expected.begin(), expected.end(), [](int d){ return d >= 0; });
+    std::vector<trace::record_t> records;
+    trace::load(trace_path, records);
+    bool replayed = records.size() == 1 && records[0].op == trace::PATH_MANY && records[0].args.size() == 2 * QUERIES
+                    && sm.execute(records[0], db) == (reachable == QUERIES);
+    std::printf("Opção 24: %zu distâncias e %zu sem caminho exibidas (esperado %zu e %zu); trace %s\n", distances, none,
+                reachable, QUERIES - reachable, replayed ? "reproduzido" : "DIVERGENTE");
+    bad += distances != reachable || none != QUERIES - reachable || !replayed;
+    std::remove(ops.c_str());
+    std::remove(trace_path.c_str());
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file policies.cpp (benchmark)
+ *
+ * User table and adjacency list policies (GRAPHSOCIAL_ORDERED_INDEX and
+ * GRAPHSOCIAL_SORTED_LINKS): the same workload (users, follows, unfollows, lookups,
+ * distances and removals) runs on the four BasicNetwork combinations. The resulting
+ * graphs and distances must match; the time of every phase is shown.
+ * Build: g++ -O2 bench/policies.cpp -o bench_policies -lsqlite3
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/SocialMedia/socialmedia.cpp"
+
+struct result_t{
+    std::string graph;          // Users and links, sorted
+    std::vector<int> distances;
+    double ms[5] = {0, 0, 0, 0, 0};
+};
+
+template<class Index, class Adjacency>
+static result_t run(const char *label){
+    const unsigned int USERS = 20000, FOLLOWS = 200000, QUERIES = 2000;
+    using G = network::BasicNetwork<Index, Adjacency>;
+    std::mt19937 rng(5);
+    auto mail = [](unsigned int i){ return "user" + std::to_string(i) + "@bench.example.com"; };
+    auto pick = [&](){ unsigned int r = rng() % 100; return r < 20 ? rng() % 50 : rng() % USERS; };   // A few popular users
+    result_t out;
+    G g;
+    auto clock = std::chrono::steady_clock::now();
+    auto lap = [&](int phase){
+        auto now = std::chrono::steady_clock::now();
+        out.ms[phase] = std::chrono::duration<double, std::milli>(now - clock).count();
+        clock = now;
+    };
+    for(unsigned int i = 0; i < USERS; i++) g.insert_node(mail(i), "Usuario", "01/01/2000", "54999990000", "Cidade");
+    lap(0);
+    for(unsigned int i = 0; i < FOLLOWS; i++) g.add_link(mail(pick()), mail(pick()));
+    lap(1);
+    for(unsigned int i = 0; i < FOLLOWS / 4; i++) g.remove_link(mail(pick()), mail(pick()));
+    size_t found = 0;
+    for(unsigned int i = 0; i < FOLLOWS; i++) found += g.find(mail(rng() % (USERS + 100))) != nullptr;
+    lap(2);
+    for(unsigned int i = 0; i < QUERIES; i++) out.distances.push_back(g.distance(mail(rng() % USERS), mail(rng() % USERS)));
+    lap(3);
+    for(unsigned int i = 0; i < USERS / 20; i++) g.remove_node(mail(rng() % USERS));
+    lap(4);
+    std::vector<std::string> rows;
+    g.visit([&](const std::string &m, auto&&...){ rows.push_back(m); },
+            [&](const std::string &s, const std::string &d, const auto&){ rows.push_back(s + ">" + d); });
+    std::sort(rows.begin(), rows.end());
+    for(const auto &r : rows) out.graph += r + "\n";
+    std::printf("%-26s %10.1f %10.1f %10.1f %10.1f %10.1f %8zu\n", label, out.ms[0], out.ms[1], out.ms[2], out.ms[3],
+                out.ms[4], found);
+    return out;
+}
+
+int main(){
+    std::printf("%-26s %10s %10s %10s %10s %10s %8s\n", "politicas", "cadastro", "seguir", "deixar+busca",
+                "distância", "exclusão", "achados");
+    result_t r[] = {run<network::HashIndex, network::VectorAdjacency>("hash + vetor"),
+                    run<network::HashIndex, network::SortedAdjacency>("hash + ordenada"),
+                    run<network::OrderedIndex, network::VectorAdjacency>("ordenado + vetor"),
+                    run<network::OrderedIndex, network::SortedAdjacency>("ordenado + ordenada")};
+    int bad = 0;
+    for(const auto &x : r) bad += x.graph != r[0].graph || x.distances != r[0].distances;
+    std::printf("Resultados %s\n", bad ? "DIFERENTES entre as políticas!" : "iguais nas quatro combinações");
+    return bad ? 1 : 0;
+}
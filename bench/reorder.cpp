@@ -0,0 +1,182 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file reorder.cpp (benchmark)
+ *
+ * Vertex orderings of the contiguous layout (menu option 16) on a graph of small
+ * communities: for every order the time of distance queries (the search of
+ * shortest_path() without the output) and of the diameter is measured, with the cache
+ * misses read from the hardware counters when the kernel allows it, otherwise counted
+ * by a simulated cache (32 KB, 8 ways, 64 byte lines, LRU) over the arrays the
+ * searches read. Every order must give the same distances and diameter, and RCM and
+ * Gorder must miss less than the original (hash table) order.
+ * Build: g++ -O2 bench/reorder.cpp -o bench_reorder -lsqlite3
+ *
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "../src/SocialMedia/socialmedia.cpp"
+
+/// @brief Exposes the cached CSR layout and the diameter search (protected in the network)
+struct Probe : socialmedia::SocialMedia{
+    using socialmedia::SocialMedia::layout;
+    using socialmedia::SocialMedia::graph_diameter;
+};
+
+/// @brief Hardware cache miss counter of this thread (fd < 0: not available)
+struct Counter{
+    int fd = -1;
+    Counter(){
+        perf_event_attr a;
+        std::memset(&a, 0, sizeof(a));
+        a.size = sizeof(a);
+        a.type = PERF_TYPE_HARDWARE;
+        a.config = PERF_COUNT_HW_CACHE_MISSES;
+        a.disabled = 1;
+        a.exclude_kernel = 1;
+        a.exclude_hv = 1;
+        fd = syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+    }
+    ~Counter() { if(fd >= 0) close(fd); }
+    void start() { if(fd >= 0){ ioctl(fd, PERF_EVENT_IOC_RESET, 0); ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); } }
+    uint64_t stop(){
+        uint64_t v = 0;
+        if(fd >= 0 && (ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) != 0 || read(fd, &v, sizeof(v)) != sizeof(v))) v = 0;
+        return v;
+    }
+};
+
+/// @brief Set associative LRU cache fed with the addresses a search reads
+struct Cache{
+    static constexpr unsigned int SETS = 64, WAYS = 8, LINE = 64;   // 32 KB
+    std::vector<uintptr_t> tags = std::vector<uintptr_t>(SETS * WAYS, 0);
+    uint64_t misses = 0;
+    void touch(const void *p){
+        uintptr_t line = reinterpret_cast<uintptr_t>(p) / LINE + 1;
+        uintptr_t *set = &tags[(line % SETS) * WAYS];
+        unsigned int w = 0;
+        while(w < WAYS && set[w] != line) w++;
+        if(w == WAYS){
+            misses++;
+            w = WAYS - 1;
+        }
+        for(; w > 0; w--) set[w] = set[w - 1];   // Most recent first
+        set[0] = line;
+    }
+};
+
+/// @brief Breadth-first search over the CSR reading the same arrays the network does (stop at dest, -1: full)
+static unsigned int bfs(const network::CSR &g, unsigned int s, int dest, std::vector<unsigned int> &dist,
+                        std::vector<unsigned int> &queue, Cache &cache)
+{
+    const unsigned int NONE = -1;
+    queue.assign(1, s);
+    dist[s] = 0;
+    cache.touch(&dist[s]);
+    unsigned int found = NONE;
+    for(size_t head = 0; head < queue.size() && found == NONE; head++){
+        unsigned int u = queue[head];
+        cache.touch(&queue[head]);
+        cache.touch(&g.out_offsets[u]);
+        cache.touch(&g.out_offsets[u + 1]);
+        for(unsigned int e = g.out_offsets[u]; e < g.out_offsets[u + 1]; e++){
+            unsigned int w = g.out_edges[e];
+            cache.touch(&g.out_edges[e]);
+            cache.touch(&dist[w]);
+            if(dist[w] != NONE) continue;
+            dist[w] = dist[u] + 1;
+            queue.push_back(w);
+            if((int)w == dest) found = dist[w];
+        }
+    }
+    unsigned int ecc = dest < 0 ? dist[queue.back()] : found;
+    for(unsigned int v : queue) dist[v] = NONE;
+    return ecc;
+}
+
+int main(){
+    const unsigned int USERS = 12000, COMMUNITY = 40, DEGREE = 7, QUERIES = 3000, SEARCHES = 400;
+    std::mt19937 rng(11);
+    auto mail = [](unsigned int i){ return "user" + std::to_string(i) + "@bench.example.com"; };
+    Probe sm;
+    for(unsigned int i = 0; i < USERS; i++) sm.insert_node(mail(i), "Usuario", "01/01/2000", "54999990000", "Cidade");
+    std::vector<std::pair<std::string, std::string>> links;
+    for(unsigned int u = 0; u < USERS; u++){
+        unsigned int base = u - u % COMMUNITY;
+        for(unsigned int k = 0; k < DEGREE; k++){
+            unsigned int v = rng() % 10 ? base + rng() % COMMUNITY : rng() % USERS;   // 90% inside the community
+            links.emplace_back(mail(u), mail(std::min(v, USERS - 1)));
+        }
+    }
+    sm.insert_links(links);
+    std::vector<std::pair<std::string, std::string>> queries;
+    for(unsigned int i = 0; i < QUERIES; i++) queries.emplace_back(mail(rng() % USERS), mail(rng() % USERS));
+
+    Counter counter;
+    std::printf("Faltas de cache: %s\n\n", counter.fd >= 0 ? "contadores de hardware" : "contadores de hardware indisponíveis, cache simulado de 32 KB");
+    std::printf("%-8s %10s %12s %14s %12s %14s %9s\n", "ordem", "ordenar ms", "caminhos ms", "faltas/caminho",
+                "diâmetro ms", "faltas/busca", "diâmetro");
+    int bad = 0;
+    std::vector<int> reference;
+    int reference_diameter = -1;
+    double none_misses = 0;
+    for(auto m : {network::VertexOrder::NONE, network::VertexOrder::DEGREE, network::VertexOrder::RCM, network::VertexOrder::GORDER}){
+        sm.vertex_order(m);
+        auto start = std::chrono::steady_clock::now();
+        const network::CSR &g = sm.layout();
+        double build = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<int> found;
+        found.reserve(QUERIES);
+        counter.start();
+        start = std::chrono::steady_clock::now();
+        for(const auto &q : queries) found.push_back(sm.distance(q.first, q.second));
+        double paths = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        double path_misses = (double)counter.stop() / QUERIES;
+
+        counter.start();
+        start = std::chrono::steady_clock::now();
+        int diameter = Probe::graph_diameter(g);   // diameter_job() would reuse the result of the first order
+        double diam = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        double search_misses = (double)counter.stop() / USERS;
+
+        if(counter.fd < 0){   // Simulated: the same queries and a sample of the diameter searches
+            std::vector<unsigned int> dist(g.size(), -1), queue;
+            Cache cache;
+            for(const auto &q : queries){
+                int s = g.find(q.first), t = g.find(q.second);
+                if(s != t) bfs(g, s, t, dist, queue, cache);
+            }
+            path_misses = (double)cache.misses / QUERIES;
+            cache.misses = 0;
+            for(unsigned int i = 0; i < SEARCHES; i++) bfs(g, g.find(mail(i * (USERS / SEARCHES))), -1, dist, queue, cache);
+            search_misses = (double)cache.misses / SEARCHES;
+        }
+        std::printf("%-8s %10.1f %12.1f %14.0f %12.1f %14.0f %9d\n", network::VertexOrder::name(m).c_str(), build, paths,
+                    path_misses, diam, search_misses, diameter);
+
+        if(m == network::VertexOrder::NONE){
+            reference = found;
+            reference_diameter = diameter;
+            none_misses = path_misses + search_misses;
+        }
+        else if(found != reference || diameter != reference_diameter){
+            std::printf("  distâncias ou diâmetro diferentes da ordem original!\n");
+            bad++;
+        }
+        if((m == network::VertexOrder::RCM || m == network::VertexOrder::GORDER) && path_misses + search_misses >= none_misses){
+            std::printf("  sem redução de faltas de cache!\n");
+            bad++;
+        }
+    }
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file timeline.cpp (benchmark)
+ *
+ * Home timeline reads (menu option 14) on a network with regular accounts (posts pushed
+ * to the followers) and celebrities (posts pulled on read). Every timeline is checked
+ * against a brute force merge of the followed authors' posts, also after unfollows,
+ * then the read latency percentiles are measured.
+ * Build: g++ -O2 bench/timeline.cpp -o bench_timeline -lsqlite3
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/SocialMedia/socialmedia.cpp"
+
+static std::string mail(unsigned int i) { return "user" + std::to_string(i) + "@bench"; }
+
+int main(){
+    const unsigned int USERS = 5000, CELEBRITIES = 5, FOLLOWING = 40, POSTS = 4, LIMIT = 20, READS = 50000;
+    const unsigned int CELEBRITY_FANS = timeline::Timeline::CELEBRITY_FOLLOWERS + 500;
+    std::mt19937 rng(1);
+    socialmedia::SocialMedia sm;
+    for(unsigned int i = 0; i < USERS; i++) sm.insert_node(mail(i), "Usuario", "01/01/2000", "000", "Cidade");
+    for(unsigned int c = 0; c < CELEBRITIES; c++)
+        for(unsigned int k = 0; k < CELEBRITY_FANS; k++) sm.follow(mail(CELEBRITIES + rng() % (USERS - CELEBRITIES)), mail(c));
+    for(unsigned int i = 0; i < USERS; i++)
+        for(unsigned int k = 0; k < FOLLOWING; k++) sm.follow(mail(i), mail(CELEBRITIES + rng() % (USERS - CELEBRITIES)));
+    long long time = 1700000000;
+    for(unsigned int p = 0; p < POSTS; p++)
+        for(unsigned int i = 0; i < USERS; i++) sm.publish(mail(i), "post " + std::to_string(p), time++);
+    for(unsigned int i = 0; i < USERS; i += 7) sm.unfollow(mail(i), sm.find(mail(i))->links.front()->user.email);
+
+    // Brute force: own posts and posts of the followed users, newest first
+    auto expected = [&](const std::string &user){
+        std::vector<const timeline::Timeline::post*> ans;
+        auto *u = sm.find(user);
+        for(const auto *p : sm.get_timelines().all()){
+            bool follows = p->author == user;
+            for(auto l : u->links) follows = follows || l->user.email == p->author;
+            if(follows) ans.push_back(p);
+        }
+        std::reverse(ans.begin(), ans.end());
+        if(ans.size() > LIMIT) ans.resize(LIMIT);
+        return ans;
+    };
+    unsigned int bad = 0;
+    for(unsigned int i = 0; i < USERS; i += 13)
+        if(sm.home_timeline(mail(i), LIMIT) != expected(mail(i))) bad++;
+
+    std::vector<double> lat;
+    lat.reserve(READS);
+    size_t shown = 0;
+    for(unsigned int r = 0; r < READS; r++){
+        std::string user = mail(rng() % USERS);
+        auto start = std::chrono::steady_clock::now();
+        shown += sm.home_timeline(user, LIMIT).size();
+        lat.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(lat.begin(), lat.end());
+    auto pct = [&](double q){ return lat[std::min(lat.size() - 1, (size_t)(q * lat.size()))]; };
+    std::printf("home_timeline(limit %u): %u reads, %.1f posts/read, p50 %.2f us, p90 %.2f us, p99 %.2f us, max %.2f us\n",
+                LIMIT, READS, (double)shown / READS, pct(0.5), pct(0.9), pct(0.99), lat.back());
+    std::printf("Timelines checked: %s (%u differ)\n", bad ? "FALHOU" : "ok", bad);
+    return bad ? 1 : 0;
+}
@@ -1,8 +1,100 @@
 #include "src/SocialMedia/socialmedia.cpp"
+#include "src/Shard/shard.cpp"
+#include "src/Database/paged.cpp"
+#include "src/Trace/replay.cpp"
+#include <cstdlib>
+#include <cstring>
 using namespace socialmedia;
 
-int main(){
+int main(int argc, char *argv[]){
+    if(argc == 3 && std::strcmp(argv[1], "--shards") == 0){ // Partitioned mode (line commands), 1 to MAX_SHARDS
+        const char *n = argv[2];
+        size_t len = std::strlen(n);
+        bool digits = len > 0 && len <= 2 && std::strspn(n, "0123456789") == len;
+        unsigned int shards = digits ? std::atoi(n) : 0;
+        if(shards < 1 || shards > shard::Coordinator::MAX_SHARDS){
+            std::cout << "Número de shards inválido: " << n << std::endl;
+            std::cout << "Uso: --shards 1-" << shard::Coordinator::MAX_SHARDS << std::endl;
+            return 1;
+        }
+        shard::Coordinator coordinator(shards);
+        if(!coordinator.shards()) return 1;
+        coordinator.console(std::cin, std::cout);
+        return 0;
+    }
+    if(argc == 3 && std::strcmp(argv[1], "--lazy") == 0){ // Out-of-core mode (line commands), budget in MB
+        const char *n = argv[2];
+        size_t len = std::strlen(n);
+        bool digits = len > 0 && len <= 7 && std::strspn(n, "0123456789") == len;
+        size_t mb = digits ? std::atol(n) : 0;
+        if(mb < 1 || mb > database::PagedGraph::MAX_BUDGET_MB){
+            std::cout << "Tamanho do cache inválido: " << n << std::endl;
+            std::cout << "Uso: --lazy 1-" << database::PagedGraph::MAX_BUDGET_MB << " (MB)" << std::endl;
+            return 1;
+        }
+        database::PagedGraph graph("src/Database/graphsocial.db", mb << 20);
+        graph.console(std::cin, std::cout);
+        return 0;
+    }
+    if(argc >= 3 && std::strcmp(argv[1], "--replay") == 0){ // Replay a recorded trace
+        std::vector<trace::record_t> records;
+        if(!trace::load(argv[2], records)){
+            std::cout << "Trace inválido: " << argv[2] << std::endl;
+            return 1;
+        }
+        std::string backend = "sqlite";
+        trace::Replayer::speed_t speed = trace::Replayer::MAXIMUM;
+        unsigned int replayers = 1;
+        for(int i = 3; i + 1 < argc; i += 2){
+            if(std::strcmp(argv[i], "--storage") == 0) // sqlite | log | memory (scratch files)
+                backend = argv[i + 1];
+            else if(std::strcmp(argv[i], "--speed") == 0) // original | max
+                speed = std::strcmp(argv[i + 1], "original") == 0 ? trace::Replayer::ORIGINAL : trace::Replayer::MAXIMUM;
+            else if(std::strcmp(argv[i], "--replayers") == 0){ // Concurrent replayers (1 to MAX_REPLAYERS)
+                const char *n = argv[i + 1];
+                size_t len = std::strlen(n);
+                bool digits = len > 0 && len <= 3 && std::strspn(n, "0123456789") == len;
+                replayers = digits ? std::atoi(n) : 0;
+                if(replayers < 1 || replayers > trace::Replayer::MAX_REPLAYERS){
+                    std::cout << "Número de reprodutores inválido: " << n << std::endl;
+                    std::cout << "Uso: --replay <trace> [--storage sqlite|log|memory] [--speed original|max] [--replayers 1-"
+                              << trace::Replayer::MAX_REPLAYERS << "]" << std::endl;
+                    return 1;
+                }
+            }
+        }
+        if(backend != "sqlite" && backend != "log" && backend != "memory"){
+            std::cout << "Armazenamento inválido: " << backend << std::endl;
+            return 1;
+        }
+        trace::Replayer replayer(records, backend);
+        std::cout << replayer.run(speed, replayers) << std::endl;
+        return 0;
+    }
+    std::string backend = "sqlite";
     SocialMedia teste;
-    teste.init(teste);    
+    for(int i = 1; i < argc; i += 2){
+        if(i + 1 == argc){ // Option without a value
+            std::cout << "Valor ausente para: " << argv[i] << std::endl;
+            return 1;
+        }
+        if(std::strcmp(argv[i], "--storage") == 0) // sqlite | log | memory
+            backend = argv[i + 1];
+        else if(std::strcmp(argv[i], "--memory-limit") == 0){ // Soft limit in MB (warning only), 1 to MAX_MEMORY_LIMIT_MB
+            const char *n = argv[i + 1];
+            size_t len = std::strlen(n);
+            bool digits = len > 0 && len <= 7 && std::strspn(n, "0123456789") == len;
+            size_t mb = digits ? std::atol(n) : 0;
+            if(mb < 1 || mb > SocialMedia::MAX_MEMORY_LIMIT_MB){
+                std::cout << "Limite de memória inválido: " << n << std::endl;
+                std::cout << "Uso: --memory-limit 1-" << SocialMedia::MAX_MEMORY_LIMIT_MB << " (MB)" << std::endl;
+                return 1;
+            }
+            teste.memory_limit(mb);
+        }
+        else if(std::strcmp(argv[i], "--record") == 0 && !teste.record_trace(argv[i + 1])) // Trace file
+            std::cout << "Não foi possível criar o trace: " << argv[i + 1] << std::endl;
+    }
+    teste.init(teste, backend);    
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file betweenness.cpp (.cpp file) (implementation file)
+ *
+ * Betweenness class members/member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include "betweenness.h"
+#include "../Network/parallel.h"
+
+namespace analytics{
+
+    /// @brief Class constructor, binds the graph snapshot
+    /// @param g --> const network::CSR: Graph snapshot (must outlive the object)
+    analytics::Betweenness::Betweenness(const network::CSR &g) : g(g), bc(g.size(), 0.0){}
+
+    /// @brief The exact scores are cheap enough for the stats report
+    bool analytics::Betweenness::exact_feasible() const{
+        return (unsigned long)g.size() * (g.size() + g.edges()) <= EXACT_WORK_LIMIT;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Betweenness
+     * @name run()
+     * @brief Exact betweenness: dependencies accumulated from every user. The sources are
+     *        visited in a random order, so a run stopped by its job (cancelled or out of time)
+     *        still leaves an unbiased estimate from the sources done so far.
+     * @param control --> jobs::Control*: Progress/cancellation of the job (nullptr: none)
+    */
+    void analytics::Betweenness::run(jobs::Control *control){
+        std::vector<unsigned int> order(g.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+        confidence = 0.95;
+        accumulate(order, control);
+    }
+
+    /**
+     * @namespace analytics
+     * @class Betweenness
+     * @name sample()
+     * @brief Approximate betweenness: dependencies of a uniform sample of sources (without
+     *        replacement), scaled by users / samples. With the Hoeffding bound and a union
+     *        bound over the users, every score is within margin() of the exact one with the
+     *        given confidence.
+     * @param samples --> unsigned long: Number of sources (all users: exact)
+     * @param confidence --> double: Confidence level of the interval (0, 1)
+     * @param seed --> unsigned long: Random seed (results are reproducible)
+     * @param control --> jobs::Control*: Progress/cancellation of the job (nullptr: none)
+    */
+    void analytics::Betweenness::sample(unsigned long samples, double confidence, unsigned long seed,
+                                        jobs::Control *control)
+    {
+        unsigned int n = g.size();
+        std::vector<unsigned int> order(n);
+        std::iota(order.begin(), order.end(), 0u);
+        std::mt19937_64 rng(seed);
+        samples = std::min<unsigned long>(samples, n);
+        for(unsigned long i = 0; i < samples; i++){
+            std::uniform_int_distribution<unsigned int> pick(i, n - 1);
+            std::swap(order[i], order[pick(rng)]);
+        }
+        order.resize(samples);
+        this->confidence = confidence;
+        accumulate(order, control);
+    }
+
+    /**
+     * @namespace analytics
+     * @class Betweenness
+     * @name accumulate()
+     * @brief Brandes algorithm from the given sources, in parallel: every thread runs the
+     *        breadth-first searches of its sources with its own distance, path count and
+     *        dependency buffers and adds the dependencies to its own scores, which are
+     *        summed at the end (no shared writes). The predecessors of a user are found
+     *        again in the followers list instead of being stored.
+     * @param order --> const std::vector<unsigned int>: Sources, in processing order
+     * @param control --> jobs::Control*: Progress/cancellation of the job (nullptr: none)
+    */
+    void analytics::Betweenness::accumulate(const std::vector<unsigned int> &order, jobs::Control *control){
+        unsigned int n = g.size();
+        const unsigned int NONE = -1;
+        struct buffers_t{
+            std::vector<unsigned int> dist;
+            std::vector<double> sigma;    // Number of shortest paths from the source
+            std::vector<double> delta;    // Dependency of the source on the user
+            std::vector<unsigned int> queue;
+            std::vector<double> score;
+        };
+        std::vector<buffers_t> local(network::workers());
+        std::atomic<unsigned long> done(0);
+        if(control) control->total(order.size());
+        network::parallel_for(order.size(), [&](size_t i, unsigned int tid){
+            if(control && control->stopped()) return;
+            buffers_t &b = local[tid];
+            if(b.score.empty()){
+                b.dist.assign(n, NONE);
+                b.sigma.assign(n, 0);
+                b.delta.assign(n, 0);
+                b.score.assign(n, 0);
+                b.queue.reserve(n);
+            }
+            unsigned int s = order[i];
+            b.queue.assign(1, s);
+            b.dist[s] = 0;
+            b.sigma[s] = 1;
+            for(size_t head = 0; head < b.queue.size(); head++){
+                unsigned int u = b.queue[head];
+                for(auto p = g.out_begin(u); p != g.out_end(u); ++p){
+                    if(b.dist[*p] == NONE){
+                        b.dist[*p] = b.dist[u] + 1;
+                        b.queue.push_back(*p);
+                    }
+                    if(b.dist[*p] == b.dist[u] + 1) b.sigma[*p] += b.sigma[u];
+                }
+            }
+            for(size_t j = b.queue.size(); j-- > 1;){
+                unsigned int w = b.queue[j];
+                double share = (1.0 + b.delta[w]) / b.sigma[w];
+                for(auto p = g.in_begin(w); p != g.in_end(w); ++p){
+                    if(b.dist[*p] + 1 == b.dist[w]) b.delta[*p] += b.sigma[*p] * share;
+                }
+                b.score[w] += b.delta[w];
+            }
+            for(unsigned int v : b.queue){
+                b.dist[v] = NONE;
+                b.sigma[v] = 0;
+                b.delta[v] = 0;
+            }
+            done.fetch_add(1);
+            if(control) control->advance();
+        }, 1);
+        sources = done.load();
+        double scale = sources ? (double)n / sources : 0;
+        network::parallel_for(n, [&](size_t v, unsigned int){
+            double sum = 0;
+            for(const auto &b : local) if(!b.score.empty()) sum += b.score[v];
+            bc[v] = sum * scale;
+        }, 4096);
+        double pairs = (double)n * (n ? n - 1 : 0);
+        if(sources == n) error = 0;
+        else if(!sources) error = pairs;
+        else error = pairs * std::sqrt(std::log(2.0 * n / (1.0 - confidence)) / (2.0 * sources));
+    }
+
+    /**
+     * @namespace analytics
+     * @class Betweenness
+     * @name top()
+     * @brief Get the k most central vertices (the bridges)
+     * @param k --> size_t: Number of vertices
+     * @return std::vector<std::pair> --> (vertex id, score) sorted by score (descending)
+    */
+    std::vector<std::pair<unsigned int, double>> analytics::Betweenness::top(size_t k) const{
+        std::vector<std::pair<unsigned int, double>> ans;
+        ans.reserve(bc.size());
+        for(unsigned int v = 0; v < bc.size(); v++) ans.emplace_back(v, bc[v]);
+        k = std::min(k, ans.size());
+        std::partial_sort(ans.begin(), ans.begin() + k, ans.end(), [](const auto &a, const auto &b){
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        });
+        ans.resize(k);
+        return ans;
+    }
+
+} // namespace analytics
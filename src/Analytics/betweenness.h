@@ -0,0 +1,53 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile betweenness.h (header file)
+ *
+ * Betweenness class interface/structure
+ * Betweenness centrality (Brandes) over a CSR snapshot of the network graph: the number
+ * of shortest follow paths between other users that go through a user. High scores mark
+ * the bridge accounts between communities. Exact (a BFS from every user) or estimated
+ * from a uniform sample of sources, with a Hoeffding error bound.
+ * Include guard
+ *
+*/
+
+#ifndef BETWEENNESS_H
+#define BETWEENNESS_H
+
+#include <utility>
+#include <vector>
+#include "../Network/csr.h"
+#include "../Jobs/jobs.h"
+
+namespace analytics{
+
+class Betweenness{
+public:
+    // Above this amount of work (sources x (users + links)) the stats report samples sources
+    static constexpr unsigned long EXACT_WORK_LIMIT = 2000000000ul;
+    static constexpr unsigned long DEFAULT_SAMPLES = 1000ul;
+
+    Betweenness(const network::CSR &g);
+    void run(jobs::Control *control = nullptr);
+    void sample(unsigned long samples = DEFAULT_SAMPLES, double confidence = 0.95,
+                unsigned long seed = 42, jobs::Control *control = nullptr);
+    bool exact_feasible() const;
+    bool exact() const { return sources == g.size(); } // Inline
+    unsigned long sampled() const { return sources; } // Inline
+    double margin() const { return error; } // Inline
+    const std::vector<double>& scores() const { return bc; } // Inline
+    std::vector<std::pair<unsigned int, double>> top(size_t k) const;
+
+private:
+    const network::CSR &g;
+    std::vector<double> bc;
+    unsigned long sources = 0;   // Sources whose dependencies were accumulated
+    double error = 0;            // Half width of the confidence interval (0 if exact)
+    double confidence = 0.95;
+
+    void accumulate(const std::vector<unsigned int> &order, jobs::Control *control);
+};
+
+} // namespace analytics
+
+#endif // BETWEENNESS_H
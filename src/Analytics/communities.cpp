@@ -0,0 +1,337 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file communities.cpp (.cpp file) (implementation file)
+ *
+ * Communities class members/member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include "communities.h"
+#include "../Network/parallel.h"
+
+namespace analytics{
+
+    /// @brief Class constructor, builds the undirected view of the snapshot (unit weights,
+    ///        a mutual follow is a single edge, no self loops)
+    /// @param g --> const network::CSR: Graph snapshot
+    analytics::Communities::Communities(const network::CSR &g){
+        unsigned int n = g.size();
+        base.offsets.assign(n + 1, 0);
+        auto merge = [&](unsigned int v, auto emit){
+            const unsigned int *a = g.out_begin(v), *aend = g.out_end(v);
+            const unsigned int *b = g.in_begin(v), *bend = g.in_end(v);
+            unsigned int last = -1;
+            while(a != aend || b != bend){
+                unsigned int x = (b == bend || (a != aend && *a < *b)) ? *a++ : *b++;
+                if(x != v && x != last) emit(x);
+                last = x;
+            }
+        };
+        network::parallel_for(n, [&](size_t v, unsigned int){
+            unsigned int count = 0;
+            merge(v, [&](unsigned int){ count++; });
+            base.offsets[v + 1] = count;
+        });
+        for(unsigned int v = 0; v < n; v++) base.offsets[v + 1] += base.offsets[v];
+        base.adj.resize(base.offsets[n]);
+        base.weight.assign(base.offsets[n], 1.0);
+        base.degree.resize(n);
+        network::parallel_for(n, [&](size_t v, unsigned int){
+            unsigned int pos = base.offsets[v];
+            merge(v, [&](unsigned int x){ base.adj[pos++] = x; });
+            base.degree[v] = base.offsets[v + 1] - base.offsets[v];
+        });
+        base.total = base.adj.size();
+        membership.resize(n);
+        std::iota(membership.begin(), membership.end(), 0u);
+        ncommunities = n;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Communities
+     * @name label_propagation()
+     * @brief Asynchronous label propagation in parallel: every user takes the most frequent
+     *        label among its neighbours (ties: keep the current one, else a random one), and
+     *        the new label is seen right away by the other threads. Users are visited in a
+     *        new random order every round; it stops when almost no label changes.
+     * @param max_iter --> unsigned int: Maximum number of rounds
+     * @param seed --> unsigned long: Random seed of the visiting order and tie breaks
+     * @return unsigned int --> Rounds done
+    */
+    unsigned int analytics::Communities::label_propagation(unsigned int max_iter, unsigned long seed){
+        unsigned int n = base.size();
+        std::vector<std::atomic<unsigned int>> label(n);
+        for(unsigned int v = 0; v < n; v++) label[v].store(v, std::memory_order_relaxed);
+        struct buffers_t{
+            std::vector<unsigned int> count;
+            std::vector<unsigned int> seen;
+            std::vector<unsigned int> best;
+        };
+        std::vector<buffers_t> local(network::workers());
+        std::vector<unsigned int> order(n);
+        std::iota(order.begin(), order.end(), 0u);
+        std::mt19937_64 rng(seed);
+        unsigned int iter = 0;
+        while(iter < max_iter){
+            iter++;
+            std::shuffle(order.begin(), order.end(), rng);
+            std::atomic<unsigned int> changed(0);
+            network::parallel_for(n, [&](size_t i, unsigned int tid){
+                buffers_t &b = local[tid];
+                if(b.count.empty()) b.count.assign(n, 0);
+                unsigned int v = order[i];
+                if(base.offsets[v] == base.offsets[v + 1]) return;
+                unsigned int top = 0;
+                for(unsigned int j = base.offsets[v]; j < base.offsets[v + 1]; j++){
+                    unsigned int l = label[base.adj[j]].load(std::memory_order_relaxed);
+                    if(!b.count[l]++) b.seen.push_back(l);
+                    top = std::max(top, b.count[l]);
+                }
+                unsigned int current = label[v].load(std::memory_order_relaxed);
+                unsigned int next = current;
+                if(b.count[current] != top){
+                    for(unsigned int l : b.seen) if(b.count[l] == top) b.best.push_back(l);
+                    uint64_t h = (seed + iter) * 0x9e3779b97f4a7c15ul ^ v * 0xbf58476d1ce4e5b9ul;
+                    next = b.best[(h >> 33) % b.best.size()];
+                    b.best.clear();
+                }
+                for(unsigned int l : b.seen) b.count[l] = 0;
+                b.seen.clear();
+                if(next != current){
+                    label[v].store(next, std::memory_order_relaxed);
+                    changed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }, 256);
+            if((unsigned long)changed.load() * 1000 <= n) break;
+        }
+        for(unsigned int v = 0; v < n; v++) membership[v] = label[v].load(std::memory_order_relaxed);
+        ncommunities = compact(membership);
+        q = modularity(base, membership);
+        return iter;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Communities
+     * @name louvain()
+     * @brief Louvain method: users move to the neighbour community with the largest
+     *        modularity gain until no pass improves it, then every community becomes a
+     *        vertex of a smaller graph and the process repeats on it.
+     * @param max_levels --> unsigned int: Maximum number of aggregation levels
+     * @param tol --> double: Minimum modularity gain of a moving pass
+     * @return unsigned int --> Levels done
+    */
+    unsigned int analytics::Communities::louvain(unsigned int max_levels, double tol){
+        unsigned int n = base.size();
+        std::iota(membership.begin(), membership.end(), 0u);
+        graph_t coarse;
+        const graph_t *h = &base;
+        unsigned int level = 0;
+        while(level < max_levels){
+            std::vector<unsigned int> c(h->size());
+            std::iota(c.begin(), c.end(), 0u);
+            if(!move(*h, c, tol)) break;
+            level++;
+            unsigned int k = compact(c);
+            for(unsigned int v = 0; v < n; v++) membership[v] = c[membership[v]];
+            if(k == h->size()) break;
+            coarse = aggregate(*h, c, k);
+            h = &coarse;
+        }
+        ncommunities = compact(membership);
+        q = modularity(base, membership);
+        return level;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Communities
+     * @name move()
+     * @brief Local moving phase of Louvain, in parallel: every thread takes the users of its
+     *        chunks, finds the neighbour community with the largest modularity gain (per-thread
+     *        weight buffers) and moves the user right away, updating the community totals
+     *        atomically, so the other threads see the move. Two singletons only merge into
+     *        the lower label, so concurrent pairs don't swap; a pass that lowers the
+     *        modularity (conflicting concurrent moves) is undone.
+     * @param h --> const graph_t: Graph of the level
+     * @param c --> std::vector<unsigned int>: Community of every vertex (updated)
+     * @param tol --> double: Minimum modularity gain of a pass
+     * @return bool --> true: The modularity improved
+    */
+    bool analytics::Communities::move(const graph_t &h, std::vector<unsigned int> &c, double tol){
+        unsigned int n = h.size();
+        if(h.total <= 0) return false;
+        std::vector<std::atomic<unsigned int>> comm(n);
+        std::vector<std::atomic<double>> tot(n);
+        std::vector<std::atomic<unsigned int>> size(n);
+        auto load = [&]{
+            for(unsigned int v = 0; v < n; v++){
+                comm[v].store(c[v], std::memory_order_relaxed);
+                tot[v].store(0, std::memory_order_relaxed);
+                size[v].store(0, std::memory_order_relaxed);
+            }
+            for(unsigned int v = 0; v < n; v++){
+                tot[c[v]].store(tot[c[v]].load(std::memory_order_relaxed) + h.degree[v], std::memory_order_relaxed);
+                size[c[v]].fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+        auto add = [](std::atomic<double> &x, double d){
+            double old = x.load(std::memory_order_relaxed);
+            while(!x.compare_exchange_weak(old, old + d, std::memory_order_relaxed));
+        };
+        load();
+        struct buffers_t{
+            std::vector<double> links;     // Weight from the vertex to every community
+            std::vector<unsigned int> seen;
+        };
+        std::vector<buffers_t> local(network::workers());
+        std::vector<unsigned int> prev;
+        double current = modularity(h, c);
+        bool improved = false;
+        for(unsigned int pass = 0; pass < MAX_PASSES; pass++){
+            network::parallel_for(n, [&](size_t v, unsigned int tid){
+                buffers_t &b = local[tid];
+                if(b.links.empty()) b.links.assign(n, 0);
+                unsigned int a = comm[v].load(std::memory_order_relaxed);
+                double kv = h.degree[v];
+                for(unsigned int j = h.offsets[v]; j < h.offsets[v + 1]; j++){
+                    unsigned int u = h.adj[j];
+                    if(u == v) continue;
+                    unsigned int x = comm[u].load(std::memory_order_relaxed);
+                    if(b.links[x] == 0) b.seen.push_back(x);
+                    b.links[x] += h.weight[j];
+                }
+                unsigned int best = a;
+                double gain = b.links[a] - (tot[a].load(std::memory_order_relaxed) - kv) * kv / h.total;
+                for(unsigned int x : b.seen){
+                    if(x == a) continue;
+                    double g = b.links[x] - tot[x].load(std::memory_order_relaxed) * kv / h.total;
+                    if(g > gain || (g == gain && x < best)){
+                        best = x;
+                        gain = g;
+                    }
+                }
+                for(unsigned int x : b.seen) b.links[x] = 0;
+                b.seen.clear();
+                if(best == a) return;
+                if(size[a].load(std::memory_order_relaxed) == 1 && size[best].load(std::memory_order_relaxed) == 1 && best > a)
+                    return;
+                comm[v].store(best, std::memory_order_relaxed);
+                add(tot[a], -kv);
+                add(tot[best], kv);
+                size[a].fetch_sub(1, std::memory_order_relaxed);
+                size[best].fetch_add(1, std::memory_order_relaxed);
+            }, 256);
+            prev.swap(c);
+            c.resize(n);
+            for(unsigned int v = 0; v < n; v++) c[v] = comm[v].load(std::memory_order_relaxed);
+            double updated = modularity(h, c);
+            if(updated - current < tol){
+                if(updated < current) c.swap(prev);
+                break;
+            }
+            current = updated;
+            improved = true;
+        }
+        return improved;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Communities
+     * @name aggregate()
+     * @brief Graph of the next Louvain level: one vertex per community, the edge weights
+     *        are the sums of the weights between the communities (a self loop keeps the
+     *        weight inside the community)
+     * @param h --> const graph_t: Graph of the level
+     * @param c --> const std::vector<unsigned int>: Community of every vertex, in [0, k)
+     * @param k --> unsigned int: Number of communities
+     * @return graph_t --> Aggregated graph
+    */
+    analytics::Communities::graph_t analytics::Communities::aggregate(const graph_t &h, const std::vector<unsigned int> &c,
+                                                                      unsigned int k)
+    {
+        std::vector<std::tuple<unsigned int, unsigned int, double>> edges(h.adj.size());
+        network::parallel_for(h.size(), [&](size_t v, unsigned int){
+            for(unsigned int j = h.offsets[v]; j < h.offsets[v + 1]; j++)
+                edges[j] = std::make_tuple(c[v], c[h.adj[j]], h.weight[j]);
+        }, 1024);
+        network::parallel_sort(edges.begin(), edges.end(), [](const auto &x, const auto &y){
+            return std::get<0>(x) < std::get<0>(y) || (std::get<0>(x) == std::get<0>(y) && std::get<1>(x) < std::get<1>(y));
+        });
+        graph_t ans;
+        ans.offsets.assign(k + 1, 0);
+        ans.degree.assign(k, 0);
+        for(size_t i = 0; i < edges.size(); i++){
+            auto [u, v, w] = edges[i];
+            if(i && std::get<0>(edges[i - 1]) == u && std::get<1>(edges[i - 1]) == v) ans.weight.back() += w;
+            else{
+                ans.adj.push_back(v);
+                ans.weight.push_back(w);
+                ans.offsets[u + 1]++;
+            }
+            ans.degree[u] += w;
+        }
+        for(unsigned int v = 0; v < k; v++) ans.offsets[v + 1] += ans.offsets[v];
+        ans.total = h.total;
+        return ans;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Communities
+     * @name modularity()
+     * @brief Modularity of a partition: fraction of the weight inside the communities minus
+     *        the fraction expected if the edges were placed at random (same degrees)
+     * @param h --> const graph_t: Graph
+     * @param c --> const std::vector<unsigned int>: Community of every vertex
+     * @return double --> Modularity in [-0.5, 1]
+    */
+    double analytics::Communities::modularity(const graph_t &h, const std::vector<unsigned int> &c){
+        unsigned int n = h.size();
+        if(h.total <= 0) return 0;
+        std::vector<double> inside(network::workers(), 0);
+        network::parallel_for(n, [&](size_t v, unsigned int tid){
+            for(unsigned int j = h.offsets[v]; j < h.offsets[v + 1]; j++)
+                if(c[h.adj[j]] == c[v]) inside[tid] += h.weight[j];
+        }, 1024);
+        std::vector<double> tot(n, 0);
+        for(unsigned int v = 0; v < n; v++) tot[c[v]] += h.degree[v];
+        double expected = 0;
+        for(double t : tot) expected += t * t;
+        return std::accumulate(inside.begin(), inside.end(), 0.0) / h.total - expected / (h.total * h.total);
+    }
+
+    /**
+     * @namespace analytics
+     * @class Communities
+     * @name compact()
+     * @brief Renumber the community ids to [0, k), in order of first appearance
+     * @param c --> std::vector<unsigned int>: Community of every vertex (ids < size)
+     * @return unsigned int --> Number of communities (k)
+    */
+    unsigned int analytics::Communities::compact(std::vector<unsigned int> &c){
+        const unsigned int NONE = -1;
+        std::vector<unsigned int> id(c.size(), NONE);
+        unsigned int k = 0;
+        for(auto &x : c){
+            if(id[x] == NONE) id[x] = k++;
+            x = id[x];
+        }
+        return k;
+    }
+
+    /// @brief Number of users of every community (indexed by community id)
+    std::vector<unsigned int> analytics::Communities::sizes() const{
+        std::vector<unsigned int> ans(ncommunities, 0);
+        for(unsigned int x : membership) ans[x]++;
+        return ans;
+    }
+
+} // namespace analytics
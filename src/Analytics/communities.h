@@ -0,0 +1,60 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile communities.h (header file)
+ *
+ * Communities class interface/structure
+ * Community detection over the undirected view of the network graph (a follow in any
+ * direction connects two users): asynchronous label propagation (fast) and Louvain
+ * modularity optimisation (better quality). Both leave a community id per user and the
+ * modularity of the partition.
+ * Include guard
+ *
+*/
+
+#ifndef COMMUNITIES_H
+#define COMMUNITIES_H
+
+#include <vector>
+#include "../Network/csr.h"
+
+namespace analytics{
+
+class Communities{
+public:
+    static constexpr unsigned int MAX_ITERATIONS = 20;   // Label propagation rounds
+    static constexpr unsigned int MAX_LEVELS = 16;       // Louvain aggregation levels
+    static constexpr unsigned int MAX_PASSES = 32;       // Louvain moving passes per level
+    static constexpr double TOLERANCE = 1e-6;            // Minimum modularity gain of a pass
+
+    Communities(const network::CSR &g);
+    unsigned int label_propagation(unsigned int max_iter = MAX_ITERATIONS, unsigned long seed = 42);
+    unsigned int louvain(unsigned int max_levels = MAX_LEVELS, double tol = TOLERANCE);
+    const std::vector<unsigned int>& labels() const { return membership; } // Inline (vertex id -> [0, count()))
+    unsigned int count() const { return ncommunities; } // Inline
+    double modularity() const { return q; } // Inline
+    std::vector<unsigned int> sizes() const;
+
+private:
+    struct graph_t{   // Undirected weighted graph, both directions stored (self loops once)
+        std::vector<unsigned int> offsets;
+        std::vector<unsigned int> adj;
+        std::vector<double> weight;
+        std::vector<double> degree;      // Sum of the row weights
+        double total = 0;                // Sum of all the degrees (2m)
+        unsigned int size() const { return offsets.size() - 1; } // Inline
+    };
+
+    graph_t base;
+    std::vector<unsigned int> membership;
+    unsigned int ncommunities = 0;
+    double q = 0;
+
+    static unsigned int compact(std::vector<unsigned int> &c);
+    static double modularity(const graph_t &h, const std::vector<unsigned int> &c);
+    static bool move(const graph_t &h, std::vector<unsigned int> &c, double tol);
+    static graph_t aggregate(const graph_t &h, const std::vector<unsigned int> &c, unsigned int k);
+};
+
+} // namespace analytics
+
+#endif // COMMUNITIES_H
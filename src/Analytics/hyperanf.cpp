@@ -0,0 +1,208 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file hyperanf.cpp (.cpp file) (implementation file)
+ *
+ * HyperANF class members/member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include "hyperanf.h"
+#include "../Network/parallel.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace analytics{
+
+    /// @brief Class constructor, binds the graph snapshot
+    /// @param g --> const network::CSR: Graph snapshot (must outlive the object)
+    /// @param log2m --> unsigned int: log2 of the registers per counter (clamped to [4, 16])
+    analytics::HyperANF::HyperANF(const network::CSR &g, unsigned int log2m)
+        : g(g), log2m(std::min(std::max(log2m, 4u), 16u)), m(1u << this->log2m){}
+
+    /**
+     * @namespace analytics
+     * @class HyperANF
+     * @name init()
+     * @brief Counters of radius 0: every user counter holds only the user itself
+     * @param regs --> std::vector<uint8_t>: Registers of all the counters (m per user)
+    */
+    void analytics::HyperANF::init(std::vector<uint8_t> &regs) const{
+        network::parallel_for(g.size(), [&](size_t v, unsigned int){
+            uint64_t h = v + 0x9e3779b97f4a7c15ul;   // splitmix64
+            h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ul;
+            h = (h ^ (h >> 27)) * 0x94d049bb133111ebul;
+            h ^= h >> 31;
+            uint64_t w = h << log2m;
+            regs[v * m + (h >> (64 - log2m))] = w ? __builtin_clzll(w) + 1 : 64 - log2m + 1;
+        }, 4096);
+    }
+
+    /**
+     * @namespace analytics
+     * @class HyperANF
+     * @name estimate()
+     * @brief HyperLogLog cardinality estimate (linear counting for small counters)
+     * @param regs --> const uint8_t*: Registers of a counter
+     * @return double --> Estimated number of distinct users
+    */
+    double analytics::HyperANF::estimate(const uint8_t *regs) const{
+        static const std::vector<double> inverse = []{
+            std::vector<double> p(65);
+            for(unsigned int r = 0; r <= 64; r++) p[r] = std::ldexp(1.0, -(int)r);
+            return p;
+        }();
+        double sum = 0;
+        unsigned int zeros = 0;
+        for(unsigned int j = 0; j < m; j++){
+            sum += inverse[regs[j]];
+            zeros += regs[j] == 0;
+        }
+        double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+        double e = alpha * m * m / sum;
+        if(e <= 2.5 * m && zeros) e = m * std::log((double)m / zeros);
+        return e;
+    }
+
+    /**
+     * @namespace analytics
+     * @class HyperANF
+     * @name merge()
+     * @brief Union of two counters: register-wise maximum, 16 registers per SSE2 instruction
+     * @param dst --> uint8_t*: Registers updated in place
+     * @param src --> const uint8_t*: Registers merged into dst
+     * @return bool --> true: dst changed
+    */
+    bool analytics::HyperANF::merge(uint8_t *dst, const uint8_t *src) const{
+        bool changed = false;
+#if defined(__SSE2__)
+        for(unsigned int j = 0; j < m; j += 16){
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + j));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j));
+            __m128i c = _mm_max_epu8(a, b);
+            changed |= _mm_movemask_epi8(_mm_cmpeq_epi8(a, c)) != 0xffff;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j), c);
+        }
+#else
+        for(unsigned int j = 0; j < m; j++){
+            if(src[j] > dst[j]){
+                dst[j] = src[j];
+                changed = true;
+            }
+        }
+#endif
+        return changed;
+    }
+
+    /**
+     * @namespace analytics
+     * @class HyperANF
+     * @name run()
+     * @brief Grow the counters one hop per iteration (in parallel, reading the previous
+     *        iteration), until no counter changes. A user only merges the counters of the
+     *        neighbours that changed in the previous iteration.
+     * @param followers --> bool: false: Balls over the following links (who a user reaches),
+     *                            true: Balls over the followers (who reaches a user)
+     * @param max_iter --> unsigned int: Iteration limit (maximum radius)
+     * @return unsigned int --> Number of iterations executed
+    */
+    unsigned int analytics::HyperANF::run(bool followers, unsigned int max_iter){
+        unsigned int n = g.size();
+        nf.clear();
+        history.clear();
+        if(!n) return 0;
+        unsigned int nthreads = network::workers();
+        std::vector<uint8_t> cur((size_t)n * m, 0), next((size_t)n * m);
+        std::vector<char> changed(n, 1), grew(n);
+        std::vector<float> est(n);
+        std::vector<double> partial(nthreads);
+        init(cur);
+        network::parallel_for(n, [&](size_t v, unsigned int){ est[v] = estimate(&cur[v * m]); }, 1024);
+        history.push_back(est);
+        nf.push_back(std::accumulate(est.begin(), est.end(), 0.0));
+        while(iterations() < max_iter){
+            std::fill(partial.begin(), partial.end(), 0.0);
+            std::vector<char> any(nthreads, 0);
+            network::parallel_for(n, [&](size_t v, unsigned int tid){
+                uint8_t *dst = &next[v * m];
+                std::memcpy(dst, &cur[v * m], m);
+                const unsigned int *begin = followers ? g.in_begin(v) : g.out_begin(v);
+                const unsigned int *end = followers ? g.in_end(v) : g.out_end(v);
+                bool up = false;
+                for(const unsigned int *w = begin; w != end; ++w)
+                    if(changed[*w]) up |= merge(dst, &cur[(size_t)*w * m]);
+                grew[v] = up;
+                if(up){
+                    est[v] = estimate(dst);
+                    any[tid] = 1;
+                }
+                partial[tid] += est[v];
+            }, 256);
+            if(std::find(any.begin(), any.end(), 1) == any.end()) break;
+            cur.swap(next);
+            changed.swap(grew);
+            history.push_back(est);
+            nf.push_back(std::accumulate(partial.begin(), partial.end(), 0.0));
+        }
+        return iterations();
+    }
+
+    /**
+     * @namespace analytics
+     * @class HyperANF
+     * @name reach()
+     * @brief Estimated number of users within k hops of a user (the user itself excluded)
+     * @param v --> unsigned int: Vertex id
+     * @param k --> unsigned int: Maximum number of hops
+     * @return double --> Estimated reach
+    */
+    double analytics::HyperANF::reach(unsigned int v, unsigned int k) const{
+        if(history.empty() || v >= history[0].size()) return 0;
+        unsigned int t = std::min(k, iterations());
+        return std::max(0.0, (double)history[t][v] - history[0][v]);
+    }
+
+    /**
+     * @namespace analytics
+     * @class HyperANF
+     * @name effective_diameter()
+     * @brief Smallest distance (interpolated) within which a fraction alpha of the
+     *        connected pairs is found
+     * @param alpha --> double: Fraction of the pairs (usually 0.9)
+     * @return double --> Effective diameter
+    */
+    double analytics::HyperANF::effective_diameter(double alpha) const{
+        if(nf.size() < 2) return 0;
+        double target = alpha * nf.back();
+        unsigned int t = 0;
+        while(t < nf.size() && nf[t] < target) t++;
+        if(t == 0) return 0;
+        return t - 1 + (target - nf[t - 1]) / (nf[t] - nf[t - 1]);
+    }
+
+    /**
+     * @namespace analytics
+     * @class HyperANF
+     * @name average_distance()
+     * @brief Average distance between the connected pairs (u != v)
+     * @return double --> Average distance
+    */
+    double analytics::HyperANF::average_distance() const{
+        if(nf.size() < 2 || nf.back() <= nf[0]) return 0;
+        double sum = 0;
+        for(size_t t = 1; t < nf.size(); t++) sum += t * (nf[t] - nf[t - 1]);
+        return sum / (nf.back() - nf[0]);
+    }
+
+    /// @brief Memory used by the estimates kept for the reach queries
+    size_t analytics::HyperANF::bytes() const{
+        size_t ans = nf.capacity() * sizeof(double) + history.capacity() * sizeof(std::vector<float>);
+        for(const auto &h : history) ans += h.capacity() * sizeof(float);
+        return ans;
+    }
+
+} // namespace analytics
@@ -0,0 +1,51 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile hyperanf.h (header file)
+ *
+ * HyperANF class interface/structure
+ * Approximate neighbourhood function over a CSR snapshot: every user keeps a HyperLogLog
+ * counter of the users within t hops, and iteration t + 1 merges the counters of the
+ * followed users (register-wise maximum). Gives the estimated reach of every user, the
+ * effective diameter and the average distance without a BFS per user.
+ * Include guard
+ *
+*/
+
+#ifndef HYPERANF_H
+#define HYPERANF_H
+
+#include <cstdint>
+#include <vector>
+#include "../Network/csr.h"
+
+namespace analytics{
+
+class HyperANF{
+public:
+    static constexpr unsigned int LOG2M = 6;              // 64 registers per counter (~13% std. error)
+    static constexpr unsigned int MAX_ITERATIONS = 64;
+
+    HyperANF(const network::CSR &g, unsigned int log2m = LOG2M);
+    unsigned int run(bool followers = false, unsigned int max_iter = MAX_ITERATIONS);
+    const std::vector<double>& neighbourhood() const { return nf; } // Inline
+    unsigned int iterations() const { return nf.empty() ? 0 : nf.size() - 1; } // Inline
+    double reach(unsigned int v, unsigned int k) const;
+    double effective_diameter(double alpha = 0.9) const;
+    double average_distance() const;
+    size_t bytes() const;
+
+private:
+    const network::CSR &g;
+    unsigned int log2m;
+    unsigned int m;                                // Registers per counter
+    std::vector<double> nf;                        // nf[t]: pairs (u, v) with dist(u, v) <= t
+    std::vector<std::vector<float>> history;       // history[t][v]: size of the ball of radius t
+
+    void init(std::vector<uint8_t> &regs) const;
+    double estimate(const uint8_t *regs) const;
+    bool merge(uint8_t *dst, const uint8_t *src) const;
+};
+
+} // namespace analytics
+
+#endif // HYPERANF_H
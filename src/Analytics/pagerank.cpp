@@ -0,0 +1,133 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file pagerank.cpp (.cpp file) (implementation file)
+ * 
+ * PageRank class members/member functions implementation
+ * 
+*/
+
+#include <algorithm>
+#include <cmath>
+#include "pagerank.h"
+#include "../Network/parallel.h"
+
+namespace analytics{
+
+    /// @brief Class constructor, binds the graph snapshot
+    /// @param g --> const network::CSR: Graph snapshot (must outlive the object)
+    analytics::PageRank::PageRank(const network::CSR &g) : g(g){}
+
+    /**
+     * @namespace analytics
+     * @class PageRank
+     * @name run()
+     * @brief Global PageRank (uniform teleport)
+     * @param warm --> const std::vector<double>*: Previous scores to start from (nullptr: uniform)
+     * @param damping --> double: Probability of following a link
+     * @param tol --> double: Convergence tolerance (L1 change between iterations)
+     * @param max_iter --> unsigned int: Iteration limit
+     * @return unsigned int --> Number of iterations executed
+    */
+    unsigned int analytics::PageRank::run(const std::vector<double> *warm, double damping,
+                                          double tol, unsigned int max_iter)
+    {
+        unsigned int n = g.size();
+        if(!n) return 0;
+        rank.assign(n, 1.0 / n);
+        if(warm && warm->size() == n){
+            double sum = 0;
+            for(double x : *warm) sum += x;
+            if(sum > 0)
+                for(unsigned int v = 0; v < n; v++) rank[v] = (*warm)[v] / sum;
+        }
+        std::vector<double> teleport(n, 1.0 / n);
+        return iterate(teleport, damping, tol, max_iter);
+    }
+
+    /**
+     * @namespace analytics
+     * @class PageRank
+     * @name run_personalized()
+     * @brief Personalised PageRank: random jumps (and dangling mass) go back to the seed users
+     * @param seeds --> const std::vector<unsigned int>: Seed vertex ids
+     * @return unsigned int --> Number of iterations executed
+    */
+    unsigned int analytics::PageRank::run_personalized(const std::vector<unsigned int> &seeds, double damping,
+                                                       double tol, unsigned int max_iter)
+    {
+        unsigned int n = g.size();
+        if(!n || seeds.empty()) return 0;
+        std::vector<double> teleport(n, 0.0);
+        for(unsigned int s : seeds) teleport[s] += 1.0 / seeds.size();
+        rank = teleport;
+        return iterate(teleport, damping, tol, max_iter);
+    }
+
+    /**
+     * @namespace analytics
+     * @class PageRank
+     * @name iterate()
+     * @brief Power iteration with a parallel pull-based SpMV over the in-links:
+     *        every vertex reads the contributions of its followers, so no atomics are needed.
+     *        Users that follow nobody (dangling) spread their mass by the teleport vector.
+    */
+    unsigned int analytics::PageRank::iterate(const std::vector<double> &teleport, double damping,
+                                              double tol, unsigned int max_iter)
+    {
+        unsigned int n = g.size();
+        unsigned int nthreads = network::workers();
+        std::vector<double> contrib(n), next(n);
+        std::vector<double> partial(nthreads);
+        unsigned int it = 0;
+        delta = 0;
+        while(it < max_iter){
+            it++;
+            std::fill(partial.begin(), partial.end(), 0.0);
+            network::parallel_for(n, [&](size_t v, unsigned int tid){
+                unsigned int d = g.outdegree(v);
+                if(d) contrib[v] = rank[v] / d;
+                else{
+                    contrib[v] = 0;
+                    partial[tid] += rank[v];
+                }
+            }, 1024);
+            double dangling = 0;
+            for(double x : partial) dangling += x;
+
+            std::fill(partial.begin(), partial.end(), 0.0);
+            network::parallel_for(n, [&](size_t v, unsigned int tid){
+                double sum = 0;
+                for(const unsigned int *u = g.in_begin(v); u != g.in_end(v); ++u) sum += contrib[*u];
+                double r = (1.0 - damping) * teleport[v] + damping * (sum + dangling * teleport[v]);
+                partial[tid] += std::fabs(r - rank[v]);
+                next[v] = r;
+            }, 256);
+            rank.swap(next);
+            delta = 0;
+            for(double x : partial) delta += x;
+            if(delta < tol) break;
+        }
+        return it;
+    }
+
+    /**
+     * @namespace analytics
+     * @class PageRank
+     * @name top()
+     * @brief Get the k highest ranked vertices
+     * @param k --> size_t: Number of vertices
+     * @return std::vector<std::pair> --> (vertex id, score) sorted by score (descending)
+    */
+    std::vector<std::pair<unsigned int, double>> analytics::PageRank::top(size_t k) const{
+        std::vector<std::pair<unsigned int, double>> ans;
+        ans.reserve(rank.size());
+        for(unsigned int v = 0; v < rank.size(); v++) ans.emplace_back(v, rank[v]);
+        k = std::min(k, ans.size());
+        std::partial_sort(ans.begin(), ans.begin() + k, ans.end(), [](const auto &a, const auto &b){
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        });
+        ans.resize(k);
+        return ans;
+    }
+
+} // namespace analytics
@@ -0,0 +1,46 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile pagerank.h (header file)
+ * 
+ * PageRank class interface/structure
+ * Global and personalised PageRank over a CSR snapshot of the network graph.
+ * Include guard
+ * 
+*/
+
+#ifndef PAGERANK_H
+#define PAGERANK_H
+
+#include <utility>
+#include <vector>
+#include "../Network/csr.h"
+
+namespace analytics{
+
+class PageRank{
+public:
+    static constexpr double DAMPING = 0.85;
+    static constexpr double TOLERANCE = 1e-10;
+    static constexpr unsigned int MAX_ITERATIONS = 100;
+
+    PageRank(const network::CSR &g);
+    unsigned int run(const std::vector<double> *warm = nullptr, double damping = DAMPING,
+                     double tol = TOLERANCE, unsigned int max_iter = MAX_ITERATIONS);
+    unsigned int run_personalized(const std::vector<unsigned int> &seeds, double damping = DAMPING,
+                                  double tol = TOLERANCE, unsigned int max_iter = MAX_ITERATIONS);
+    const std::vector<double>& scores() const { return rank; } // Inline
+    double residual() const { return delta; } // Inline
+    std::vector<std::pair<unsigned int, double>> top(size_t k) const;
+
+private:
+    const network::CSR &g;
+    std::vector<double> rank;
+    double delta = 0;
+
+    unsigned int iterate(const std::vector<double> &teleport, double damping,
+                         double tol, unsigned int max_iter);
+};
+
+} // namespace analytics
+
+#endif // PAGERANK_H
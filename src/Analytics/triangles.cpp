@@ -0,0 +1,269 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file triangles.cpp (.cpp file) (implementation file)
+ * 
+ * Triangles class members/member functions implementation
+ * 
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include "triangles.h"
+#include "../Network/parallel.h"
+
+namespace analytics{
+
+    /**
+     * @namespace analytics
+     * @name intersect_sorted()
+     * @brief Call out(x) for every x present in both sorted ranges.
+     *        Uses a linear merge for ranges of similar size and galloping
+     *        (binary search from the smaller range) when sizes are skewed.
+    */
+    template<typename F>
+    static void intersect_sorted(const unsigned int *a, const unsigned int *aend,
+                                 const unsigned int *b, const unsigned int *bend, F &&out)
+    {
+        size_t an = aend - a, bn = bend - b;
+        if(an > bn){
+            std::swap(a, b); std::swap(aend, bend); std::swap(an, bn);
+        }
+        if(an * 32 < bn){
+            for(; a != aend && b != bend; ++a){
+                b = std::lower_bound(b, bend, *a);
+                if(b != bend && *b == *a) out(*a);
+            }
+            return;
+        }
+        while(a != aend && b != bend){
+            if(*a < *b) ++a;
+            else if(*b < *a) ++b;
+            else{
+                out(*a);
+                ++a; ++b;
+            }
+        }
+    }
+
+    /**
+     * @namespace analytics
+     * @class Triangles
+     * @name Triangles()
+     * @brief Build the undirected simple view (out + in links merged, loops removed)
+     *        of a graph snapshot and count its wedges.
+     * @param g --> const network::CSR: Graph snapshot
+    */
+    analytics::Triangles::Triangles(const network::CSR &g){
+        unsigned int n = g.size();
+        offsets.assign(n + 1, 0);
+        network::parallel_for(n, [&](size_t v, unsigned int){
+            unsigned int count = 0;
+            const unsigned int *a = g.out_begin(v), *aend = g.out_end(v);
+            const unsigned int *b = g.in_begin(v), *bend = g.in_end(v);
+            unsigned int last = -1;
+            while(a != aend || b != bend){
+                unsigned int x = (b == bend || (a != aend && *a < *b)) ? *a++ : *b++;
+                if(x != v && x != last) count++;
+                last = x;
+            }
+            offsets[v + 1] = count;
+        });
+        for(unsigned int v = 0; v < n; v++) offsets[v + 1] += offsets[v];
+        adj.resize(offsets[n]);
+        network::parallel_for(n, [&](size_t v, unsigned int){
+            unsigned int pos = offsets[v];
+            const unsigned int *a = g.out_begin(v), *aend = g.out_end(v);
+            const unsigned int *b = g.in_begin(v), *bend = g.in_end(v);
+            unsigned int last = -1;
+            while(a != aend || b != bend){
+                unsigned int x = (b == bend || (a != aend && *a < *b)) ? *a++ : *b++;
+                if(x != v && x != last) adj[pos++] = x;
+                last = x;
+            }
+        });
+        nwedges = 0;
+        for(unsigned int v = 0; v < n; v++){
+            unsigned long d = udegree(v);
+            nwedges += d * (d - (d > 0)) / 2;
+        }
+    }
+
+    /**
+     * @namespace analytics
+     * @class Triangles
+     * @name count()
+     * @brief Exact parallel triangle counting. Every edge is oriented from the lower
+     *        to the higher (degree, id) rank, so each triangle is found exactly once
+     *        by intersecting the oriented lists of its two lowest ranked vertices.
+    */
+    void analytics::Triangles::count(){
+        unsigned int n = offsets.size() - 1;
+        auto lower = [&](unsigned int u, unsigned int v){
+            unsigned int du = udegree(u), dv = udegree(v);
+            return du < dv || (du == dv && u < v);
+        };
+        std::vector<unsigned int> ooff(n + 1, 0);
+        network::parallel_for(n, [&](size_t v, unsigned int){
+            unsigned int c = 0;
+            for(unsigned int i = offsets[v]; i < offsets[v + 1]; i++)
+                if(lower(v, adj[i])) c++;
+            ooff[v + 1] = c;
+        });
+        for(unsigned int v = 0; v < n; v++) ooff[v + 1] += ooff[v];
+        std::vector<unsigned int> oadj(ooff[n]);
+        network::parallel_for(n, [&](size_t v, unsigned int){
+            unsigned int pos = ooff[v];
+            for(unsigned int i = offsets[v]; i < offsets[v + 1]; i++)
+                if(lower(v, adj[i])) oadj[pos++] = adj[i];
+        });
+
+        std::vector<std::atomic<unsigned long>> counts(n);
+        std::atomic<unsigned long> total(0);
+        network::parallel_for(n, [&](size_t v, unsigned int){
+            const unsigned int *vb = oadj.data() + ooff[v], *ve = oadj.data() + ooff[v + 1];
+            unsigned long local = 0;
+            for(const unsigned int *u = vb; u != ve; ++u){
+                const unsigned int ui = *u;
+                intersect_sorted(vb, ve, oadj.data() + ooff[ui], oadj.data() + ooff[ui + 1],
+                                 [&](unsigned int w){
+                                     local++;
+                                     counts[ui].fetch_add(1, std::memory_order_relaxed);
+                                     counts[w].fetch_add(1, std::memory_order_relaxed);
+                                 });
+            }
+            if(local){
+                counts[v].fetch_add(local, std::memory_order_relaxed);
+                total.fetch_add(local, std::memory_order_relaxed);
+            }
+        }, 16);
+        per_vertex.resize(n);
+        for(unsigned int v = 0; v < n; v++) per_vertex[v] = counts[v].load();
+        ntriangles = total.load();
+        counted = true;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Triangles
+     * @name count()
+     * @brief Count only the triangles through one vertex (no full counting pass)
+     * @param v --> unsigned int: Vertex id
+     * @return unsigned long --> Number of triangles containing v
+    */
+    unsigned long analytics::Triangles::count(unsigned int v) const{
+        const unsigned int *vb = adj.data() + offsets[v], *ve = adj.data() + offsets[v + 1];
+        unsigned long ans = 0;
+        for(const unsigned int *u = vb; u != ve; ++u)
+            intersect_sorted(vb, ve, adj.data() + offsets[*u], adj.data() + offsets[*u + 1],
+                             [&](unsigned int){ ans++; });
+        return ans / 2;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Triangles
+     * @name sample()
+     * @brief Approximate counting by wedge sampling: wedges (paths u - v - w) are drawn
+     *        uniformly and the closed fraction estimates the global clustering coefficient.
+     *        The confidence interval comes from the Hoeffding bound, so it holds for any graph.
+     * @param samples --> unsigned long: Number of wedges to draw
+     * @param confidence --> double: Confidence level of the interval (0, 1)
+     * @param seed --> unsigned long: Random seed (results are reproducible)
+     * @return estimate_t --> Estimated triangles/transitivity and interval half width
+    */
+    analytics::Triangles::estimate_t analytics::Triangles::sample(unsigned long samples, double confidence,
+                                                                  unsigned long seed)
+    {
+        estimate_t est;
+        unsigned int n = offsets.size() - 1;
+        if(!nwedges || !samples) return est;
+        std::vector<unsigned long> prefix(n + 1, 0);
+        for(unsigned int v = 0; v < n; v++){
+            unsigned long d = udegree(v);
+            prefix[v + 1] = prefix[v] + d * (d - (d > 0)) / 2;
+        }
+        unsigned int nthreads = network::workers();
+        std::atomic<unsigned long> closed(0);
+        network::parallel_for(nthreads, [&](size_t t, unsigned int){
+            std::mt19937_64 rng(seed + t);
+            std::uniform_int_distribution<unsigned long> pick(0, nwedges - 1);
+            unsigned long share = samples / nthreads + (t < samples % nthreads);
+            unsigned long local = 0;
+            for(unsigned long s = 0; s < share; s++){
+                unsigned long r = pick(rng);
+                unsigned int v = std::upper_bound(prefix.begin(), prefix.end(), r) - prefix.begin() - 1;
+                unsigned int d = udegree(v);
+                std::uniform_int_distribution<unsigned int> nb(0, d - 1);
+                unsigned int i = nb(rng), j = nb(rng);
+                while(j == i) j = nb(rng);
+                if(adjacent(adj[offsets[v] + i], adj[offsets[v] + j])) local++;
+            }
+            closed.fetch_add(local);
+        }, 1);
+        est.samples = samples;
+        est.transitivity = (double)closed.load() / samples;
+        est.triangles = est.transitivity * nwedges / 3.0;
+        est.margin = std::sqrt(std::log(2.0 / (1.0 - confidence)) / (2.0 * samples));
+        return est;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Triangles
+     * @name adjacent()
+     * @brief Check if two vertices are linked (binary search in the smaller list)
+    */
+    bool analytics::Triangles::adjacent(unsigned int u, unsigned int v) const{
+        if(udegree(u) > udegree(v)) std::swap(u, v);
+        return std::binary_search(adj.begin() + offsets[u], adj.begin() + offsets[u + 1], v);
+    }
+
+    /**
+     * @namespace analytics
+     * @class Triangles
+     * @name triangles()
+     * @brief Number of triangles a vertex belongs to
+    */
+    unsigned long analytics::Triangles::triangles(unsigned int v) const{
+        return counted ? per_vertex[v] : count(v);
+    }
+
+    /**
+     * @namespace analytics
+     * @class Triangles
+     * @name local_clustering()
+     * @brief Fraction of the vertex neighbor pairs that are linked
+    */
+    double analytics::Triangles::local_clustering(unsigned int v) const{
+        unsigned long d = udegree(v);
+        if(d < 2) return 0;
+        return (double)triangles(v) / (d * (d - 1) / 2);
+    }
+
+    /**
+     * @namespace analytics
+     * @class Triangles
+     * @name average_clustering()
+     * @brief Mean of the local clustering coefficients of all vertices (requires count())
+    */
+    double analytics::Triangles::average_clustering() const{
+        unsigned int n = offsets.size() - 1;
+        if(!n) return 0;
+        double ans = 0;
+        for(unsigned int v = 0; v < n; v++) ans += local_clustering(v);
+        return ans / n;
+    }
+
+    /**
+     * @namespace analytics
+     * @class Triangles
+     * @name global_clustering()
+     * @brief Transitivity: 3 * triangles / wedges (requires count())
+    */
+    double analytics::Triangles::global_clustering() const{
+        return nwedges ? 3.0 * ntriangles / nwedges : 0;
+    }
+
+} // namespace analytics
@@ -0,0 +1,60 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile triangles.h (header file)
+ * 
+ * Triangles class interface/structure
+ * Triangle counting and clustering coefficients over the undirected view of the
+ * network graph (a follow in any direction connects two users).
+ * Include guard
+ * 
+*/
+
+#ifndef TRIANGLES_H
+#define TRIANGLES_H
+
+#include <vector>
+#include "../Network/csr.h"
+
+namespace analytics{
+
+class Triangles{
+public:
+    struct estimate_t{
+        double triangles = 0;      // Estimated number of triangles
+        double transitivity = 0;   // Estimated global clustering coefficient
+        double margin = 0;         // Half width of the confidence interval (transitivity)
+        unsigned long samples = 0;
+    };
+
+    // Above this number of wedges the stats report switches to wedge sampling
+    static constexpr unsigned long EXACT_WEDGE_LIMIT = 2000000000ul;
+    static constexpr unsigned long DEFAULT_SAMPLES = 200000ul;
+
+    Triangles(const network::CSR &g);
+    void count();
+    unsigned long count(unsigned int v) const;
+    estimate_t sample(unsigned long samples = DEFAULT_SAMPLES, double confidence = 0.95,
+                      unsigned long seed = 42);
+    bool exact_feasible() const { return nwedges <= EXACT_WEDGE_LIMIT; } // Inline
+    unsigned long total() const { return ntriangles; } // Inline
+    unsigned long wedges() const { return nwedges; } // Inline
+    unsigned long triangles(unsigned int v) const;
+    double local_clustering(unsigned int v) const;
+    double average_clustering() const;
+    double global_clustering() const;
+
+private:
+    std::vector<unsigned int> offsets;   // Undirected simple graph (sorted, no loops)
+    std::vector<unsigned int> adj;
+    std::vector<unsigned long> per_vertex;
+    unsigned long ntriangles = 0;
+    unsigned long nwedges = 0;
+    bool counted = false;
+
+    unsigned int udegree(unsigned int v) const { return offsets[v + 1] - offsets[v]; } // Inline
+    bool adjacent(unsigned int u, unsigned int v) const;
+};
+
+} // namespace analytics
+
+#endif // TRIANGLES_H
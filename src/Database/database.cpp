@@ -6,19 +6,32 @@
  * 
 */
 
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <utility>
 #include <sqlite3.h>
 #include "database.h"
+#include "../Network/parallel.h"
 
 namespace database{
 
     /// @brief Database class overloaded constructor to start the database directly
     /// @param sm --> SocialMedia object
-    database::Database::Database(socialmedia::SocialMedia &sm){
-        if(dbinit(sm)) std::cout << std::endl << "Banco de dados iniciado e carregado com sucesso!" << std::endl;
+    /// @param dbname --> const std::string: Database file
+    database::Database::Database(socialmedia::SocialMedia &sm, const std::string &dbname){
+        if(dbinit(sm, dbname)) std::cout << std::endl << "Banco de dados iniciado e carregado com sucesso!" << std::endl;
         else std::cout << std::endl << "Problemas no banco de dados, favor verificar!" << std::endl;
     }
 
+    /// @brief Database class overloaded constructor for the out-of-core mode:
+    ///        open the database (creating the tables) without loading it
+    /// @param dbname --> const std::string: Database file
+    database::Database::Database(const std::string &dbname){
+        if(!open_database(dbname) || !create_table())
+            std::cout << std::endl << "Problemas no banco de dados, favor verificar!" << std::endl;
+    }
+
     /// @brief Default class constructor
     database::Database::Database(){};
 
@@ -44,6 +57,93 @@ namespace database{
             std::cout << "Erro ao abrir o banco de dados: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
+        // WAL: the loader reads through extra connections while this one stays open
+        sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class Database
+     * @name split()
+     * @brief Split the rowids of a table in ranges of the same width (one per loader thread)
+     * @param table --> const std::string: Table name
+     * @param parts --> unsigned int: Maximum number of ranges
+     * @return std::vector<range_t> --> Ranges covering all the rows (empty if the table is empty)
+    */
+    std::vector<database::Database::range_t> database::Database::split(const std::string &table, unsigned int parts){
+        std::vector<range_t> ans;
+        std::string query = "SELECT MIN(rowid), MAX(rowid) FROM " + table + ";";
+        sqlite3_stmt* stmt;
+        if(sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return ans;
+        if(sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL){
+            long long lo = sqlite3_column_int64(stmt, 0), hi = sqlite3_column_int64(stmt, 1);
+            unsigned long long span = hi - lo + 1;
+            if(span < parts) parts = span;
+            for(unsigned int p = 0; p < parts; p++)
+                ans.push_back({lo + (long long)(span * p / parts), lo + (long long)(span * (p + 1) / parts) - 1});
+        }
+        sqlite3_finalize(stmt);
+        return ans;
+    }
+
+    /**
+     * @namespace database
+     * @class Database
+     * @name scan()
+     * @brief Run a query over rowid ranges concurrently, each range in its own thread with its
+     *        own read-only connection (a single range uses the main connection)
+     * @param query --> const std::string: Query with two parameters (first and last rowid)
+     * @param columns --> size_t: Number of text columns selected
+     * @param parts --> const std::vector<range_t>: Rowid ranges
+     * @param rows --> std::vector<std::vector<std::string>>: Output, rows[p] holds the columns of the
+     *                 rows of range p one after the other (rows with a NULL column are skipped)
+     * @return bool --> true: Ranges successfully read, false: Error reading a range
+    */
+    bool database::Database::scan(const std::string &query, size_t columns, const std::vector<range_t> &parts,
+                                  std::vector<std::vector<std::string>> &rows)
+    {
+        rows.assign(parts.size(), {});
+        std::vector<std::string> errmsg(parts.size());
+        const char *file = sqlite3_db_filename(db, "main");
+        bool shared = parts.size() == 1 || !file || !*file;
+        auto read = [&](size_t p){
+            sqlite3 *conn = db;
+            if(!shared && sqlite3_open_v2(file, &conn, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK){
+                errmsg[p] = sqlite3_errmsg(conn);
+                sqlite3_close(conn);
+                return;
+            }
+            sqlite3_stmt* stmt;
+            if(sqlite3_prepare_v2(conn, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) errmsg[p] = sqlite3_errmsg(conn);
+            else{
+                sqlite3_bind_int64(stmt, 1, parts[p].first);
+                sqlite3_bind_int64(stmt, 2, parts[p].last);
+                int rc;
+                while((rc = sqlite3_step(stmt)) == SQLITE_ROW){
+                    bool complete = true;
+                    for(size_t c = 0; c < columns && complete; c++) complete = sqlite3_column_type(stmt, c) != SQLITE_NULL;
+                    if(!complete) continue;
+                    for(size_t c = 0; c < columns; c++)
+                        rows[p].emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, c)));
+                }
+                if(rc != SQLITE_DONE) errmsg[p] = sqlite3_errmsg(conn);
+                sqlite3_finalize(stmt);
+            }
+            if(!shared) sqlite3_close(conn);
+        };
+        std::vector<std::thread> pool;
+        for(size_t p = 1; p < parts.size(); p++){
+            if(shared) read(p);
+            else pool.emplace_back(read, p);
+        }
+        if(!parts.empty()) read(0);
+        for(auto &t : pool) t.join();
+        for(const auto &e : errmsg){
+            if(e.empty()) continue;
+            std::cout << "Erro ao executar a query SQL: " << e << std::endl;
+            return false;
+        }
         return true;
     }
 
@@ -65,7 +165,22 @@ namespace database{
                             "CREATE TABLE IF NOT EXISTS connections ("
                             "id INTEGER PRIMARY KEY AUTOINCREMENT, "
                             "user1 TEXT NOT NULL, "
-                            "user2 TEXT NOT NULL);";
+                            "user2 TEXT NOT NULL, "
+                            "created INTEGER NOT NULL DEFAULT 0, "
+                            "weight REAL NOT NULL DEFAULT 1);"
+                            "CREATE INDEX IF NOT EXISTS connections_user1 ON connections (user1);"
+                            "CREATE INDEX IF NOT EXISTS connections_user2 ON connections (user2);"
+
+                            "CREATE TABLE IF NOT EXISTS posts ("
+                            "id INTEGER PRIMARY KEY, "
+                            "author TEXT NOT NULL, "
+                            "created INTEGER NOT NULL, "
+                            "body TEXT NOT NULL);"
+
+                            "CREATE TABLE IF NOT EXISTS distance_index ("
+                            "id INTEGER PRIMARY KEY CHECK (id = 0), "
+                            "fingerprint INTEGER NOT NULL, "
+                            "data BLOB NOT NULL);";
         char* err;
         int rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, &err);
         if(rc != SQLITE_OK){
@@ -73,6 +188,36 @@ namespace database{
             sqlite3_free(err);
             return false;
         }
+        return migrate();
+    }
+
+    /**
+     * @namespace database
+     * @class Database
+     * @name migrate()
+     * @brief Bring tables created by older versions up to date: the links gained a creation
+     *        time (0: unknown) and a weight (1)
+     * @return bool --> true: Schema up to date, false: Error changing a table
+    */
+    bool database::Database::migrate(){
+        sqlite3_stmt* stmt;
+        bool timed = false;
+        if(sqlite3_prepare_v2(db, "PRAGMA table_info(connections);", -1, &stmt, nullptr) != SQLITE_OK) return false;
+        while(sqlite3_step(stmt) == SQLITE_ROW)
+            timed = timed || std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1))) == "created";
+        sqlite3_finalize(stmt);
+        if(timed) return true;
+        char* err;
+        int rc = sqlite3_exec(db, "BEGIN;"
+                                  "ALTER TABLE connections ADD COLUMN created INTEGER NOT NULL DEFAULT 0;"
+                                  "ALTER TABLE connections ADD COLUMN weight REAL NOT NULL DEFAULT 1;"
+                                  "COMMIT;", nullptr, nullptr, &err);
+        if(rc != SQLITE_OK){
+            std::cout << "Erro ao atualizar a tabela connections: " << err << std::endl;
+            sqlite3_free(err);
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
         return true;
     }
 
@@ -120,42 +265,24 @@ namespace database{
      * @namespace database
      * @class Database
      * @name load_users()
-     * @brief Load all the users in the database to the network graph (nodes hashmap)
+     * @brief Load all the users in the database to the network graph (nodes hashmap).
+     *        The rowid ranges of the table are read concurrently and inserted in rowid order.
      * @attention This member function is called by the overloaded constructor or the dbinit
      *            member function in the database class.
      * @param sm --> SocialMedia object
      * @return bool --> true: Users successfully loaded, false: Error loading users
     */
     bool database::Database::load_users(socialmedia::SocialMedia& sm) {
-        std::string query = "SELECT * FROM users;";
-        sqlite3_stmt* stmt;
-        int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
-        if(rc != SQLITE_OK){
-            std::cout << "Erro ao preparar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+        std::vector<std::vector<std::string>> rows;
+        if(!scan("SELECT email, name, birthdate, phone, city FROM users WHERE rowid BETWEEN ? AND ? ORDER BY rowid;",
+                 5, split("users", network::workers()), rows))
             return false;
-        }
-        while((rc = sqlite3_step(stmt)) == SQLITE_ROW){
-            if(
-               sqlite3_column_type(stmt, 0) != SQLITE_NULL && 
-               sqlite3_column_type(stmt, 1) != SQLITE_NULL &&
-               sqlite3_column_type(stmt, 2) != SQLITE_NULL &&
-               sqlite3_column_type(stmt, 3) != SQLITE_NULL &&
-               sqlite3_column_type(stmt, 4) != SQLITE_NULL
-            ){
-                std::string email = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-                std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-                std::string birthdate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-                std::string phone = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-                std::string city = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-                sm.insert_node(email, name, birthdate, phone, city);
-            }
-        }
-        if(rc != SQLITE_DONE){
-            std::cout << "Erro ao executar a query SQL: " << sqlite3_errmsg(db) << std::endl;
-            sqlite3_finalize(stmt);
-            return false;
-        }
-        sqlite3_finalize(stmt);
+        size_t total = 0;
+        for(const auto &r : rows) total += r.size() / 5;
+        sm.reserve(total);
+        for(const auto &r : rows)
+            for(size_t i = 0; i < r.size(); i += 5)
+                sm.insert_node(r[i], r[i + 1], r[i + 2], r[i + 3], r[i + 4]);
         return true;
     }
 
@@ -182,10 +309,11 @@ namespace database{
      * @brief Properly start the database, opening the database, loading the users/links and
      *        creating the tables (if doesn't exists).
      * @param sm --> SocialMedia object
+     * @param dbname --> const std::string: Database file
      * @return bool --> true: Database successfully started, false: Error starting the database
     */
-    bool database::Database::dbinit(socialmedia::SocialMedia &sm){
-        if(open_database("src/Database/graphsocial.db") && create_table() && load_users(sm) && load_links(sm))
+    bool database::Database::dbinit(socialmedia::SocialMedia &sm, const std::string &dbname){
+        if(open_database(dbname) && create_table() && load_users(sm) && load_links(sm) && load_posts(sm))
             return true;
         return false;
     }
@@ -194,16 +322,19 @@ namespace database{
      * @namespace database
      * @class Database
      * @name save_link()
-     * @brief Save a link between two users in the database
+     * @brief Save a link between two users in the database (an existing link gets the new weight)
      * @attention This member function is called in SocialMedia class everytime that a user follow
      *            a user.
      * @param src --> const std::string: First user of the link
      * @param dest --> const std::string: Second user of the link
+     * @param time --> long long: Creation time (Unix time in seconds)
+     * @param weight --> double: Weight of the link
      * @return bool --> true: Link successfully saved, false: Error saving link
     */
-    bool database::Database::save_link(const std::string &src, const std::string &dest){
-        if(search_link(src, dest)) return false;
-        std::string query = "INSERT INTO connections (user1, user2) VALUES (?, ?);";
+    bool database::Database::save_link(const std::string &src, const std::string &dest, long long time, double weight){
+        bool exists = search_link(src, dest);
+        std::string query = exists ? "UPDATE connections SET weight = ?4 WHERE user1 = ?1 AND user2 = ?2;"
+                                   : "INSERT INTO connections (user1, user2, created, weight) VALUES (?1, ?2, ?3, ?4);";
         sqlite3_stmt* stmt;
         int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
         if(rc != SQLITE_OK){
@@ -222,6 +353,8 @@ namespace database{
             sqlite3_finalize(stmt);
             return false;
         }
+        if(!exists) sqlite3_bind_int64(stmt, 3, time);
+        sqlite3_bind_double(stmt, 4, weight);
         rc = sqlite3_step(stmt);
         if(rc != SQLITE_DONE){
             std::cout << "Erro ao executar a query SQL: " << sqlite3_errmsg(db) << std::endl;
@@ -236,28 +369,25 @@ namespace database{
     /**
      * @namespace database
      * @class Database
-     * @name load_links()
-     * @brief Load all the links between users in the database to each user that the link belongs
-     * @attention This member function is called by the overloaded constructor or the dbinit
-     *            member function in the database class.
-     * @param sm --> SocialMedia object
-     * @return bool --> true: Links successfully loaded, false: Error loading links
+     * @name drop_link()
+     * @brief Delete a link between two users in the database
+     * @attention This member function is called in SocialMedia class everytime that a user
+     *            unfollows a user.
+     * @param src --> const std::string: First user of the link
+     * @param dest --> const std::string: Second user of the link
+     * @return bool --> true: Link successfully deleted, false: Error deleting link
     */
-    bool database::Database::load_links(socialmedia::SocialMedia& sm){
-        std::string query = "SELECT user1, user2 FROM connections;";
+    bool database::Database::drop_link(const std::string &src, const std::string &dest){
+        std::string query = "DELETE FROM connections WHERE user1 = ? AND user2 = ?;";
         sqlite3_stmt* stmt;
         int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
         if(rc != SQLITE_OK){
             std::cout << "Erro ao preparar a query SQL: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
-        while((rc = sqlite3_step(stmt)) == SQLITE_ROW){
-            if(sqlite3_column_type(stmt, 0) != SQLITE_NULL && sqlite3_column_type(stmt, 1) != SQLITE_NULL){
-                std::string email1 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-                std::string email2 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-                sm.follow(email1, email2);
-            }
-        }
+        sqlite3_bind_text(stmt, 1, src.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, dest.c_str(), -1, SQLITE_STATIC);
+        rc = sqlite3_step(stmt);
         if(rc != SQLITE_DONE){
             std::cout << "Erro ao executar a query SQL: " << sqlite3_errmsg(db) << std::endl;
             sqlite3_finalize(stmt);
@@ -267,6 +397,41 @@ namespace database{
         return true;
     }
 
+    /**
+     * @namespace database
+     * @class Database
+     * @name load_links()
+     * @brief Load all the links between users in the database to each user that the link belongs.
+     *        The rowid ranges of the table are read concurrently and the adjacency lists are
+     *        built in bulk (Network::insert_links) with the link attributes (creation time
+     *        and weight), keeping the rowid order of the links.
+     * @attention This member function is called by the overloaded constructor or the dbinit
+     *            member function in the database class.
+     * @param sm --> SocialMedia object
+     * @return bool --> true: Links successfully loaded, false: Error loading links
+    */
+    bool database::Database::load_links(socialmedia::SocialMedia& sm){
+        std::vector<std::vector<std::string>> rows;
+        if(!scan("SELECT user1, user2, created, weight FROM connections WHERE rowid BETWEEN ? AND ? ORDER BY rowid;",
+                 4, split("connections", network::workers()), rows))
+            return false;
+        std::vector<std::pair<std::string, std::string>> pairs;
+        std::vector<network::Network::link_t> attrs;
+        size_t total = 0;
+        for(const auto &r : rows) total += r.size() / 4;
+        pairs.reserve(total);
+        attrs.reserve(total);
+        for(auto &r : rows){
+            for(size_t i = 0; i < r.size(); i += 4){
+                pairs.emplace_back(std::move(r[i]), std::move(r[i + 1]));
+                attrs.push_back({static_cast<unsigned int>(std::stoll(r[i + 2])), std::stof(r[i + 3])});
+            }
+            std::vector<std::string>().swap(r);
+        }
+        sm.insert_links(pairs, attrs);
+        return true;
+    }
+
     /**
      * @namespace database
      * @class Database
@@ -280,6 +445,7 @@ namespace database{
     bool database::Database::drop_user(const std::string &s){
         std::string query_users = "DELETE FROM users WHERE email = ?";
         std::string query_links = "DELETE FROM connections WHERE user1 = ? OR user2 = ?";
+        std::string query_posts = "DELETE FROM posts WHERE author = ?";
         sqlite3_stmt* stmt;
         int rc = sqlite3_prepare_v2(db, query_users.c_str(), -1, &stmt, nullptr);
         if(rc != SQLITE_OK){
@@ -323,6 +489,19 @@ namespace database{
             return false;
         }
         sqlite3_finalize(stmt);
+        rc = sqlite3_prepare_v2(db, query_posts.c_str(), -1, &stmt, nullptr);
+        if(rc != SQLITE_OK){
+            std::cout << "Erro ao preparar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        sqlite3_bind_text(stmt, 1, s.c_str(), -1, SQLITE_STATIC);
+        rc = sqlite3_step(stmt);
+        if(rc != SQLITE_DONE){
+            std::cout << "Erro ao executar a query_posts: " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_finalize(stmt);
+            return false;
+        }
+        sqlite3_finalize(stmt);
         return true;
     }
 
@@ -349,7 +528,7 @@ namespace database{
             sqlite3_finalize(stmt);
             return false;
         }
-        rc = sqlite3_bind_text(stmt, 1, dest.c_str(), -1, SQLITE_STATIC);
+        rc = sqlite3_bind_text(stmt, 2, dest.c_str(), -1, SQLITE_STATIC);
         if(rc != SQLITE_OK){
             std::cout << "Erro ao bindar o valor user2: " << sqlite3_errmsg(db) << std::endl;
             sqlite3_finalize(stmt);
@@ -369,4 +548,174 @@ namespace database{
         }
     }
 
+    /**
+     * @namespace database
+     * @class Database
+     * @name save_post()
+     * @brief Save a post in the database
+     * @attention This member function is called in SocialMedia class everytime that a user
+     *            publishes a post.
+     * @param id --> unsigned long: Post id
+     * @param author --> const std::string: Author email
+     * @param time --> long long: Publication time (Unix time)
+     * @param text --> const std::string: Post content
+     * @return bool --> true: Post successfully saved, false: Error saving the post
+    */
+    bool database::Database::save_post(unsigned long id, const std::string &author, long long time,
+                                       const std::string &text)
+    {
+        std::string query = "INSERT INTO posts (id, author, created, body) VALUES (?, ?, ?, ?);";
+        sqlite3_stmt* stmt;
+        int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
+        if(rc != SQLITE_OK){
+            std::cout << "Erro ao preparar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        sqlite3_bind_int64(stmt, 1, (sqlite3_int64)id);
+        sqlite3_bind_text(stmt, 2, author.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 3, time);
+        sqlite3_bind_text(stmt, 4, text.c_str(), -1, SQLITE_STATIC);
+        rc = sqlite3_step(stmt);
+        if(rc != SQLITE_DONE){
+            std::cout << "Erro ao executar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_finalize(stmt);
+            return false;
+        }
+        sqlite3_finalize(stmt);
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class Database
+     * @name load_posts()
+     * @brief Load all the posts (in publication order) and rebuild the home timelines
+     * @attention This member function is called by the overloaded constructor or the dbinit
+     *            member function in the database class, after the links are loaded.
+     * @param sm --> SocialMedia object
+     * @return bool --> true: Posts successfully loaded, false: Error loading posts
+    */
+    bool database::Database::load_posts(socialmedia::SocialMedia &sm){
+        std::string query = "SELECT id, author, created, body FROM posts ORDER BY id;";
+        sqlite3_stmt* stmt;
+        int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
+        if(rc != SQLITE_OK){
+            std::cout << "Erro ao preparar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        while((rc = sqlite3_step(stmt)) == SQLITE_ROW){
+            if(sqlite3_column_type(stmt, 1) != SQLITE_NULL && sqlite3_column_type(stmt, 3) != SQLITE_NULL){
+                unsigned long id = sqlite3_column_int64(stmt, 0);
+                std::string author = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+                long long time = sqlite3_column_int64(stmt, 2);
+                std::string text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+                sm.publish(author, text, time, id);
+            }
+        }
+        if(rc != SQLITE_DONE){
+            std::cout << "Erro ao executar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_finalize(stmt);
+            return false;
+        }
+        sqlite3_finalize(stmt);
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class Database
+     * @name save_distance_index()
+     * @brief Persist the serialized distance index (a single row, replaced on every save)
+     * @param data --> const std::string: Serialized index (empty: delete the stored index)
+     * @param fingerprint --> unsigned long: Fingerprint of the graph the index was built for
+     * @return bool --> true: Index successfully saved, false: Error saving the index
+    */
+    bool database::Database::save_distance_index(const std::string &data, unsigned long fingerprint){
+        std::string query = data.empty() ? "DELETE FROM distance_index;"
+                                         : "INSERT OR REPLACE INTO distance_index (id, fingerprint, data) VALUES (0, ?, ?);";
+        sqlite3_stmt* stmt;
+        int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
+        if(rc != SQLITE_OK){
+            std::cout << "Erro ao preparar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        if(!data.empty()){
+            sqlite3_bind_int64(stmt, 1, (sqlite3_int64)fingerprint);
+            sqlite3_bind_blob(stmt, 2, data.data(), data.size(), SQLITE_STATIC);
+        }
+        rc = sqlite3_step(stmt);
+        if(rc != SQLITE_DONE){
+            std::cout << "Erro ao executar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_finalize(stmt);
+            return false;
+        }
+        sqlite3_finalize(stmt);
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class Database
+     * @name load_distance_index()
+     * @brief Read the persisted distance index (if any)
+     * @param data --> std::string: Receives the serialized index
+     * @param fingerprint --> unsigned long: Receives the fingerprint stored with the index
+     * @return bool --> true: Index found, false: No index stored or error reading it
+    */
+    bool database::Database::load_distance_index(std::string &data, unsigned long &fingerprint){
+        std::string query = "SELECT fingerprint, data FROM distance_index WHERE id = 0;";
+        sqlite3_stmt* stmt;
+        int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
+        if(rc != SQLITE_OK){
+            std::cout << "Erro ao preparar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        rc = sqlite3_step(stmt);
+        if(rc != SQLITE_ROW){
+            sqlite3_finalize(stmt);
+            return false;
+        }
+        fingerprint = (unsigned long)sqlite3_column_int64(stmt, 0);
+        const char *blob = reinterpret_cast<const char*>(sqlite3_column_blob(stmt, 1));
+        data.assign(blob ? blob : "", sqlite3_column_bytes(stmt, 1));
+        sqlite3_finalize(stmt);
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class Database
+     * @name begin()
+     * @brief Start a transaction: the following writes are committed together (a single
+     *        journal sync for a batch of users/links instead of one per statement)
+     * @return bool --> true: Transaction started, false: Error (the writes run one by one)
+    */
+    bool database::Database::begin(){
+        char* err;
+        if(sqlite3_exec(db, "BEGIN;", nullptr, nullptr, &err) != SQLITE_OK){
+            std::cout << "Erro ao iniciar a transação: " << err << std::endl;
+            sqlite3_free(err);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class Database
+     * @name commit()
+     * @brief Commit the transaction started by begin()
+     * @return bool --> true: Writes committed, false: Error (the transaction is rolled back)
+    */
+    bool database::Database::commit(){
+        char* err;
+        if(sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &err) != SQLITE_OK){
+            std::cout << "Erro ao finalizar a transação: " << err << std::endl;
+            sqlite3_free(err);
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+        return true;
+    }
+
 } // namespace database
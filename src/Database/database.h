@@ -14,31 +14,51 @@
 #define DATABASE_H
 
 #include <string>
+#include <vector>
 #include <sqlite3.h>
 #include "../SocialMedia/socialmedia.h"
+#include "../Storage/storage.h"
 
 namespace database{
 
-class Database{
+class Database : public storage::Storage{
 public:
     Database();
-    Database(socialmedia::SocialMedia &sm);
+    Database(socialmedia::SocialMedia &sm, const std::string &dbname = "src/Database/graphsocial.db");
+    explicit Database(const std::string &dbname);
     virtual ~Database();
-    bool dbinit(socialmedia::SocialMedia &sm);
-    bool drop_user(const std::string &s);
+    bool dbinit(socialmedia::SocialMedia &sm, const std::string &dbname = "src/Database/graphsocial.db");
+    bool drop_user(const std::string &s) override;
     bool save_user(const std::string &mail, const std::string &nme,
                    const std::string &brth, const std::string &phne,
-                   const std::string &cty);
-    bool save_link(const std::string &src, const std::string &dest);
+                   const std::string &cty) override;
+    bool save_link(const std::string &src, const std::string &dest, long long time, double weight) override;
+    bool drop_link(const std::string &src, const std::string &dest) override;
+    bool save_post(unsigned long id, const std::string &author, long long time, const std::string &text) override;
+    bool save_distance_index(const std::string &data, unsigned long fingerprint) override;
+    bool load_distance_index(std::string &data, unsigned long &fingerprint) override;
+    bool begin() override;
+    bool commit() override;
+    sqlite3* connection() const { return db; } // Inline
     Database(const Database&) = delete;                 
     Database& operator=(const Database&) = delete;
 
 private:
+    struct range_t{
+        long long first;   // Rowid range (inclusive)
+        long long last;
+    };
+
     sqlite3* db;
+    std::vector<range_t> split(const std::string &table, unsigned int parts);
+    bool scan(const std::string &query, size_t columns, const std::vector<range_t> &parts,
+              std::vector<std::vector<std::string>> &rows);
     bool load_users(socialmedia::SocialMedia &sm);
     bool close_database();
     bool load_links(socialmedia::SocialMedia &sm);
+    bool load_posts(socialmedia::SocialMedia &sm);
     bool create_table();
+    bool migrate();
     bool open_database(const std::string &dbname);
     bool search_link(const std::string &src, const std::string &dest);
 };
@@ -0,0 +1,535 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file paged.cpp (.cpp file) (implementation file)
+ *
+ * PagedGraph class members/member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include <ctime>
+#include <sstream>
+#include <unordered_set>
+#include "paged.h"
+
+namespace database{
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @brief Class constructor. Open the database (nothing is loaded) and prepare the
+     *        read queries.
+     * @param dbname --> const std::string: Database file
+     * @param budget --> size_t: Memory budget of the cache (bytes)
+    */
+    database::PagedGraph::PagedGraph(const std::string &dbname, size_t budget)
+        : store(dbname), db(store.connection()), limit(budget)
+    {
+        std::string batch = "SELECT user1, user2 FROM connections WHERE user1 IN (?";
+        for(unsigned int i = 1; i < READAHEAD; i++) batch += ", ?";
+        batch += ");";
+        if(sqlite3_prepare_v2(db, "SELECT name, birthdate, phone, city FROM users WHERE email = ?;", -1, &user_stmt, nullptr) != SQLITE_OK ||
+           sqlite3_prepare_v2(db, "SELECT user2 FROM connections WHERE user1 = ?;", -1, &links_stmt, nullptr) != SQLITE_OK ||
+           sqlite3_prepare_v2(db, batch.c_str(), -1, &batch_stmt, nullptr) != SQLITE_OK ||
+           sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM connections WHERE user2 = ?;", -1, &indegree_stmt, nullptr) != SQLITE_OK)
+            std::cout << "Erro ao preparar a query SQL: " << sqlite3_errmsg(db) << std::endl;
+    }
+
+    /// @brief Class destructor --> Release the prepared queries (the database is closed by store)
+    database::PagedGraph::~PagedGraph(){
+        sqlite3_finalize(user_stmt);
+        sqlite3_finalize(links_stmt);
+        sqlite3_finalize(batch_stmt);
+        sqlite3_finalize(indegree_stmt);
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name footprint()
+     * @brief Approximate memory of a cache entry (hash node, strings and links)
+     * @return size_t --> Bytes
+    */
+    size_t database::PagedGraph::footprint(const std::string &key, const entry &e){
+        auto heap = [](const std::string &s){ return s.capacity() > 15 ? s.capacity() + 1 : 0; };
+        size_t ans = sizeof(table_t::value_type) + 2 * sizeof(void*) + sizeof(void*) + heap(key);
+        ans += heap(e.user.email) + heap(e.user.name) + heap(e.user.birthdate) + heap(e.user.phone) + heap(e.user.city);
+        ans += e.out.capacity() * sizeof(std::string);
+        for(const auto &l : e.out) ans += heap(l);
+        return ans;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name slot_for()
+     * @brief Get the cache entry of a user, creating an empty one in a clock slot
+     * @param s --> const std::string: User email
+     * @return entry& --> Cache entry
+    */
+    database::PagedGraph::entry& database::PagedGraph::slot_for(const std::string &s){
+        auto ins = table.try_emplace(s);
+        entry &e = ins.first->second;
+        if(ins.second){
+            if(free_slots.empty()){
+                e.slot = ring.size();
+                ring.push_back(&*ins.first);
+            }
+            else{
+                e.slot = free_slots.back();
+                free_slots.pop_back();
+                ring[e.slot] = &*ins.first;
+            }
+        }
+        return e;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name account()
+     * @brief Update the memory of an entry that changed and evict other entries while
+     *        the cache is over budget
+     * @param e --> entry: Changed entry (never evicted here)
+     * @param pinned --> const table_t::value_type*: The table node of e
+    */
+    void database::PagedGraph::account(entry &e, const table_t::value_type *pinned){
+        used -= e.bytes;
+        e.bytes = footprint(pinned->first, e);
+        used += e.bytes;
+        e.ref = true;
+        while(used > limit && table.size() > 1) evict(pinned);
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name evict()
+     * @brief CLOCK eviction: advance the hand clearing reference bits until an entry
+     *        that wasn't used since the last pass is found, and drop it
+     * @param pinned --> const table_t::value_type*: Entry that must stay
+    */
+    void database::PagedGraph::evict(const table_t::value_type *pinned){
+        while(true){
+            if(hand >= ring.size()) hand = 0;
+            auto kv = ring[hand];
+            if(kv && kv != pinned){
+                if(kv->second.ref) kv->second.ref = false;
+                else{
+                    used -= kv->second.bytes;
+                    ring[hand] = nullptr;
+                    free_slots.push_back(hand++);
+                    table.erase(kv->first);
+                    counters.evictions++;
+                    return;
+                }
+            }
+            hand++;
+        }
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name load_user()
+     * @brief Get the entry of a user with the user data, reading it when it isn't cached
+     * @param s --> const std::string: User email
+     * @return entry* --> Entry (exists = false if the user isn't in the database)
+    */
+    database::PagedGraph::entry* database::PagedGraph::load_user(const std::string &s){
+        auto it = table.find(s);
+        if(it != table.end() && it->second.has_user){
+            counters.hits++;
+            it->second.ref = true;
+            return &it->second;
+        }
+        counters.misses++;
+        entry &e = slot_for(s);
+        sqlite3_reset(user_stmt);
+        sqlite3_bind_text(user_stmt, 1, s.c_str(), -1, SQLITE_TRANSIENT);
+        e.has_user = true;
+        e.exists = sqlite3_step(user_stmt) == SQLITE_ROW;
+        if(e.exists){
+            auto col = [this](int i){
+                auto txt = sqlite3_column_text(user_stmt, i);
+                return txt ? std::string(reinterpret_cast<const char*>(txt)) : std::string();
+            };
+            e.user = {s, col(0), col(1), col(2), col(3)};
+        }
+        else{
+            e.has_out = true;
+            e.out.clear();
+            e.has_followers = true;
+            e.followers = 0;
+        }
+        account(e, &*table.find(s));
+        return &e;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name load_links()
+     * @brief Get the entry of a user with the followed users, reading them when they
+     *        aren't cached (the user data isn't needed by the searches, so it isn't read)
+     * @param s --> const std::string: User email
+     * @return entry* --> Entry, valid until the next call that may evict
+    */
+    database::PagedGraph::entry* database::PagedGraph::load_links(const std::string &s){
+        auto it = table.find(s);
+        if(it != table.end() && it->second.has_out){
+            counters.hits++;
+            it->second.ref = true;
+            return &it->second;
+        }
+        counters.misses++;
+        entry &e = slot_for(s);
+        e.out.clear();
+        sqlite3_reset(links_stmt);
+        sqlite3_bind_text(links_stmt, 1, s.c_str(), -1, SQLITE_TRANSIENT);
+        while(sqlite3_step(links_stmt) == SQLITE_ROW)
+            e.out.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(links_stmt, 0)));
+        e.has_out = true;
+        account(e, &*table.find(s));
+        return &e;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name prefetch()
+     * @brief Readahead: read the links of the listed users that aren't cached with one
+     *        query per READAHEAD users. Stops after half of the budget, so a large level
+     *        doesn't evict its own read ahead entries before they are expanded. Read ahead
+     *        entries get a reference bit like demand loads, so the clock hand gives them a
+     *        full pass before they can be evicted.
+     * @param users --> const std::vector<std::string>: Users about to be expanded
+    */
+    void database::PagedGraph::prefetch(const std::vector<std::string> &users){
+        size_t read = 0;
+        std::vector<const std::string*> missing;
+        for(const auto &u : users){
+            auto it = table.find(u);
+            if(it == table.end() || !it->second.has_out) missing.push_back(&u);
+        }
+        std::unordered_map<std::string, std::vector<std::string>> found;
+        for(size_t begin = 0; begin < missing.size() && read < limit / 2; begin += READAHEAD){
+            size_t end = std::min(missing.size(), begin + READAHEAD);
+            sqlite3_reset(batch_stmt);
+            sqlite3_clear_bindings(batch_stmt);   // Unused slots stay NULL (match nothing)
+            for(size_t i = begin; i < end; i++)
+                sqlite3_bind_text(batch_stmt, i - begin + 1, missing[i]->c_str(), -1, SQLITE_STATIC);
+            found.clear();
+            while(sqlite3_step(batch_stmt) == SQLITE_ROW)
+                found[reinterpret_cast<const char*>(sqlite3_column_text(batch_stmt, 0))]
+                    .emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(batch_stmt, 1)));
+            for(size_t i = begin; i < end; i++){
+                entry &e = slot_for(*missing[i]);
+                auto it = found.find(*missing[i]);
+                if(it != found.end()) e.out = std::move(it->second);
+                else e.out.clear();
+                e.has_out = true;
+                account(e, &*table.find(*missing[i]));
+                read += e.bytes;
+                counters.prefetched++;
+            }
+        }
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name find()
+     * @brief Search for a user by email, faulting it in from the database
+     * @param s --> const std::string: Email to be searched
+     * @return const user_t* --> User data (valid until the next call), nullptr if it doesn't exist
+    */
+    const database::PagedGraph::user_t* database::PagedGraph::find(const std::string &s){
+        entry *e = load_user(s);
+        return e->exists ? &e->user : nullptr;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name links()
+     * @brief Users followed by a user, faulted in from the database
+     * @param s --> const std::string: User email
+     * @return const std::vector<std::string>* --> Followed users (valid until the next call),
+     *                                            nullptr if the user doesn't exist
+    */
+    const std::vector<std::string>* database::PagedGraph::links(const std::string &s){
+        if(!find(s)) return nullptr;
+        return &load_links(s)->out;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name indegree()
+     * @brief Number of followers of a user
+     * @param s --> const std::string: User email
+     * @return unsigned int --> Followers (0 if the user doesn't exist)
+    */
+    unsigned int database::PagedGraph::indegree(const std::string &s){
+        if(!find(s)) return 0;
+        entry &e = table.find(s)->second;
+        if(e.has_followers){
+            counters.hits++;
+            return e.followers;
+        }
+        counters.misses++;
+        sqlite3_reset(indegree_stmt);
+        sqlite3_bind_text(indegree_stmt, 1, s.c_str(), -1, SQLITE_TRANSIENT);
+        e.followers = sqlite3_step(indegree_stmt) == SQLITE_ROW ? sqlite3_column_int(indegree_stmt, 0) : 0;
+        e.has_followers = true;
+        return e.followers;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name insert_node()
+     * @brief Save a new user in the database and in the cache
+     * @return bool --> true: User created, false: Email already used / database error
+    */
+    bool database::PagedGraph::insert_node(const std::string &mail, const std::string &nm, const std::string &brth,
+                                           const std::string &phne, const std::string &cty)
+    {
+        if(find(mail) || !store.save_user(mail, nm, brth, phne, cty)) return false;
+        entry &e = slot_for(mail);
+        e.user = {mail, nm, brth, phne, cty};
+        e.exists = e.has_user = e.has_out = e.has_followers = true;
+        e.out.clear();
+        e.followers = 0;
+        account(e, &*table.find(mail));
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name follow()
+     * @brief Save a link in the database and patch the cached entries
+     * @return bool --> true: Link created, false: Missing user / already following
+    */
+    bool database::PagedGraph::follow(const std::string &src, const std::string &dest){
+        if(!find(src) || !find(dest)) return false;
+        entry *e = load_links(src);
+        if(std::find(e->out.begin(), e->out.end(), dest) != e->out.end()) return false;
+        if(!store.save_link(src, dest, std::time(nullptr), 1)) return false;
+        e->out.push_back(dest);
+        account(*e, &*table.find(src));
+        auto it = table.find(dest);
+        if(it != table.end() && it->second.has_followers) it->second.followers++;
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name unfollow()
+     * @brief Delete a link in the database and patch the cached entries
+     * @return bool --> true: Link deleted, false: Missing user / not following
+    */
+    bool database::PagedGraph::unfollow(const std::string &src, const std::string &dest){
+        if(!find(src) || !find(dest)) return false;
+        entry *e = load_links(src);
+        auto pos = std::find(e->out.begin(), e->out.end(), dest);
+        if(pos == e->out.end() || !store.drop_link(src, dest)) return false;
+        e->out.erase(pos);
+        account(*e, &*table.find(src));
+        auto it = table.find(dest);
+        if(it != table.end() && it->second.has_followers) it->second.followers--;
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name remove()
+     * @brief Delete a user (and the user links) from the database and from the cache
+     * @return bool --> true: User deleted, false: Missing user / database error
+    */
+    bool database::PagedGraph::remove(const std::string &s){
+        if(!find(s)) return false;
+        std::vector<std::string> followed = load_links(s)->out;
+        if(!store.drop_user(s)) return false;
+        auto it = table.find(s);
+        used -= it->second.bytes;
+        ring[it->second.slot] = nullptr;
+        free_slots.push_back(it->second.slot);
+        table.erase(it);
+        for(const auto &f : followed){
+            auto jt = table.find(f);
+            if(jt != table.end() && jt->second.has_followers) jt->second.followers--;
+        }
+        for(auto &kv : table){
+            auto &out = kv.second.out;
+            auto pos = std::find(out.begin(), out.end(), s);
+            if(pos == out.end()) continue;
+            out.erase(pos);
+            used -= kv.second.bytes;   // Only shrinks: no eviction needed
+            kv.second.bytes = footprint(kv.first, kv.second);
+            used += kv.second.bytes;
+        }
+        return true;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name shortest_path()
+     * @brief Level synchronous breadth-first search; the links of every level are read
+     *        ahead before it is expanded
+     * @param src --> const std::string: First user (Source)
+     * @param dest --> const std::string: Second user (Destination)
+     * @param path --> std::vector<std::string>*: Receives the path (src first), may be nullptr
+     * @return int --> Size of the path, 0 if src == dest, -1 if there is no path
+    */
+    int database::PagedGraph::shortest_path(const std::string &src, const std::string &dest,
+                                            std::vector<std::string> *path)
+    {
+        if(!find(src) || !find(dest)) return -1;
+        if(src == dest){
+            if(path) *path = {src};
+            return 0;
+        }
+        std::unordered_map<std::string, std::string> parent = {{src, src}};
+        std::vector<std::string> frontier = {src}, next;
+        for(int d = 1; !frontier.empty(); d++){
+            prefetch(frontier);
+            next.clear();
+            for(const auto &u : frontier){
+                for(const auto &w : load_links(u)->out){
+                    if(!parent.emplace(w, u).second) continue;
+                    if(w == dest){
+                        if(path){
+                            path->clear();
+                            for(std::string v = dest; v != src; v = parent[v]) path->push_back(v);
+                            path->push_back(src);
+                            std::reverse(path->begin(), path->end());
+                        }
+                        return d;
+                    }
+                    next.push_back(w);
+                }
+            }
+            frontier.swap(next);
+        }
+        return -1;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name khop_count()
+     * @brief Number of users reached in at most k steps (the user isn't counted)
+     * @param s --> const std::string: User email
+     * @param k --> unsigned int: Maximum number of steps
+     * @return size_t --> Users reached
+    */
+    size_t database::PagedGraph::khop_count(const std::string &s, unsigned int k){
+        if(!find(s)) return 0;
+        std::unordered_set<std::string> seen = {s};
+        std::vector<std::string> frontier = {s}, next;
+        for(unsigned int d = 0; d < k && !frontier.empty(); d++){
+            prefetch(frontier);
+            next.clear();
+            for(const auto &u : frontier)
+                for(const auto &w : load_links(u)->out)
+                    if(seen.insert(w).second) next.push_back(w);
+            frontier.swap(next);
+        }
+        return seen.size() - 1;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name size()
+     * @brief Number of users in the database
+     * @return size_t --> Users
+    */
+    size_t database::PagedGraph::size(){
+        sqlite3_stmt *stmt;
+        size_t ans = 0;
+        if(sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM users;", -1, &stmt, nullptr) != SQLITE_OK) return 0;
+        if(sqlite3_step(stmt) == SQLITE_ROW) ans = sqlite3_column_int64(stmt, 0);
+        sqlite3_finalize(stmt);
+        return ans;
+    }
+
+    /**
+     * @namespace database
+     * @class PagedGraph
+     * @name console()
+     * @brief Line oriented front end of the out-of-core mode (same commands as the
+     *        partitioned mode, plus "consultar" and "cache")
+     * @param in --> std::istream: Commands
+     * @param out --> std::ostream: Results
+    */
+    void database::PagedGraph::console(std::istream &in, std::ostream &out){
+        std::string line;
+        while(std::getline(in, line)){
+            std::istringstream cmd(line);
+            std::string op, a, b;
+            cmd >> op;
+            if(op.empty()) continue;
+            if(op == "sair") return;
+            if(op == "usuario"){
+                std::string nm, brth, phne, cty;
+                cmd >> a >> nm >> brth >> phne >> cty;
+                out << (insert_node(a, nm, brth, phne, cty) ? "Usuário cadastrado com sucesso!"
+                        : "O email informado já está sendo usado por outro usuário!") << std::endl;
+            } else if(op == "seguir"){
+                cmd >> a >> b;
+                if(follow(a, b)) out << "Usuario: " << a << " começou a seguir: " << b << std::endl;
+                else out << "Não foi possível seguir: usuário inexistente ou já seguido!" << std::endl;
+            } else if(op == "deixar"){
+                cmd >> a >> b;
+                out << (unfollow(a, b) ? "Operação realizada com sucesso!" : "O usuário: " + a + " não segue: " + b + "!") << std::endl;
+            } else if(op == "remover"){
+                cmd >> a;
+                out << (remove(a) ? "Usuário excluido com sucesso!" : "O usuário não existe!") << std::endl;
+            } else if(op == "consultar"){
+                cmd >> a;
+                const user_t *u = find(a);
+                if(!u){
+                    out << "O usuário não existe!" << std::endl;
+                    continue;
+                }
+                out << "Email: " << u->email << std::endl;
+                out << "Nome: " << u->name << std::endl;
+                out << "Data de nascimento: " << u->birthdate << std::endl;
+                out << "Número de telefone: " << u->phone << std::endl;
+                out << "Cidade: " << u->city << std::endl;
+                out << "Seguindo: " << links(a)->size() << std::endl;
+                out << "Seguidores: " << indegree(a) << std::endl;
+            } else if(op == "caminho"){
+                cmd >> a >> b;
+                std::vector<std::string> path;
+                int d = shortest_path(a, b, &path);
+                if(d <= 0){
+                    out << "Não existe caminho possível!" << std::endl;
+                    continue;
+                }
+                out << "Menor caminho de " << a << " para " << b << ": ";
+                for(size_t i = 0; i < path.size(); i++) out << path[i] << (i + 1 < path.size() ? " -> " : "");
+                out << std::endl << "Tamanho do caminho: " << d << std::endl;
+            } else if(op == "alcance"){
+                unsigned int k = 0;
+                cmd >> a >> k;
+                out << "Usuários alcançados em até " << k << " passos: " << khop_count(a, k) << std::endl;
+            } else if(op == "tamanho") out << "Quantidade de usuários cadastrados: " << size() << std::endl;
+            else if(op == "cache"){
+                out << "Cache: " << entries() << " entradas, " << bytes() << " de " << budget() << " bytes" << std::endl;
+                out << "Acertos: " << counters.hits << ", faltas: " << counters.misses
+                    << ", taxa de acerto: " << 100 * counters.hit_rate() << "%" << std::endl;
+                out << "Lidos antecipadamente: " << counters.prefetched << ", removidos: " << counters.evictions << std::endl;
+            }
+            else out << "Opção inválida, por favor insira novamente!" << std::endl;
+        }
+    }
+
+} // namespace database
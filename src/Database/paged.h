@@ -0,0 +1,108 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile paged.h (header file)
+ *
+ * PagedGraph class interface/structure
+ * Out-of-core mode: users and their links stay in the database and are faulted in on
+ * demand. Loaded entries are held in a CLOCK cache bounded by a memory budget; the
+ * breadth-first searches read ahead the links of the whole next frontier in batched
+ * queries. Mutations are written through to the database and patched in the cache.
+ * Include guard
+ *
+*/
+
+#ifndef PAGED_H
+#define PAGED_H
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sqlite3.h>
+#include "database.h"
+
+namespace database{
+
+class PagedGraph{
+public:
+    struct user_t{
+        std::string email;
+        std::string name;
+        std::string birthdate;
+        std::string phone;
+        std::string city;
+    };
+
+    struct stats_t{
+        unsigned long hits = 0;
+        unsigned long misses = 0;        // Entries read from the database on demand
+        unsigned long prefetched = 0;    // Entries read ahead by the searches
+        unsigned long evictions = 0;
+        double hit_rate() const { return hits + misses ? (double)hits / (hits + misses) : 0; } // Inline
+    };
+
+    static constexpr unsigned int READAHEAD = 64;   // Users per batched links query
+    static constexpr size_t MAX_BUDGET_MB = 1 << 20; // Largest cache budget accepted (1 TB)
+
+    PagedGraph(const std::string &dbname, size_t budget);
+    ~PagedGraph();
+    const user_t* find(const std::string &s);
+    const std::vector<std::string>* links(const std::string &s);
+    unsigned int indegree(const std::string &s);
+    bool insert_node(const std::string &mail, const std::string &nm, const std::string &brth,
+                     const std::string &phne, const std::string &cty);
+    bool follow(const std::string &src, const std::string &dest);
+    bool unfollow(const std::string &src, const std::string &dest);
+    bool remove(const std::string &s);
+    int shortest_path(const std::string &src, const std::string &dest, std::vector<std::string> *path);
+    size_t khop_count(const std::string &s, unsigned int k);
+    size_t size();
+    const stats_t& stats() const { return counters; } // Inline
+    size_t bytes() const { return used; } // Inline
+    size_t entries() const { return table.size(); } // Inline
+    size_t budget() const { return limit; } // Inline
+    void console(std::istream &in, std::ostream &out);
+    PagedGraph(const PagedGraph&) = delete;
+    PagedGraph& operator=(const PagedGraph&) = delete;
+
+private:
+    struct entry{
+        user_t user;
+        bool has_user = false;
+        bool exists = false;
+        std::vector<std::string> out;
+        bool has_out = false;
+        unsigned int followers = 0;
+        bool has_followers = false;
+        size_t bytes = 0;
+        size_t slot = 0;       // Position in the clock ring
+        bool ref = true;       // Clock reference bit
+    };
+    using table_t = std::unordered_map<std::string, entry>;
+
+    Database store;
+    sqlite3 *db;
+    sqlite3_stmt *user_stmt = nullptr;
+    sqlite3_stmt *links_stmt = nullptr;
+    sqlite3_stmt *batch_stmt = nullptr;
+    sqlite3_stmt *indegree_stmt = nullptr;
+    table_t table;
+    std::vector<table_t::value_type*> ring;   // Clock slots (nullptr: free)
+    std::vector<size_t> free_slots;
+    size_t hand = 0;
+    size_t limit;
+    size_t used = 0;
+    stats_t counters;
+
+    entry& slot_for(const std::string &s);
+    void account(entry &e, const table_t::value_type *pinned);
+    void evict(const table_t::value_type *pinned);
+    entry* load_user(const std::string &s);
+    entry* load_links(const std::string &s);
+    void prefetch(const std::vector<std::string> &users);
+    static size_t footprint(const std::string &key, const entry &e);
+};
+
+} // namespace database
+
+#endif // PAGED_H
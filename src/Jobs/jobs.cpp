@@ -0,0 +1,138 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file jobs.cpp (.cpp file) (implementation file)
+ *
+ * Control and Scheduler classes members/member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include "jobs.h"
+
+namespace jobs{
+
+    /// @brief The job time budget is over
+    bool jobs::Control::expired() const{
+        return deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline;
+    }
+
+    /// @brief The job must stop (cancelled or out of time) and return its partial result
+    bool jobs::Control::stopped() const{
+        return cancel_flag || expired();
+    }
+
+    /// @brief Fraction of the work done, in [0, 1] (0 until the job sets its total)
+    double jobs::Control::progress() const{
+        size_t t = work_total;
+        return t ? std::min(1.0, (double)work_done / t) : 0;
+    }
+
+    /// @brief Class constructor
+    /// @param threads --> unsigned int: Worker threads (at least 1), started on the first submit
+    jobs::Scheduler::Scheduler(unsigned int threads) : nthreads(threads ? threads : 1){}
+
+    /// @brief Class destructor --> Cancel the queued/running jobs and wait for the workers
+    jobs::Scheduler::~Scheduler(){
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            quit = true;
+            for(auto &t : tasks) t->control.cancel();
+        }
+        wake.notify_all();
+        for(auto &w : workers) w.join();
+    }
+
+    /**
+     * @namespace jobs
+     * @class Scheduler
+     * @name enqueue()
+     * @brief Register a job and queue it for the workers
+     * @param t --> std::shared_ptr<task>: Job state
+    */
+    void jobs::Scheduler::enqueue(std::shared_ptr<task> t){
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            t->id = ++last_id;
+            pending.push_back(t);
+            tasks.push_back(t);
+            size_t ended = 0;
+            for(const auto &x : tasks) ended += x->finished();
+            for(auto it = tasks.begin(); ended > HISTORY && it != tasks.end();){
+                if((*it)->finished()){
+                    it = tasks.erase(it);
+                    ended--;
+                } else ++it;
+            }
+            while(workers.size() < nthreads) workers.emplace_back(&Scheduler::work, this);
+        }
+        wake.notify_one();
+    }
+
+    /**
+     * @namespace jobs
+     * @class Scheduler
+     * @name work()
+     * @brief Worker loop: run the queued jobs one at a time. A job cancelled before it
+     *        starts still runs its body, which returns at once with an empty result.
+    */
+    void jobs::Scheduler::work(){
+        while(true){
+            std::shared_ptr<task> t;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [this]{ return quit || !pending.empty(); });
+                if(pending.empty()) return;
+                t = pending.front();
+                pending.pop_front();
+            }
+            t->start = std::chrono::steady_clock::now();
+            t->status = RUNNING;
+            t->body(t->control);
+            t->body = nullptr;
+            t->elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t->start).count();
+            {
+                std::lock_guard<std::mutex> guard(t->lock);
+                t->status = t->control.stopped() && t->control.progress() < 1 ? PARTIAL : DONE;
+            }
+            t->ended.notify_all();
+        }
+    }
+
+    /**
+     * @namespace jobs
+     * @class Scheduler
+     * @name list()
+     * @brief Queued, running and recently ended jobs
+     * @return std::vector<info_t> --> Jobs in submission order
+    */
+    std::vector<jobs::Scheduler::info_t> jobs::Scheduler::list() const{
+        std::vector<info_t> ans;
+        std::lock_guard<std::mutex> guard(lock);
+        auto now = std::chrono::steady_clock::now();
+        for(const auto &t : tasks){
+            status_t st = t->status;
+            double elapsed = st == QUEUED ? 0 : st == RUNNING ? std::chrono::duration<double>(now - t->start).count() : t->elapsed.load();
+            ans.push_back({t->id, t->name, st, t->control.progress(), elapsed});
+        }
+        return ans;
+    }
+
+    /**
+     * @namespace jobs
+     * @class Scheduler
+     * @name cancel()
+     * @brief Ask a job to stop (it ends with the partial result computed so far)
+     * @param id --> unsigned long: Job id
+     * @return bool --> true: Job found and still queued/running
+    */
+    bool jobs::Scheduler::cancel(unsigned long id){
+        std::lock_guard<std::mutex> guard(lock);
+        for(auto &t : tasks){
+            if(t->id != id || t->finished()) continue;
+            t->control.cancel();
+            return true;
+        }
+        return false;
+    }
+
+} // namespace jobs
@@ -0,0 +1,148 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile jobs.h (header file)
+ *
+ * Control, Job and Scheduler classes interface/structure
+ * Background analytics: a job runs on the scheduler worker thread(s) and the caller
+ * keeps a handle to poll its progress, wait for it or cancel it. Jobs stop
+ * cooperatively (cancellation or time budget) and keep the partial result computed
+ * until then.
+ * Include guard
+ *
+*/
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace jobs{
+
+enum status_t{
+    QUEUED,
+    RUNNING,
+    DONE,
+    PARTIAL,     // Stopped by the time budget or cancelled: the result is partial
+};
+
+class Control{
+public:
+    bool stopped() const; // Checked by the job between work units
+    bool cancelled() const { return cancel_flag; } // Inline
+    bool expired() const;
+    void cancel() { cancel_flag = true; } // Inline
+    void total(size_t n) { work_total = n; } // Inline
+    void advance(size_t n = 1) { work_done += n; } // Inline
+    double progress() const;
+
+private:
+    std::atomic<bool> cancel_flag{false};
+    std::atomic<size_t> work_done{0};
+    std::atomic<size_t> work_total{0};
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    friend class Scheduler;
+};
+
+struct task{   // Type independent part of a job (shared by the handle and the scheduler)
+    unsigned long id = 0;
+    std::string name;
+    Control control;
+    std::atomic<status_t> status{QUEUED};
+    std::chrono::steady_clock::time_point start;
+    std::atomic<double> elapsed{0};   // Seconds (set when the job ends)
+    std::mutex lock;
+    std::condition_variable ended;
+    std::function<void(Control&)> body;
+    virtual ~task() = default;
+    bool finished() const { return status == DONE || status == PARTIAL; } // Inline
+};
+
+template<typename T>
+class Job{
+public:
+    Job() = default;
+    bool valid() const { return state != nullptr; } // Inline
+    unsigned long id() const { return state->id; } // Inline
+    status_t status() const { return state->status; } // Inline
+    bool finished() const { return state->finished(); } // Inline
+    bool partial() const { return state->status == PARTIAL; } // Inline
+    double progress() const { return state->control.progress(); } // Inline
+    void cancel() { state->control.cancel(); } // Inline
+    bool wait_for(std::chrono::milliseconds timeout) const{ // Inline
+        std::unique_lock<std::mutex> guard(state->lock);
+        return state->ended.wait_for(guard, timeout, [this]{ return state->finished(); });
+    }
+    const T& wait() const{ // Inline (blocks until the job ends)
+        std::unique_lock<std::mutex> guard(state->lock);
+        state->ended.wait(guard, [this]{ return state->finished(); });
+        return *state->value;
+    }
+    const T* result() const { return finished() ? &*state->value : nullptr; } // Inline
+
+private:
+    struct typed : task{
+        std::optional<T> value;
+    };
+    std::shared_ptr<typed> state;
+    friend class Scheduler;
+};
+
+class Scheduler{
+public:
+    struct info_t{
+        unsigned long id;
+        std::string name;
+        status_t status;
+        double progress;
+        double elapsed;   // Seconds
+    };
+
+    static constexpr size_t HISTORY = 16;   // Ended jobs kept for list()
+
+    explicit Scheduler(unsigned int threads = 1);
+    ~Scheduler();
+    template<typename T, typename F>
+    Job<T> submit(const std::string &name, F fn, double budget = 0){ // Inline (fn(Control&) -> T, budget in seconds, 0: none)
+        Job<T> job;
+        job.state = std::make_shared<typename Job<T>::typed>();
+        auto *state = job.state.get();
+        state->name = name;
+        if(budget > 0)
+            state->control.deadline = std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(budget));
+        state->body = [state, fn](Control &control){ state->value.emplace(fn(control)); };
+        enqueue(job.state);
+        return job;
+    }
+    std::vector<info_t> list() const;
+    bool cancel(unsigned long id);
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+private:
+    unsigned int nthreads;
+    std::vector<std::thread> workers;    // Started on the first submit (no threads before a fork)
+    std::deque<std::shared_ptr<task>> pending;
+    std::vector<std::shared_ptr<task>> tasks;   // Queued, running and the last HISTORY ended jobs
+    mutable std::mutex lock;
+    std::condition_variable wake;
+    unsigned long last_id = 0;
+    bool quit = false;
+
+    void enqueue(std::shared_ptr<task> t);
+    void work();
+};
+
+} // namespace jobs
+
+#endif // JOBS_H
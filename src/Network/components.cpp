@@ -0,0 +1,208 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file components.cpp (.cpp file) (implementation file)
+ * 
+ * DisjointSet and Reachability classes member functions implementation
+ * 
+*/
+
+#include <algorithm>
+#include <utility>
+#include "components.h"
+
+namespace network{
+
+    /**
+     * @namespace network
+     * @class DisjointSet
+     * @name add()
+     * @brief Create a new singleton set
+     * @return unsigned int --> Element id
+    */
+    unsigned int network::DisjointSet::add(){
+        parent.push_back(parent.size());
+        sz.push_back(1);
+        nsets++;
+        return parent.size() - 1;
+    }
+
+    /**
+     * @namespace network
+     * @class DisjointSet
+     * @name find()
+     * @brief Get the representative of an element (path halving)
+    */
+    unsigned int network::DisjointSet::find(unsigned int x){
+        while(parent[x] != x){
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    /**
+     * @namespace network
+     * @class DisjointSet
+     * @name unite()
+     * @brief Merge the sets of two elements (union by size)
+     * @return bool --> true: Sets merged, false: Already in the same set
+    */
+    bool network::DisjointSet::unite(unsigned int a, unsigned int b){
+        a = find(a);
+        b = find(b);
+        if(a == b) return false;
+        if(sz[a] < sz[b]) std::swap(a, b);
+        parent[b] = a;
+        sz[a] += sz[b];
+        nsets--;
+        return true;
+    }
+
+    /**
+     * @namespace network
+     * @class DisjointSet
+     * @name clear()
+     * @brief Remove all elements
+    */
+    void network::DisjointSet::clear(){
+        parent.clear();
+        sz.clear();
+        nsets = 0;
+    }
+
+    /**
+     * @namespace network
+     * @class Reachability
+     * @name build()
+     * @brief Find the strongly connected components with an iterative Tarjan pass and build
+     *        the condensed DAG. Tarjan closes components in reverse topological order, so the
+     *        ids are flipped and every DAG edge goes from a lower to a higher component id.
+     *        Small DAGs also get a bitset transitive closure.
+     *        The neighbors of the vertices on the call stack are decoded once into a
+     *        pending stack, so any layout with for_each_out() can be indexed (CSR snapshot
+     *        or compressed topology).
+     * @param g --> const G: Graph layout (CSR or CompressedCSR)
+    */
+    template<class G>
+    void network::Reachability::build(const G &g){
+        const unsigned int UNSET = -1;
+        unsigned int n = g.size();
+        std::vector<unsigned int> index(n, UNSET), low(n, 0);
+        std::vector<bool> onstack(n, false);
+        std::vector<unsigned int> stack;
+        std::vector<unsigned int> pending;                      // Neighbors not yet visited
+        std::vector<std::pair<unsigned int, size_t>> calls;     // (vertex, first of its pending neighbors)
+        comp.assign(n, UNSET);
+        csize.clear();
+        unsigned int counter = 0;
+        auto enter = [&](unsigned int v){
+            index[v] = low[v] = counter++;
+            stack.push_back(v);
+            onstack[v] = true;
+            calls.emplace_back(v, pending.size());
+            g.for_each_out(v, [&pending](unsigned int w){ pending.push_back(w); });
+        };
+        for(unsigned int s = 0; s < n; s++){
+            if(index[s] != UNSET) continue;
+            enter(s);
+            while(!calls.empty()){
+                unsigned int v = calls.back().first;
+                if(pending.size() > calls.back().second){
+                    unsigned int w = pending.back();
+                    pending.pop_back();
+                    if(index[w] == UNSET) enter(w);
+                    else if(onstack[w]) low[v] = std::min(low[v], index[w]);
+                    continue;
+                }
+                calls.pop_back();
+                if(!calls.empty()){
+                    unsigned int p = calls.back().first;
+                    low[p] = std::min(low[p], low[v]);
+                }
+                if(low[v] == index[v]){
+                    unsigned int c = csize.size(), w, count = 0;
+                    do{
+                        w = stack.back();
+                        stack.pop_back();
+                        onstack[w] = false;
+                        comp[w] = c;
+                        count++;
+                    } while(w != v);
+                    csize.push_back(count);
+                }
+            }
+        }
+        unsigned int ncomp = csize.size();
+        for(auto &c : comp) c = ncomp - 1 - c;
+        std::reverse(csize.begin(), csize.end());
+
+        std::vector<std::pair<unsigned int, unsigned int>> edges;
+        for(unsigned int u = 0; u < n; u++)
+            g.for_each_out(u, [&](unsigned int w){
+                if(comp[u] != comp[w]) edges.emplace_back(comp[u], comp[w]);
+            });
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        dag_offsets.assign(ncomp + 1, 0);
+        dag_edges.resize(edges.size());
+        for(size_t i = 0; i < edges.size(); i++){
+            dag_offsets[edges[i].first + 1]++;
+            dag_edges[i] = edges[i].second;
+        }
+        for(unsigned int c = 0; c < ncomp; c++) dag_offsets[c + 1] += dag_offsets[c];
+
+        closure.clear();
+        words = 0;
+        seen.assign(ncomp, 0);
+        stamp = 0;
+        if(ncomp <= CLOSURE_LIMIT){
+            words = (ncomp + 63) / 64;
+            closure.assign((size_t)ncomp * words, 0);
+            for(unsigned int c = ncomp; c-- > 0;){
+                uint64_t *row = closure.data() + (size_t)c * words;
+                row[c / 64] |= 1ull << (c % 64);
+                for(unsigned int i = dag_offsets[c]; i < dag_offsets[c + 1]; i++){
+                    const uint64_t *succ = closure.data() + (size_t)dag_edges[i] * words;
+                    for(size_t k = c / 64; k < words; k++) row[k] |= succ[k];
+                }
+            }
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class Reachability
+     * @name reachable()
+     * @brief Check if there is a path from u to v. Same component or a topological order
+     *        violation is answered in O(1); otherwise the closure bit is read, or (large DAGs)
+     *        a DFS over the condensed DAG restricted to components before v's is run.
+     * @param u --> unsigned int: Source vertex id
+     * @param v --> unsigned int: Destination vertex id
+    */
+    bool network::Reachability::reachable(unsigned int u, unsigned int v){
+        unsigned int cu = comp[u], cv = comp[v];
+        if(cu == cv) return true;
+        if(cu > cv) return false;
+        if(words) return closure[(size_t)cu * words + cv / 64] >> (cv % 64) & 1;
+        if(++stamp == 0){
+            std::fill(seen.begin(), seen.end(), 0);
+            stamp = 1;
+        }
+        std::vector<unsigned int> stack = {cu};
+        seen[cu] = stamp;
+        while(!stack.empty()){
+            unsigned int c = stack.back();
+            stack.pop_back();
+            for(unsigned int i = dag_offsets[c]; i < dag_offsets[c + 1]; i++){
+                unsigned int d = dag_edges[i];
+                if(d == cv) return true;
+                if(d < cv && seen[d] != stamp){
+                    seen[d] = stamp;
+                    stack.push_back(d);
+                }
+            }
+        }
+        return false;
+    }
+
+} // namespace network
@@ -0,0 +1,65 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile components.h (header file)
+ * 
+ * DisjointSet and Reachability classes interface/structure
+ * Weakly connected components (union-find, updated on every follow) and
+ * strongly connected components with a reachability index over the condensed DAG.
+ * Include guard
+ * 
+*/
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <cstdint>
+#include <vector>
+#include "csr.h"
+
+namespace network{
+
+class DisjointSet{
+public:
+    unsigned int add();
+    unsigned int find(unsigned int x);
+    bool unite(unsigned int a, unsigned int b);
+    void clear();
+    unsigned int sets() const { return nsets; } // Inline
+    unsigned int set_size(unsigned int x) { return sz[find(x)]; } // Inline
+    size_t bytes() const { return (parent.capacity() + sz.capacity()) * sizeof(unsigned int); } // Inline
+
+private:
+    std::vector<unsigned int> parent;
+    std::vector<unsigned int> sz;
+    unsigned int nsets = 0;
+};
+
+class Reachability{
+public:
+    // Condensed DAGs up to this size keep a full transitive closure (CLOSURE_LIMIT^2 bits)
+    static constexpr unsigned int CLOSURE_LIMIT = 16384;
+
+    template<class G> void build(const G &g);
+    unsigned int components() const { return csize.size(); } // Inline
+    unsigned int component(unsigned int v) const { return comp[v]; } // Inline
+    const std::vector<unsigned int>& sizes() const { return csize; } // Inline
+    bool reachable(unsigned int u, unsigned int v);
+    size_t bytes() const{ // Inline
+        return (comp.capacity() + csize.capacity() + dag_offsets.capacity() + dag_edges.capacity()
+                + seen.capacity()) * sizeof(unsigned int) + closure.capacity() * sizeof(uint64_t);
+    }
+
+private:
+    std::vector<unsigned int> comp;      // Vertex -> component (ids in topological order)
+    std::vector<unsigned int> csize;
+    std::vector<unsigned int> dag_offsets;
+    std::vector<unsigned int> dag_edges;
+    std::vector<uint64_t> closure;       // Row c: components reachable from c
+    size_t words = 0;
+    std::vector<unsigned int> seen;      // DFS scratch when there is no closure
+    unsigned int stamp = 0;
+};
+
+} // namespace network
+
+#endif // COMPONENTS_H
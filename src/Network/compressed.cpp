@@ -0,0 +1,279 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file compressed.cpp (.cpp file) (implementation file)
+ *
+ * CompressedCSR class member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include "compressed.h"
+
+namespace network{
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name reset()
+     * @brief Start a new layout; the neighbor lists are then given by append(),
+     *        one call per vertex in id order
+     * @param vertices --> std::vector<std::string>: Emails, position is the vertex id
+    */
+    void network::CompressedCSR::reset(std::vector<std::string> &&vertices){
+        clear();
+        ids = std::move(vertices);
+        index.reserve(ids.size());
+        for(unsigned int v = 0; v < ids.size(); v++) index[ids[v]] = v;
+        out.degree.reserve(ids.size());
+        in.degree.reserve(ids.size());
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name append()
+     * @brief Encode the lists of the next vertex (the lists are sorted in place)
+     * @param out --> std::vector<unsigned int>: Followed vertex ids
+     * @param in --> std::vector<unsigned int>: Follower vertex ids
+    */
+    void network::CompressedCSR::append(std::vector<unsigned int> &out, std::vector<unsigned int> &in){
+        std::sort(out.begin(), out.end());
+        std::sort(in.begin(), in.end());
+        encode(this->out, out);
+        encode(this->in, in);
+        this->out.degree.push_back(out.size());
+        this->in.degree.push_back(in.size());
+        nedges += out.size();
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name finish()
+     * @brief Release the spare capacity left by the appends
+    */
+    void network::CompressedCSR::finish(){
+        for(lists *l : {&out, &in}){
+            l->data.shrink_to_fit();
+            l->pos.shrink_to_fit();
+            l->skip_pos.shrink_to_fit();
+            l->skips.shrink_to_fit();
+            l->degree.shrink_to_fit();
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name encode()
+     * @brief Append a sorted neighbor list: varint gaps, every block starting with an
+     *        absolute id, plus one skip entry per block when the list has several blocks
+     * @param l --> lists: Direction being encoded
+     * @param list --> const std::vector<unsigned int>: Sorted neighbor ids
+    */
+    void network::CompressedCSR::encode(lists &l, const std::vector<unsigned int> &list){
+        uint64_t start = l.data.size();
+        for(size_t k = 0; k < list.size(); k++){
+            unsigned int x = list[k];
+            if(k % BLOCK == 0){
+                if(list.size() > BLOCK) l.skips.push_back({x, (unsigned int)(l.data.size() - start)});
+            }
+            else x -= list[k - 1];
+            while(x >= 0x80){
+                l.data.push_back((uint8_t)(x | 0x80));
+                x >>= 7;
+            }
+            l.data.push_back((uint8_t)x);
+        }
+        l.pos.push_back(l.data.size());
+        l.skip_pos.push_back(l.skips.size());
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name clear()
+     * @brief Release the layout
+    */
+    void network::CompressedCSR::clear(){
+        ids.clear();
+        index.clear();
+        out = lists();
+        in = lists();
+        removed.clear();
+        nedges = 0;
+        overlay = 0;
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name add_vertex()
+     * @brief Append a user without links
+     * @param s --> const std::string: User email
+     * @return unsigned int --> Vertex id
+    */
+    unsigned int network::CompressedCSR::add_vertex(const std::string &s){
+        unsigned int v = ids.size();
+        ids.push_back(s);
+        index[s] = v;
+        for(lists *l : {&out, &in}){
+            l->pos.push_back(l->pos.back());
+            l->skip_pos.push_back(l->skip_pos.back());
+            l->degree.push_back(0);
+        }
+        return v;
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name add_edge()
+     * @brief Record a new link u -> v in the overlay (the link must not exist)
+     * @param u --> unsigned int: Follower vertex id
+     * @param v --> unsigned int: Followed vertex id
+    */
+    void network::CompressedCSR::add_edge(unsigned int u, unsigned int v){
+        if(!removed.erase(key(u, v))){
+            auto &a = out.added[u];
+            a.insert(std::lower_bound(a.begin(), a.end(), v), v);
+            auto &b = in.added[v];
+            b.insert(std::lower_bound(b.begin(), b.end(), u), u);
+        }
+        out.degree[u]++;
+        in.degree[v]++;
+        nedges++;
+        if(++overlay > std::max(MERGE_MIN, nedges / 8)) merge();
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name remove_edge()
+     * @brief Record the removal of the link u -> v in the overlay (the link must exist)
+     * @param u --> unsigned int: Follower vertex id
+     * @param v --> unsigned int: Followed vertex id
+    */
+    void network::CompressedCSR::remove_edge(unsigned int u, unsigned int v){
+        auto it = out.added.find(u);
+        auto pos = it == out.added.end() ? std::vector<unsigned int>::iterator()
+                                         : std::lower_bound(it->second.begin(), it->second.end(), v);
+        if(it != out.added.end() && pos != it->second.end() && *pos == v){
+            it->second.erase(pos);
+            auto &b = in.added[v];
+            b.erase(std::lower_bound(b.begin(), b.end(), u));
+        }
+        else removed.insert(key(u, v));
+        out.degree[u]--;
+        in.degree[v]--;
+        nedges--;
+        if(++overlay > std::max(MERGE_MIN, nedges / 8)) merge();
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name merge()
+     * @brief Re-encode every list with the overlay applied and empty the overlay
+    */
+    void network::CompressedCSR::merge(){
+        lists nout, nin;
+        nout.degree = std::move(out.degree);
+        nin.degree = std::move(in.degree);
+        std::vector<unsigned int> buf;
+        auto push = [&buf](unsigned int w){ buf.push_back(w); };
+        for(unsigned int v = 0; v < ids.size(); v++){
+            buf.clear();
+            for_each_out(v, push);
+            std::sort(buf.begin(), buf.end());
+            encode(nout, buf);
+            buf.clear();
+            for_each_in(v, push);
+            std::sort(buf.begin(), buf.end());
+            encode(nin, buf);
+        }
+        out = std::move(nout);
+        in = std::move(nin);
+        removed.clear();
+        overlay = 0;
+        finish();
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name encoded_has()
+     * @brief Membership test on an encoded list: binary search of the skip entries, then
+     *        decoding of the single block that can hold the id
+     * @param l --> const lists: Direction
+     * @param u --> unsigned int: List owner
+     * @param v --> unsigned int: Searched id
+     * @return bool --> true: v is in the encoded list of u
+    */
+    bool network::CompressedCSR::encoded_has(const lists &l, unsigned int u, unsigned int v){
+        const uint8_t *p = l.data.data() + l.pos[u];
+        const uint8_t *end = l.data.data() + l.pos[u + 1];
+        if(p == end) return false;
+        auto first = l.skips.begin() + l.skip_pos[u], last = l.skips.begin() + l.skip_pos[u + 1];
+        if(first != last){
+            auto blk = std::upper_bound(first, last, v, [](unsigned int x, const skip &s){ return x < s.first; });
+            if(blk == first) return false;
+            --blk;
+            p += blk->offset;
+            if(blk + 1 != last) end = l.data.data() + l.pos[u] + (blk + 1)->offset;
+        }
+        unsigned int prev = varint(p);
+        while(prev < v && p < end) prev += varint(p);
+        return prev == v;
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name has_edge()
+     * @brief Check if u follows v
+     * @param u --> unsigned int: Follower vertex id
+     * @param v --> unsigned int: Followed vertex id
+     * @return bool --> true: The link exists
+    */
+    bool network::CompressedCSR::has_edge(unsigned int u, unsigned int v) const{
+        if(!removed.empty() && removed.count(key(u, v))) return false;
+        auto it = out.added.find(u);
+        if(it != out.added.end() && std::binary_search(it->second.begin(), it->second.end(), v))
+            return true;
+        return encoded_has(out, u, v);
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name find()
+     * @brief Get the vertex id of a user
+     * @param s --> std::string_view: User email
+     * @return int --> Vertex id, -1 if the user isn't in the layout
+    */
+    int network::CompressedCSR::find(std::string_view s) const{
+        auto it = lookup(index, s);
+        return it == index.end() ? -1 : (int)it->second;
+    }
+
+    /**
+     * @namespace network
+     * @class CompressedCSR
+     * @name bytes()
+     * @brief Memory used by the topology (lists, offsets, skips and overlay; the email
+     *        table isn't counted)
+     * @return size_t --> Bytes
+    */
+    size_t network::CompressedCSR::bytes() const{
+        size_t ans = removed.size() * (sizeof(uint64_t) + 2 * sizeof(void*));
+        for(const lists *l : {&out, &in}){
+            ans += l->data.capacity() + l->pos.capacity() * sizeof(uint64_t)
+                 + l->skip_pos.capacity() * sizeof(unsigned int) + l->skips.capacity() * sizeof(skip)
+                 + l->degree.capacity() * sizeof(unsigned int);
+            for(const auto &a : l->added) ans += a.second.capacity() * sizeof(unsigned int) + 4 * sizeof(void*);
+        }
+        return ans;
+    }
+
+} // namespace network
@@ -0,0 +1,134 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile compressed.h (header file)
+ *
+ * CompressedCSR class interface/structure
+ * Compressed topology of the network graph: every sorted neighbor list is gap encoded
+ * with varints, in blocks of BLOCK neighbors that start with an absolute id. Lists
+ * longer than one block keep a skip entry per block (first id + byte offset), so a
+ * membership test decodes a single block. Recent follow/unfollow calls go to a small
+ * mutable overlay that is merged back into the encoded lists when it grows.
+ * Include guard
+ *
+*/
+
+#ifndef COMPRESSED_H
+#define COMPRESSED_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "lookup.h"
+
+namespace network{
+
+class CompressedCSR{
+public:
+    static constexpr unsigned int BLOCK = 64;         // Neighbors per block
+    static constexpr size_t MERGE_MIN = 4096;         // Overlay size always accepted before a merge
+
+    std::vector<std::string> ids;                         // vertex id -> email
+    string_map<unsigned int> index;                       // email -> vertex id
+
+    void reset(std::vector<std::string> &&vertices);
+    void append(std::vector<unsigned int> &out, std::vector<unsigned int> &in);
+    void finish();
+    void clear();
+    unsigned int add_vertex(const std::string &s);
+    void add_edge(unsigned int u, unsigned int v);
+    void remove_edge(unsigned int u, unsigned int v);
+    void merge();
+    bool has_edge(unsigned int u, unsigned int v) const;
+    int find(std::string_view s) const;
+    unsigned int size() const { return ids.size(); } // Inline
+    size_t edges() const { return nedges; } // Inline
+    unsigned int outdegree(unsigned int v) const { return out.degree[v]; } // Inline
+    unsigned int indegree(unsigned int v) const { return in.degree[v]; } // Inline
+    size_t overlay_size() const { return overlay; } // Inline
+    size_t bytes() const;
+    template<class F> void for_each_out(unsigned int v, F fn) const { walk(out, v, fn, false); } // Inline
+    template<class F> void for_each_in(unsigned int v, F fn) const { walk(in, v, fn, true); } // Inline
+
+private:
+    struct skip{
+        unsigned int first;    // First neighbor of the block
+        unsigned int offset;   // Byte offset of the block inside the list
+    };
+
+    struct lists{
+        std::vector<uint8_t> data;                 // Encoded neighbor lists, vertex after vertex
+        std::vector<uint64_t> pos = {0};           // Vertex -> first byte (n + 1 entries)
+        std::vector<unsigned int> skip_pos = {0};  // Vertex -> first skip entry (n + 1 entries)
+        std::vector<skip> skips;
+        std::vector<unsigned int> degree;          // Current degree (encoded + overlay)
+        std::unordered_map<unsigned int, std::vector<unsigned int>> added;  // Overlay, sorted
+    };
+
+    lists out;
+    lists in;
+    std::unordered_set<uint64_t> removed;   // Encoded edges (u << 32 | v) removed by the overlay
+    size_t nedges = 0;
+    size_t overlay = 0;
+
+    static uint64_t key(unsigned int u, unsigned int v) { return (uint64_t)u << 32 | v; } // Inline
+    static void encode(lists &l, const std::vector<unsigned int> &list);
+    static bool encoded_has(const lists &l, unsigned int u, unsigned int v);
+
+    /// @brief Read one varint and advance the cursor.
+    static unsigned int varint(const uint8_t *&p){
+        unsigned int x = *p & 0x7F;
+        for(int shift = 7; *p++ & 0x80; shift += 7) x |= (unsigned int)(*p & 0x7F) << shift;
+        return x;
+    }
+
+    /**
+     * @brief Call fn(id) for every encoded neighbor of v. Runs of eight one byte gaps
+     *        (common once ids are close) are detected with a single 64 bit test.
+    */
+    template<class F> static void decode(const lists &l, unsigned int v, F &fn){
+        const uint8_t *p = l.data.data() + l.pos[v];
+        const uint8_t *end = l.data.data() + l.pos[v + 1];
+        unsigned int k = 0, prev = 0;
+        while(p < end){
+            if(k % BLOCK == 0) prev = varint(p);
+            else{
+                uint64_t word;
+                if(BLOCK - k % BLOCK >= 8 && end - p >= 8
+                   && (std::memcpy(&word, p, 8), !(word & 0x8080808080808080ull))){
+                    for(int i = 0; i < 8; i++){
+                        prev += p[i];
+                        fn(prev);
+                    }
+                    p += 8;
+                    k += 8;
+                    continue;
+                }
+                prev += varint(p);
+            }
+            fn(prev);
+            k++;
+        }
+    }
+
+    /// @brief Encoded neighbors minus the removed ones, then the overlay neighbors.
+    template<class F> void walk(const lists &l, unsigned int v, F &fn, bool reverse) const{
+        if(removed.empty()) decode(l, v, fn);
+        else{
+            auto filtered = [&](unsigned int w){
+                if(!removed.count(reverse ? key(w, v) : key(v, w))) fn(w);
+            };
+            decode(l, v, filtered);
+        }
+        auto it = l.added.find(v);
+        if(it != l.added.end())
+            for(unsigned int w : it->second) fn(w);
+    }
+};
+
+} // namespace network
+
+#endif // COMPRESSED_H
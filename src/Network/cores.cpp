@@ -0,0 +1,128 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file cores.cpp (.cpp file) (implementation file)
+ *
+ * CoreDecomposition class member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include <atomic>
+#include "cores.h"
+#include "parallel.h"
+
+namespace network{
+
+    /// @brief Followers + following of a vertex, self follows excluded
+    unsigned int network::CoreDecomposition::degree(const CSR &g, unsigned int v){
+        unsigned int d = g.outdegree(v) + g.indegree(v);
+        if(std::binary_search(g.out_begin(v), g.out_end(v), v)) d -= 2;
+        return d;
+    }
+
+    /**
+     * @namespace network
+     * @class CoreDecomposition
+     * @name build()
+     * @brief Bucket algorithm (Batagelj and Zaversnik), O(users + links): vertices are kept
+     *        sorted by current degree in an array of buckets and peeled from the lowest one;
+     *        removing a vertex moves every neighbour with a higher degree one bucket down.
+     * @param g --> const CSR: Graph snapshot
+    */
+    void network::CoreDecomposition::build(const CSR &g){
+        unsigned int n = g.size();
+        core.assign(n, 0);
+        unsigned int top = 0;
+        for(unsigned int v = 0; v < n; v++){
+            core[v] = degree(g, v);
+            top = std::max(top, core[v]);
+        }
+        std::vector<unsigned int> bin(top + 2, 0), pos(n), vert(n);
+        for(unsigned int v = 0; v < n; v++) bin[core[v] + 1]++;
+        for(unsigned int d = 1; d <= top + 1; d++) bin[d] += bin[d - 1];
+        for(unsigned int v = 0; v < n; v++){
+            pos[v] = bin[core[v]]++;
+            vert[pos[v]] = v;
+        }
+        for(unsigned int d = top + 1; d > 0; d--) bin[d] = bin[d - 1];
+        bin[0] = 0;
+        auto lower = [&](unsigned int v, unsigned int u){
+            if(u == v || core[u] <= core[v]) return;
+            unsigned int du = core[u], pu = pos[u], pw = bin[du], w = vert[pw];
+            if(u != w){
+                pos[u] = pw;
+                vert[pu] = w;
+                pos[w] = pu;
+                vert[pw] = u;
+            }
+            bin[du]++;
+            core[u]--;
+        };
+        for(unsigned int i = 0; i < n; i++){
+            unsigned int v = vert[i];
+            for(auto p = g.out_begin(v); p != g.out_end(v); ++p) lower(v, *p);
+            for(auto p = g.in_begin(v); p != g.in_end(v); ++p) lower(v, *p);
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class CoreDecomposition
+     * @name build_parallel()
+     * @brief Level synchronous peeling across the worker threads: at level k every vertex
+     *        left with degree k is removed in parallel, and a neighbour whose (atomic) degree
+     *        falls to k joins the next frontier of the same level; a decrement below k is
+     *        undone, so a vertex is never peeled at a lower level than its core. Only the
+     *        vertices not peeled yet are scanned at every level.
+     * @param g --> const CSR: Graph snapshot
+    */
+    void network::CoreDecomposition::build_parallel(const CSR &g){
+        unsigned int n = g.size();
+        core.assign(n, 0);
+        std::vector<std::atomic<unsigned int>> deg(n);
+        parallel_for(n, [&](size_t v, unsigned int){ deg[v].store(degree(g, v), std::memory_order_relaxed); }, 4096);
+        unsigned int nthreads = workers();
+        std::vector<std::vector<unsigned int>> local(nthreads), rest(nthreads);
+        std::vector<unsigned int> alive(n), frontier;
+        for(unsigned int v = 0; v < n; v++) alive[v] = v;
+        auto gather = [&](std::vector<std::vector<unsigned int>> &parts, std::vector<unsigned int> &out){
+            out.clear();
+            for(auto &p : parts){
+                out.insert(out.end(), p.begin(), p.end());
+                p.clear();
+            }
+        };
+        for(unsigned int k = 0; !alive.empty(); k++){
+            parallel_for(alive.size(), [&](size_t i, unsigned int tid){
+                unsigned int v = alive[i];
+                (deg[v].load(std::memory_order_relaxed) <= k ? local[tid] : rest[tid]).push_back(v);
+            }, 4096);
+            gather(local, frontier);
+            gather(rest, alive);
+            while(!frontier.empty()){
+                parallel_for(frontier.size(), [&](size_t i, unsigned int tid){
+                    unsigned int v = frontier[i];
+                    core[v] = k;
+                    auto drop = [&](unsigned int u){
+                        if(u == v || deg[u].load(std::memory_order_relaxed) <= k) return;
+                        unsigned int d = deg[u].fetch_sub(1, std::memory_order_relaxed);
+                        if(d == k + 1) local[tid].push_back(u);
+                        else if(d <= k) deg[u].fetch_add(1, std::memory_order_relaxed);
+                    };
+                    for(auto p = g.out_begin(v); p != g.out_end(v); ++p) drop(*p);
+                    for(auto p = g.in_begin(v); p != g.in_end(v); ++p) drop(*p);
+                }, 64);
+                gather(local, frontier);
+            }
+            alive.erase(std::remove_if(alive.begin(), alive.end(), [&](unsigned int v){
+                return deg[v].load(std::memory_order_relaxed) <= k;
+            }), alive.end());
+        }
+    }
+
+    /// @brief Largest core number (the graph degeneracy)
+    unsigned int network::CoreDecomposition::degeneracy() const{
+        return core.empty() ? 0 : *std::max_element(core.begin(), core.end());
+    }
+
+} // namespace network
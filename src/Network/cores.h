@@ -0,0 +1,36 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile cores.h (header file)
+ *
+ * CoreDecomposition class interface/structure
+ * k-core decomposition of the network graph: the core number of a user is the largest k
+ * such that the user belongs to a group where everyone has at least k connections
+ * (followers + following, as in degree()) inside the group. Self follows are ignored.
+ * Include guard
+ *
+*/
+
+#ifndef CORES_H
+#define CORES_H
+
+#include <vector>
+#include "csr.h"
+
+namespace network{
+
+class CoreDecomposition{
+public:
+    void build(const CSR &g);
+    void build_parallel(const CSR &g);
+    const std::vector<unsigned int>& numbers() const { return core; } // Inline (vertex id -> core number)
+    unsigned int degeneracy() const;
+
+private:
+    std::vector<unsigned int> core;
+
+    static unsigned int degree(const CSR &g, unsigned int v);
+};
+
+} // namespace network
+
+#endif // CORES_H
@@ -0,0 +1,163 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file csr.cpp (.cpp file) (implementation file)
+ * 
+ * CSR class member functions implementation
+ * 
+*/
+
+#include <algorithm>
+#include <tuple>
+#include "csr.h"
+
+namespace network{
+
+    /**
+     * @namespace network
+     * @class CSR
+     * @name assign()
+     * @brief Build the out/in adjacency arrays from a vertex list and an edge list
+     *        using a counting sort by endpoint, then sort every neighbor range.
+     * @param vertices --> std::vector<std::string>: Emails, position is the vertex id
+     * @param edges --> std::vector<std::pair>: (source id, destination id) pairs
+     * @param weights --> const std::vector<float>: Weight of every edge (empty: all 1)
+    */
+    void network::CSR::assign(std::vector<std::string> &&vertices,
+                              std::vector<std::pair<unsigned int, unsigned int>> &edges,
+                              const std::vector<float> &weights)
+    {
+        ids = std::move(vertices);
+        unsigned int n = ids.size();
+        index.clear();
+        index.reserve(n);
+        for(unsigned int v = 0; v < n; v++) index[ids[v]] = v;
+
+        out_offsets.assign(n + 1, 0);
+        in_offsets.assign(n + 1, 0);
+        for(const auto &e : edges){
+            out_offsets[e.first + 1]++;
+            in_offsets[e.second + 1]++;
+        }
+        for(unsigned int v = 0; v < n; v++){
+            out_offsets[v + 1] += out_offsets[v];
+            in_offsets[v + 1] += in_offsets[v];
+        }
+        out_edges.resize(edges.size());
+        in_edges.resize(edges.size());
+        out_weights.assign(weights.empty() ? 0 : edges.size(), 1.0f);
+        std::vector<unsigned int> opos(out_offsets.begin(), out_offsets.end() - 1);
+        std::vector<unsigned int> ipos(in_offsets.begin(), in_offsets.end() - 1);
+        for(size_t i = 0; i < edges.size(); i++){
+            const auto &e = edges[i];
+            if(!weights.empty()) out_weights[opos[e.first]] = weights[i];
+            out_edges[opos[e.first]++] = e.second;
+            in_edges[ipos[e.second]++] = e.first;
+        }
+        std::vector<std::pair<unsigned int, float>> row;
+        for(unsigned int v = 0; v < n; v++){
+            std::sort(in_edges.begin() + in_offsets[v], in_edges.begin() + in_offsets[v + 1]);
+            if(weights.empty()){
+                std::sort(out_edges.begin() + out_offsets[v], out_edges.begin() + out_offsets[v + 1]);
+                continue;
+            }
+            row.clear();
+            for(unsigned int e = out_offsets[v]; e < out_offsets[v + 1]; e++) row.emplace_back(out_edges[e], out_weights[e]);
+            std::sort(row.begin(), row.end());
+            for(unsigned int e = out_offsets[v], k = 0; e < out_offsets[v + 1]; e++, k++)
+                std::tie(out_edges[e], out_weights[e]) = row[k];
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class CSR
+     * @name permute()
+     * @brief Renumber the vertices; ids/index keep mapping every vertex id to its email
+     * @param order --> const std::vector<unsigned int>: order[new id] = current id
+    */
+    void network::CSR::permute(const std::vector<unsigned int> &order){
+        unsigned int n = ids.size();
+        if(order.size() != n) return;
+        std::vector<unsigned int> rank(n);
+        std::vector<std::string> vertices(n);
+        for(unsigned int v = 0; v < n; v++){
+            rank[order[v]] = v;
+            vertices[v] = std::move(ids[order[v]]);
+        }
+        std::vector<std::pair<unsigned int, unsigned int>> edges;
+        edges.reserve(out_edges.size());
+        for(unsigned int u = 0; u < n; u++)
+            for(auto p = out_begin(u); p != out_end(u); ++p) edges.emplace_back(rank[u], rank[*p]);
+        std::vector<float> weights;
+        weights.swap(out_weights);   // Edges listed in out_edges order
+        assign(std::move(vertices), edges, weights);
+    }
+
+    /**
+     * @namespace network
+     * @class CSR
+     * @name set_weight()
+     * @brief Change the weight of an edge in place (the weights array is created on the
+     *        first weight that isn't 1)
+     * @param u --> unsigned int: Source vertex id
+     * @param v --> unsigned int: Destination vertex id
+     * @param w --> float: New weight
+     * @return bool --> true: Weight changed, false: There is no such edge
+    */
+    bool network::CSR::set_weight(unsigned int u, unsigned int v, float w){
+        auto p = std::lower_bound(out_begin(u), out_end(u), v);
+        if(p == out_end(u) || *p != v) return false;
+        if(out_weights.empty()){
+            if(w == 1) return true;
+            out_weights.assign(out_edges.size(), 1.0f);
+        }
+        out_weights[p - out_edges.data()] = w;
+        return true;
+    }
+
+    /**
+     * @namespace network
+     * @class CSR
+     * @name clear()
+     * @brief Release the snapshot
+    */
+    void network::CSR::clear(){
+        ids.clear();
+        index.clear();
+        out_offsets.clear();
+        out_edges.clear();
+        out_weights.clear();
+        in_offsets.clear();
+        in_edges.clear();
+    }
+
+    /**
+     * @namespace network
+     * @class CSR
+     * @name bytes()
+     * @brief Memory used by the snapshot (arrays, email table and index)
+     * @return size_t --> Bytes
+    */
+    size_t network::CSR::bytes() const{
+        size_t ans = (out_offsets.capacity() + out_edges.capacity() + in_offsets.capacity()
+                      + in_edges.capacity()) * sizeof(unsigned int) + out_weights.capacity() * sizeof(float);
+        ans += ids.capacity() * sizeof(std::string) + index.bucket_count() * sizeof(void*);
+        ans += index.size() * (sizeof(std::pair<const std::string, unsigned int>) + 2 * sizeof(void*));
+        for(const auto &s : ids) ans += s.capacity() > 15 ? 2 * (s.capacity() + 1) : 0;   // ids + index keys
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class CSR
+     * @name find()
+     * @brief Get the vertex id of a user
+     * @param s --> std::string_view: User email
+     * @return int --> Vertex id, -1 if the user isn't in the snapshot
+    */
+    int network::CSR::find(std::string_view s) const{
+        auto it = lookup(index, s);
+        return it == index.end() ? -1 : (int)it->second;
+    }
+
+} // namespace network
@@ -0,0 +1,57 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile csr.h (header file)
+ * 
+ * CSR class interface/structure
+ * Contiguous (compressed sparse row) snapshot of the network graph used by the
+ * analytics algorithms. Vertices are dense ids [0, size()), neighbor lists are sorted.
+ * Link weights are kept (aligned with out_edges) only when some weight isn't 1.
+ * Include guard
+ * 
+*/
+
+#ifndef CSR_H
+#define CSR_H
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "lookup.h"
+
+namespace network{
+
+class CSR{
+public:
+    std::vector<std::string> ids;                         // vertex id -> email
+    string_map<unsigned int> index;                       // email -> vertex id
+    std::vector<unsigned int> out_offsets;
+    std::vector<unsigned int> out_edges;
+    std::vector<float> out_weights;                       // Weight of out_edges[i] (empty: all 1)
+    std::vector<unsigned int> in_offsets;
+    std::vector<unsigned int> in_edges;
+
+    void assign(std::vector<std::string> &&vertices,
+                std::vector<std::pair<unsigned int, unsigned int>> &edges,
+                const std::vector<float> &weights = {});
+    void permute(const std::vector<unsigned int> &order);
+    void clear();
+    unsigned int size() const { return ids.size(); } // Inline
+    size_t edges() const { return out_edges.size(); } // Inline
+    unsigned int outdegree(unsigned int v) const { return out_offsets[v + 1] - out_offsets[v]; } // Inline
+    unsigned int indegree(unsigned int v) const { return in_offsets[v + 1] - in_offsets[v]; } // Inline
+    const unsigned int* out_begin(unsigned int v) const { return out_edges.data() + out_offsets[v]; } // Inline
+    const unsigned int* out_end(unsigned int v) const { return out_edges.data() + out_offsets[v + 1]; } // Inline
+    const unsigned int* in_begin(unsigned int v) const { return in_edges.data() + in_offsets[v]; } // Inline
+    const unsigned int* in_end(unsigned int v) const { return in_edges.data() + in_offsets[v + 1]; } // Inline
+    float weight(size_t e) const { return out_weights.empty() ? 1.0f : out_weights[e]; } // Inline (e: position in out_edges)
+    bool set_weight(unsigned int u, unsigned int v, float w);
+    int find(std::string_view s) const;
+    size_t bytes() const;
+    template<class F> void for_each_out(unsigned int v, F fn) const { for(auto p = out_begin(v); p != out_end(v); ++p) fn(*p); } // Inline
+    template<class F> void for_each_in(unsigned int v, F fn) const { for(auto p = in_begin(v); p != in_end(v); ++p) fn(*p); } // Inline
+};
+
+} // namespace network
+
+#endif // CSR_H
@@ -0,0 +1,124 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file khop.cpp (.cpp file) (implementation file)
+ * 
+ * KHop class member functions implementation
+ * 
+*/
+
+#include <algorithm>
+#include "khop.h"
+
+namespace network{
+
+    /**
+     * @namespace network
+     * @class KHop
+     * @name KHop()
+     * @brief Start a k-hop traversal (the source itself is not part of the result)
+     * @param g --> const CSR: Graph snapshot (must not change during the traversal)
+     * @param src --> int: Source vertex id (-1: empty traversal)
+     * @param k --> unsigned int: Maximum number of hops
+     * @param reverse --> bool: false: Follow out-links (who the user reaches),
+     *                          true: Follow in-links (who reaches the user)
+    */
+    network::KHop::KHop(const CSR &g, int src, unsigned int k, bool reverse)
+        : g(g), reverse(reverse), k(k)
+    {
+        if(src < 0) return;
+        seen.assign((g.size() + 63) / 64, 0);
+        mark(seen, src);
+        front.push_back(src);
+        unvisited_edges = g.edges() - fdegree(src);
+    }
+
+    /**
+     * @namespace network
+     * @class KHop
+     * @name next_level()
+     * @brief Expand one hop. Small frontiers are expanded top-down (scan their links);
+     *        large frontiers bottom-up (every unvisited user checks if one of its
+     *        reverse links is in the frontier bitset), as in Beamer's direction
+     *        optimising BFS.
+     * @return bool --> true: New users reached, false: Traversal finished
+    */
+    bool network::KHop::next_level(){
+        if(lvl >= k || front.empty()){
+            front.clear();
+            return false;
+        }
+        size_t frontier_edges = 0;
+        for(unsigned int v : front) frontier_edges += fdegree(v);
+        if(!bottom_up && frontier_edges > unvisited_edges / ALPHA) bottom_up = true;
+        else if(bottom_up && front.size() < g.size() / BETA) bottom_up = false;
+
+        next.clear();
+        if(!bottom_up){
+            for(unsigned int v : front){
+                const unsigned int *b = reverse ? g.in_begin(v) : g.out_begin(v);
+                const unsigned int *e = reverse ? g.in_end(v) : g.out_end(v);
+                for(; b != e; ++b){
+                    if(!test(seen, *b)){
+                        mark(seen, *b);
+                        next.push_back(*b);
+                        unvisited_edges -= fdegree(*b);
+                    }
+                }
+            }
+        } else{
+            front_bits.assign(seen.size(), 0);
+            for(unsigned int v : front) mark(front_bits, v);
+            for(size_t word = 0; word < seen.size(); word++){
+                uint64_t todo = ~seen[word];
+                while(todo){
+                    unsigned int w = word * 64 + __builtin_ctzll(todo);
+                    todo &= todo - 1;
+                    if(w >= g.size()) break;
+                    const unsigned int *b = reverse ? g.out_begin(w) : g.in_begin(w);
+                    const unsigned int *e = reverse ? g.out_end(w) : g.in_end(w);
+                    for(; b != e; ++b){
+                        if(test(front_bits, *b)){
+                            mark(seen, w);
+                            next.push_back(w);
+                            unvisited_edges -= fdegree(w);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        front.swap(next);
+        lvl++;
+        total += front.size();
+        return !front.empty();
+    }
+
+    /**
+     * @namespace network
+     * @class KHop
+     * @name count()
+     * @brief Run the remaining levels and get the number of users within k hops
+     * @return size_t --> Users reached (source excluded)
+    */
+    size_t network::KHop::count(){
+        while(next_level());
+        return total;
+    }
+
+    /// @brief Iterator constructor, positions on the first reached user (or end)
+    /// @param kh --> KHop*: Traversal to stream (nullptr: end iterator)
+    network::KHop::iterator::iterator(KHop *kh) : kh(kh){
+        if(!kh) return;
+        if(kh->lvl == 0) kh->next_level();  // Skip the source
+        if(kh->front.empty()) this->kh = nullptr;
+    }
+
+    /// @brief Advance to the next reached user, expanding the next level when needed
+    network::KHop::iterator& network::KHop::iterator::operator++(){
+        if(++pos < kh->front.size()) return *this;
+        pos = 0;
+        if(!kh->next_level()) kh = nullptr;
+        return *this;
+    }
+
+} // namespace network
@@ -0,0 +1,78 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile khop.h (header file)
+ * 
+ * KHop class interface/structure
+ * Level by level k-hop traversal (direction optimising BFS with bitset visited set).
+ * Only the current level is kept in memory, so the users within k hops can be counted
+ * or streamed without materialising the whole result.
+ * Include guard
+ * 
+*/
+
+#ifndef KHOP_H
+#define KHOP_H
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "csr.h"
+
+namespace network{
+
+class KHop{
+public:
+    static constexpr unsigned int ALPHA = 14;  // Switch to bottom-up when frontier edges > unvisited edges / ALPHA
+    static constexpr unsigned int BETA = 24;   // Back to top-down when frontier < users / BETA
+
+    class iterator{
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string*;
+        using reference = const std::string&;
+
+        iterator(KHop *kh = nullptr);
+        reference operator*() const { return kh->g.ids[kh->front[pos]]; } // Inline
+        pointer operator->() const { return &**this; } // Inline
+        iterator& operator++();
+        bool operator==(const iterator &o) const { return kh == o.kh && pos == o.pos; } // Inline
+        bool operator!=(const iterator &o) const { return !(*this == o); } // Inline
+
+    private:
+        KHop *kh;
+        size_t pos = 0;
+    };
+
+    KHop(const CSR &g, int src, unsigned int k, bool reverse = false);
+    bool next_level();
+    const std::vector<unsigned int>& frontier() const { return front; } // Inline
+    unsigned int level() const { return lvl; } // Inline
+    size_t reached() const { return total; } // Inline
+    size_t count();
+    iterator begin() { return iterator(this); } // Inline
+    iterator end() { return iterator(); } // Inline
+
+private:
+    const CSR &g;
+    bool reverse;
+    unsigned int k;
+    unsigned int lvl = 0;
+    std::vector<uint64_t> seen;
+    std::vector<uint64_t> front_bits;
+    std::vector<unsigned int> front;
+    std::vector<unsigned int> next;
+    size_t total = 0;
+    size_t unvisited_edges = 0;
+    bool bottom_up = false;
+
+    unsigned int fdegree(unsigned int v) const { return reverse ? g.indegree(v) : g.outdegree(v); } // Inline
+    bool test(const std::vector<uint64_t> &bits, unsigned int v) const { return bits[v >> 6] >> (v & 63) & 1; } // Inline
+    void mark(std::vector<uint64_t> &bits, unsigned int v) { bits[v >> 6] |= 1ull << (v & 63); } // Inline
+};
+
+} // namespace network
+
+#endif // KHOP_H
@@ -0,0 +1,53 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile lookup.h (header file)
+ *
+ * Email keyed hash maps that can be searched with a std::string_view, so the hot paths
+ * (follow, loaders, batch callers) don't build a std::string per lookup.
+ * Include guard
+ *
+*/
+
+#ifndef LOOKUP_H
+#define LOOKUP_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace network{
+
+    /// @brief Transparent hash: std::string and std::string_view keys hash the same way
+    struct string_hash{
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); } // Inline
+    };
+
+    template<typename T>
+    using string_map = std::unordered_map<std::string, T, string_hash, std::equal_to<>>;
+
+    /**
+     * @namespace network
+     * @name lookup()
+     * @brief Search a string_map by a std::string_view. Heterogeneous lookup of the unordered
+     *        containers is C++20; before that the key is copied into a per-thread buffer that
+     *        is reused between calls (no allocation once it is large enough).
+     * @param m --> string_map: Map to be searched
+     * @param s --> std::string_view: Key
+     * @return iterator --> Element found or m.end()
+    */
+    template<typename Map>
+    auto lookup(Map &m, std::string_view s) -> decltype(m.end()){
+#if defined(__cpp_lib_generic_unordered_lookup)
+        return m.find(s);
+#else
+        static thread_local std::string key;
+        key.assign(s.data(), s.size());
+        return m.find(key);
+#endif
+    }
+
+} // namespace network
+
+#endif // LOOKUP_H
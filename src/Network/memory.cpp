@@ -0,0 +1,82 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file memory.cpp (.cpp file) (implementation file)
+ *
+ * MemoryReport class member functions implementation
+ *
+*/
+
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+#include "memory.h"
+
+namespace network{
+
+    /**
+     * @namespace network
+     * @class MemoryReport
+     * @name add()
+     * @brief Add a category to the report
+     * @param name --> const std::string: Category shown to the user
+     * @param bytes --> size_t: Bytes used
+     * @param allocations --> size_t: Heap blocks used
+    */
+    void network::MemoryReport::add(const std::string &name, size_t bytes, size_t allocations){
+        categories.push_back({name, bytes, allocations});
+    }
+
+    /// @brief Bytes of all the categories
+    size_t network::MemoryReport::total() const{
+        size_t ans = 0;
+        for(const auto &c : categories) ans += c.bytes;
+        return ans;
+    }
+
+    /// @brief Heap blocks of all the categories
+    size_t network::MemoryReport::allocations() const{
+        size_t ans = 0;
+        for(const auto &c : categories) ans += c.allocations;
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class MemoryReport
+     * @name resident()
+     * @brief Resident memory (RSS) of the process, read from /proc/self/statm
+     * @return size_t --> Bytes (0 if unavailable)
+    */
+    size_t network::MemoryReport::resident(){
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0, rss = 0;
+        if(!(statm >> pages >> rss)) return 0;
+        return rss * sysconf(_SC_PAGESIZE);
+    }
+
+    /**
+     * @namespace network
+     * @overload --> "<<" operator
+     * @brief Bind the memory report in an output stream
+     * @param os --> std::ostream: Output stream
+     * @param r --> MemoryReport: Report
+     * @return os --> Output stream with the report
+    */
+    std::ostream& operator<<(std::ostream &os, const network::MemoryReport &r){
+        auto kb = [](size_t b){ return b / 1024.0; };
+        os << "Uso de memória:" << std::endl;
+        std::ios state(nullptr);
+        state.copyfmt(os);
+        os << std::fixed << std::setprecision(1);
+        for(const auto &c : r.categories)
+            os << "  " << c.name << ": " << kb(c.bytes) << " KB (" << c.allocations << " alocações)" << std::endl;
+        size_t total = r.total();
+        os << "  Total contabilizado: " << kb(total) << " KB (" << r.allocations() << " alocações)" << std::endl;
+        os << "  Por usuário: " << (r.users ? (double)total / r.users : 0) << " bytes" << std::endl;
+        os << "  Por ligação: " << (r.links ? (double)total / r.links : 0) << " bytes" << std::endl;
+        os << "  Memória residente do processo: " << kb(MemoryReport::resident()) / 1024 << " MB" << std::endl;
+        os.copyfmt(state);
+        return os;
+    }
+
+} // namespace network
@@ -0,0 +1,44 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile memory.h (header file)
+ *
+ * MemoryReport class interface/structure
+ * Memory accounting of the application: bytes and heap allocations per category
+ * (estimated from the container sizes/capacities), bytes per user and per link, and
+ * the resident memory of the process.
+ * Include guard
+ *
+*/
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace network{
+
+class MemoryReport{
+public:
+    struct category{
+        std::string name;
+        size_t bytes;
+        size_t allocations;   // Heap blocks
+    };
+
+    std::vector<category> categories;
+    size_t users = 0;
+    size_t links = 0;
+
+    void add(const std::string &name, size_t bytes, size_t allocations);
+    size_t total() const;
+    size_t allocations() const;
+    static size_t resident();
+    static size_t heap(const std::string &s) { return s.capacity() > 15 ? s.capacity() + 1 : 0; } // Inline
+    friend std::ostream& operator<<(std::ostream &os, const MemoryReport &r);
+};
+
+} // namespace network
+
+#endif // MEMORY_H
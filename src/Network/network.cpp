@@ -6,26 +6,47 @@
  * 
 */
 
+#include <algorithm>
+#include <cmath>
+#include <ctime>
 #include <fstream>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <queue>
 #include <typeinfo>
+#include <unordered_set>
+#include <utility>
 #include "network.h"
+#include "csr.cpp"
+#include "compressed.cpp"
+#include "components.cpp"
+#include "oracle.cpp"
+#include "khop.cpp"
+#include "reorder.cpp"
+#include "memory.cpp"
+#include "cores.cpp"
+#include "timeindex.cpp"
+#include "../Jobs/jobs.cpp"
+#include "parallel.h"
 
 namespace network{
 
     /// @brief Default class constructor
-    network::Network::Network(){}
+    template<class Index, class Adjacency>
+    network::BasicNetwork<Index, Adjacency>::BasicNetwork(){}
 
     /// @brief Overloaded constructor to directly start a node
     /// @param n --> Node to be started
-    network::Network::Network(const node &n){
+    template<class Index, class Adjacency>
+    network::BasicNetwork<Index, Adjacency>::BasicNetwork(const node &n){
         node(n.user.email, n.user.name, n.user.birthdate,
              n.user.phone, n.user.city);
     }
 
     /// @brief Class destructor
-    network::Network::~Network(){}
+    template<class Index, class Adjacency>
+    network::BasicNetwork<Index, Adjacency>::~BasicNetwork(){}
 
     /**
      * @namespace network
@@ -39,9 +60,11 @@ namespace network{
      * @param cty --> const std::string: User city
      * @return error_t --> Struct defined in network.h to handle errors  
     */
-    network::Network::error_t network::Network::insert_node(const std::string &mail, const std::string &nm,
-                                                            const std::string &brth, const std::string &phne,
-                                                            const std::string &cty)
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::error_t
+    network::BasicNetwork<Index, Adjacency>::insert_node(const std::string &mail, const std::string &nm,
+                                                         const std::string &brth, const std::string &phne,
+                                                         const std::string &cty)
     {
         errors.reset();
         if(nodes.count(mail) > 0){
@@ -50,7 +73,23 @@ namespace network{
             return errors;
         }  
         node n(mail, nm, brth, phne, cty);                                                        
+        if(!wcc_stale) n.uid = wcc.add();
         nodes[mail] = n;                          
+        version++;
+        if(soft_limit && (version & 1023) == 0) check_memory();
+        if(oracle_enabled && oracle_version == version - 1){
+            oracle.add_vertex(mail);
+            oracle_version = version;
+        }
+        if(packed_enabled && packed_version == version - 1){
+            packed.add_vertex(mail);
+            packed_version = version;
+        }
+        if(core_version == version - 1){
+            core_count[0]++;
+            core_version = version;
+        }
+        if(time_version == version - 1) time_version = version;   // No links yet
         return errors;
     }
 
@@ -59,14 +98,155 @@ namespace network{
      * @class Network
      * @name find()
      * @brief Search for a user in the graph by email
-     * @param s --> const std::string: Email to be searched
-     * @return error_t --> Struct defined in network.h to handle errors  
+     * @param s --> std::string_view: Email to be searched
+     * @return node* --> User node, nullptr if the user doesn't exist
     */
-    network::Network::node* network::Network::find(const std::string &s){
-        auto it = nodes.find(s);
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::node*
+    network::BasicNetwork<Index, Adjacency>::find(std::string_view s){
+        auto it = nodes.end();
+        if constexpr(Index::hashed) it = lookup(nodes, s);
+        else it = nodes.find(s);   // Ordered maps take the string_view directly
         return it == nodes.end() ? nullptr : &it->second;
     }
 
+    /**
+     * @namespace network
+     * @class Network
+     * @name position()
+     * @brief Find a user in a links/followers list (binary search if the lists are sorted)
+     * @param list --> const std::vector<node*>: Links or followers of a user
+     * @param n --> const node*: User searched
+     * @return size_t --> Position of n in the list, list.size() if it isn't there
+    */
+    template<class Index, class Adjacency>
+    size_t network::BasicNetwork<Index, Adjacency>::position(const std::vector<node*> &list, const node *n){
+        if constexpr(Adjacency::sorted){
+            auto it = std::lower_bound(list.begin(), list.end(), n, std::less<const node*>());
+            return it != list.end() && *it == n ? it - list.begin() : list.size();
+        }
+        else return std::find(list.begin(), list.end(), n) - list.begin();
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name attach()
+     * @brief Add a user to a links/followers list (at the end, or at its sorted position)
+     * @param list --> std::vector<node*>: Links or followers of a user
+     * @param n --> node*: User added
+     * @return size_t --> Position of n in the list (where its link attributes go)
+    */
+    template<class Index, class Adjacency>
+    size_t network::BasicNetwork<Index, Adjacency>::attach(std::vector<node*> &list, node *n){
+        if constexpr(Adjacency::sorted){
+            auto it = list.insert(std::lower_bound(list.begin(), list.end(), n, std::less<const node*>()), n);
+            return it - list.begin();
+        }
+        list.push_back(n);
+        return list.size() - 1;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name detach()
+     * @brief Remove a user from a links/followers list (the user must be in the list)
+     * @param list --> std::vector<node*>: Links or followers of a user
+     * @param n --> const node*: User removed
+     * @return size_t --> Position n had in the list
+    */
+    template<class Index, class Adjacency>
+    size_t network::BasicNetwork<Index, Adjacency>::detach(std::vector<node*> &list, const node *n){
+        size_t at = position(list, n);
+        list.erase(list.begin() + at);
+        return at;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name add_link()
+     * @brief Create a link between two users (first follows second) without formatting any
+     *        message: no allocation unless an adjacency list (or an enabled index) grows
+     * @param src --> std::string_view: Follower
+     * @param dest --> std::string_view: Followed user
+     * @param attr --> link_t: Creation time and weight of the link
+     * @return status_t --> OK, NOT_FOUND, ALREADY_FOLLOWS or INVALID_WEIGHT
+    */
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::status_t
+    network::BasicNetwork<Index, Adjacency>::add_link(std::string_view src, std::string_view dest, link_t attr){
+        auto psrc = find(src);
+        auto pdest = find(dest);
+        if(!psrc || !pdest) return NOT_FOUND;
+        bool packed_current = packed_enabled && packed_version == version;
+        bool exists = false;
+        if(packed_current) exists = packed.has_edge(packed.find(src), packed.find(dest));
+        else exists = contains(psrc->links, pdest);
+        if(exists) return ALREADY_FOLLOWS;
+        if(!valid_weight(attr.weight)) return INVALID_WEIGHT;
+        psrc->attrs.insert(psrc->attrs.begin() + attach(psrc->links, pdest), attr);
+        attach(pdest->followers, psrc);
+        link_count++;
+        weighted_links += attr.weight != 1;
+        if(!wcc_stale) wcc.unite(psrc->uid, pdest->uid);
+        version++;
+        if(soft_limit && (version & 1023) == 0) check_memory();
+        if(oracle_enabled && oracle_version == version - 1){
+            oracle.add_edge(src, dest);
+            oracle_version = version;
+        }
+        if(packed_current){
+            packed.add_edge(packed.find(src), packed.find(dest));
+            packed_version = version;
+        }
+        if(core_version == version - 1 && core_insert(psrc, pdest))
+            core_version = version;
+        if(time_version == version - 1){
+            times.add(psrc, pdest, attr.time, attr.weight);
+            time_version = version;
+        }
+        return OK;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name remove_link()
+     * @brief Delete a link between two users (first unfollows second) without formatting any message
+     * @param src --> std::string_view: Follower
+     * @param dest --> std::string_view: Followed user
+     * @return status_t --> OK, NOT_FOUND or NOT_FOLLOWING
+    */
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::status_t
+    network::BasicNetwork<Index, Adjacency>::remove_link(std::string_view src, std::string_view dest){
+        auto psrc = find(src);
+        auto pdest = find(dest);
+        if(!psrc || !pdest) return NOT_FOUND;
+        if(!contains(psrc->links, pdest)) return NOT_FOLLOWING;
+        size_t at = detach(psrc->links, pdest);
+        link_count--;
+        weighted_links -= psrc->attrs[at].weight != 1;
+        unsigned int created = psrc->attrs[at].time;
+        psrc->attrs.erase(psrc->attrs.begin() + at);
+        detach(pdest->followers, psrc);
+        wcc_stale = true;
+        version++;
+        if(packed_enabled && packed_version == version - 1){
+            packed.remove_edge(packed.find(src), packed.find(dest));
+            packed_version = version;
+        }
+        if(core_version == version - 1 && core_remove(psrc, pdest))
+            core_version = version;
+        if(time_version == version - 1){
+            times.remove(psrc, pdest, created);
+            time_version = version;
+        }
+        return OK;
+    }
+
     /**
      * @namespace network
      * @class Network
@@ -74,28 +254,25 @@ namespace network{
      * @brief Create a link between two users, where the first user start to follow the second user
      * @param src --> const std::string: First user for the link creation
      * @param dest --> const std::string: Second user for the link creation
-     * @return error_t --> Struct defined in network.h to handle errors  
+     * @return error_t --> Struct defined in network.h to handle errors (errmsg is only
+     *                     set on failure, so a successful follow doesn't allocate it)
     */
-    network::Network::error_t network::Network::follow(const std::string &src, const std::string &dest){
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::error_t
+    network::BasicNetwork<Index, Adjacency>::follow(const std::string &src, const std::string &dest){
         errors.reset();
-        auto psrc = find(src);
-        auto pdest = find(dest);
-        if(!psrc || !pdest){
-            errors.flag = true;
-            errors.errmsg = "Um dos usuários informados não existe na rede!";
-            return errors;
-        }
-        if(psrc->links.size()){
-            for(size_t i = 0; i < psrc->links.size(); i++){
-                if(psrc->links[i]->user.email == pdest->user.email){
-                    errors.flag = true;
-                    errors.errmsg = "O usuário: " + src + " já segue: " + dest + "!";
-                    return errors;
-                }
-            }
+        switch(add_link(src, dest, {static_cast<unsigned int>(std::time(nullptr)), 1})){
+            case NOT_FOUND:
+                errors.flag = true;
+                errors.errmsg = "Um dos usuários informados não existe na rede!";
+                break;
+            case ALREADY_FOLLOWS:
+                errors.flag = true;
+                errors.errmsg = "O usuário: " + src + " já segue: " + dest + "!";
+                break;
+            default:
+                break;
         }
-        psrc->links.push_back(pdest);
-        errors.errmsg = "Usuario: " + src + " começou a seguir: " + dest;
         return errors;
     }
 
@@ -109,29 +286,307 @@ namespace network{
      * @param dest --> const std::string: Second user for the link erase
      * @return error_t --> Struct defined in network.h to handle errors  
     */
-    network::Network::error_t network::Network::unfollow(const std::string &src, const std::string &dest){
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::error_t
+    network::BasicNetwork<Index, Adjacency>::unfollow(const std::string &src, const std::string &dest){
         errors.reset();
-        auto psrc = find(src);
-        auto pdest = find(dest);
-        if(!psrc || !pdest){
-            errors.flag = true;
-            errors.errmsg = "Um/Ambos usuário(s) não existe(m) na rede!";
-            return errors;
-        }
-        bool found = false;
-        for(auto it = psrc->links.begin(); it != psrc->links.end(); ++it){
-            if((*it)->user.email == dest){
-                psrc->links.erase(it);
-                found = true;
+        switch(remove_link(src, dest)){
+            case NOT_FOUND:
+                errors.flag = true;
+                errors.errmsg = "Um/Ambos usuário(s) não existe(m) na rede!";
+                break;
+            case NOT_FOLLOWING:
+                errors.flag = true;
+                errors.errmsg = "O usuário: " + src + " não segue: " + dest + "!";
                 break;
+            default:
+                break;
+        }
+        return errors;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name insert_links()
+     * @brief Bulk version of follow() used by the loaders: the emails are resolved in parallel,
+     *        the links are grouped by user with a parallel sort (dropping repeated and existing
+     *        links) and every adjacency list is filled once. The lists keep the input order
+     *        (or are sorted, with the SortedAdjacency policy).
+     * @param pairs --> const std::vector<std::pair<std::string, std::string>>: (follower, followed) links in order
+     * @param attrs --> const std::vector<link_t>: Attributes of the links, same positions (empty: defaults)
+     * @param status --> std::vector<status_t>*: Output (optional), result of every link in input order
+     *                   (OK, NOT_FOUND, ALREADY_FOLLOWS for existing or repeated links, INVALID_WEIGHT)
+     * @return size_t --> Number of links inserted (links with an unknown user are skipped)
+    */
+    template<class Index, class Adjacency>
+    size_t network::BasicNetwork<Index, Adjacency>::insert_links(const std::vector<std::pair<std::string, std::string>> &pairs,
+                                                                 const std::vector<link_t> &attrs,
+                                                                 std::vector<status_t> *status)
+    {
+        struct edge{
+            node *src;
+            node *dest;
+            size_t seq;   // Input position
+        };
+        std::vector<edge> edges(pairs.size());
+        parallel_for(pairs.size(), [&](size_t i, unsigned int){
+            auto s = nodes.find(pairs[i].first), d = nodes.find(pairs[i].second);
+            edges[i] = {s != nodes.end() ? &s->second : nullptr, d != nodes.end() ? &d->second : nullptr, i};
+        }, 4096);
+        if(status) status->assign(pairs.size(), NOT_FOUND);
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [](const edge &e){ return !e.src || !e.dest; }), edges.end());
+        std::less<const node*> before;
+        parallel_sort(edges.begin(), edges.end(), [&](const edge &a, const edge &b){
+            if(a.src != b.src) return before(a.src, b.src);
+            if(a.dest != b.dest) return before(a.dest, b.dest);
+            return a.seq < b.seq;
+        });
+        if(status)
+            for(size_t i = 0; i < edges.size(); i++)
+                (*status)[edges[i].seq] = i && edges[i].src == edges[i - 1].src && edges[i].dest == edges[i - 1].dest
+                                        ? ALREADY_FOLLOWS : OK;
+        edges.erase(std::unique(edges.begin(), edges.end(), [](const edge &a, const edge &b){
+            return a.src == b.src && a.dest == b.dest;
+        }), edges.end());
+        parallel_sort(edges.begin(), edges.end(), [&](const edge &a, const edge &b){
+            return a.src != b.src ? before(a.src, b.src) : a.seq < b.seq;
+        });
+        size_t added = 0;
+        for(size_t i = 0, j; i < edges.size(); i = j){
+            node *src = edges[i].src;
+            for(j = i; j < edges.size() && edges[j].src == src; j++);
+            std::unordered_set<const node*> existing(src->links.begin(), src->links.end());
+            src->links.reserve(src->links.size() + (j - i));
+            src->attrs.reserve(src->links.capacity());
+            for(size_t k = i; k < j; k++){
+                link_t attr = edges[k].seq < attrs.size() ? attrs[edges[k].seq] : link_t();
+                if((!existing.empty() && existing.count(edges[k].dest)) || !valid_weight(attr.weight)){
+                    if(status) (*status)[edges[k].seq] = valid_weight(attr.weight) ? ALREADY_FOLLOWS : INVALID_WEIGHT;
+                    edges[k].src = nullptr;   // Already followed (or invalid): not a new link
+                    continue;
+                }
+                src->links.push_back(edges[k].dest);
+                src->attrs.push_back(attr);
+                link_count++;
+                weighted_links += attr.weight != 1;
+                if(!wcc_stale) wcc.unite(src->uid, edges[k].dest->uid);
+                added++;
+            }
+            if constexpr(Adjacency::sorted){
+                std::vector<std::pair<node*, link_t>> row(src->links.size());
+                for(size_t k = 0; k < row.size(); k++) row[k] = {src->links[k], src->attrs[k]};
+                std::sort(row.begin(), row.end(), [&](const auto &a, const auto &b){ return before(a.first, b.first); });
+                for(size_t k = 0; k < row.size(); k++) std::tie(src->links[k], src->attrs[k]) = row[k];
             }
         }
-        if(!found){
-            errors.flag = true;
-            errors.errmsg = "O usuário: " + src + " não segue: " + dest + "!";
-            return errors;
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [](const edge &e){ return !e.src; }), edges.end());
+        parallel_sort(edges.begin(), edges.end(), [&](const edge &a, const edge &b){
+            return a.dest != b.dest ? before(a.dest, b.dest) : a.seq < b.seq;
+        });
+        for(const auto &e : edges) e.dest->followers.push_back(e.src);
+        if constexpr(Adjacency::sorted){
+            for(size_t i = 0; i < edges.size(); i++)
+                if(i + 1 == edges.size() || edges[i + 1].dest != edges[i].dest)
+                    std::sort(edges[i].dest->followers.begin(), edges[i].dest->followers.end(), before);
         }
-        return errors;
+        if(added) version++;
+        if(added && soft_limit) check_memory();
+        return added;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name follow_many()
+     * @brief Create many links at once (see insert_links()), all created now with weight 1
+     * @param pairs --> const std::vector<std::pair<std::string, std::string>>: (follower, followed) links
+     * @return std::vector<status_t> --> OK, NOT_FOUND or ALREADY_FOLLOWS for every link, in input order
+    */
+    template<class Index, class Adjacency>
+    std::vector<typename network::BasicNetwork<Index, Adjacency>::status_t>
+    network::BasicNetwork<Index, Adjacency>::follow_many(const std::vector<std::pair<std::string, std::string>> &pairs){
+        std::vector<status_t> status;
+        insert_links(pairs, std::vector<link_t>(pairs.size(), link_t{static_cast<unsigned int>(std::time(nullptr)), 1}), &status);
+        return status;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name unfollow_many()
+     * @brief Delete many links at once: the links are sorted by follower and every adjacency
+     *        list is compacted in a single pass (same for the followers lists, grouped by the
+     *        followed user), instead of one search and erase per link
+     * @param pairs --> const std::vector<std::pair<std::string, std::string>>: (follower, followed) links
+     * @return std::vector<status_t> --> OK, NOT_FOUND or NOT_FOLLOWING (repeated links too) for every
+     *                                   link, in input order
+    */
+    template<class Index, class Adjacency>
+    std::vector<typename network::BasicNetwork<Index, Adjacency>::status_t>
+    network::BasicNetwork<Index, Adjacency>::unfollow_many(const std::vector<std::pair<std::string, std::string>> &pairs){
+        struct edge{
+            node *src;
+            node *dest;
+            size_t seq;   // Input position
+        };
+        std::vector<status_t> status(pairs.size(), NOT_FOUND);
+        std::vector<edge> edges, removed;
+        edges.reserve(pairs.size());
+        for(size_t i = 0; i < pairs.size(); i++){
+            node *s = find(pairs[i].first), *d = find(pairs[i].second);
+            if(s && d) edges.push_back({s, d, i});
+        }
+        std::less<const node*> before;
+        std::sort(edges.begin(), edges.end(), [&](const edge &a, const edge &b){
+            return a.src != b.src ? before(a.src, b.src) : a.seq < b.seq;
+        });
+        std::unordered_map<const node*, size_t> drop;   // Followed user -> input position
+        for(size_t i = 0, j; i < edges.size(); i = j){
+            node *src = edges[i].src;
+            drop.clear();
+            for(j = i; j < edges.size() && edges[j].src == src; j++){
+                status[edges[j].seq] = NOT_FOLLOWING;
+                drop.emplace(edges[j].dest, edges[j].seq);   // A repeated link keeps the first position
+            }
+            size_t kept = 0;
+            for(size_t k = 0; k < src->links.size(); k++){
+                auto it = drop.find(src->links[k]);
+                if(it == drop.end()){
+                    src->links[kept] = src->links[k];
+                    src->attrs[kept++] = src->attrs[k];
+                    continue;
+                }
+                status[it->second] = OK;
+                link_count--;
+                weighted_links -= src->attrs[k].weight != 1;
+                removed.push_back({src, src->links[k], it->second});
+                drop.erase(it);
+            }
+            src->links.resize(kept);
+            src->attrs.resize(kept);
+        }
+        if(removed.empty()) return status;
+        std::sort(removed.begin(), removed.end(), [&](const edge &a, const edge &b){ return before(a.dest, b.dest); });
+        std::unordered_set<const node*> gone;
+        for(size_t i = 0, j; i < removed.size(); i = j){
+            node *dest = removed[i].dest;
+            gone.clear();
+            for(j = i; j < removed.size() && removed[j].dest == dest; j++) gone.insert(removed[j].src);
+            dest->followers.erase(std::remove_if(dest->followers.begin(), dest->followers.end(),
+                                                 [&](const node *f){ return gone.count(f) > 0; }),
+                                  dest->followers.end());
+        }
+        wcc_stale = true;
+        version++;
+        if(soft_limit) check_memory();
+        return status;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name remove_many()
+     * @brief Remove many users at once without asking for confirmation: only the users
+     *        linked to a removed one are visited, each of them once, and their lists are
+     *        compacted in a single sweep
+     * @param users --> const std::vector<std::string>: User emails
+     * @return std::vector<status_t> --> OK or NOT_FOUND (repeated users too) for every user, in input order
+    */
+    template<class Index, class Adjacency>
+    std::vector<typename network::BasicNetwork<Index, Adjacency>::status_t>
+    network::BasicNetwork<Index, Adjacency>::remove_many(const std::vector<std::string> &users){
+        std::vector<status_t> status(users.size(), NOT_FOUND);
+        std::unordered_set<const node*> doomed;
+        std::vector<node*> victims;
+        for(size_t i = 0; i < users.size(); i++){
+            node *u = find(users[i]);
+            if(u && doomed.insert(u).second){
+                status[i] = OK;
+                victims.push_back(u);
+            }
+        }
+        if(victims.empty()) return status;
+        auto alive = [&](const node *n){ return doomed.count(n) == 0; };
+        std::unordered_set<node*> touched;
+        for(auto u : victims){
+            for(auto f : u->followers) if(alive(f)) touched.insert(f);
+            for(auto l : u->links) if(alive(l)) touched.insert(l);
+            link_count -= u->links.size();
+            for(const auto &a : u->attrs) weighted_links -= a.weight != 1;
+        }
+        for(auto n : touched){
+            size_t kept = 0;
+            for(size_t k = 0; k < n->links.size(); k++){
+                if(!alive(n->links[k])){
+                    link_count--;
+                    weighted_links -= n->attrs[k].weight != 1;
+                    continue;
+                }
+                n->links[kept] = n->links[k];
+                n->attrs[kept++] = n->attrs[k];
+            }
+            n->links.resize(kept);
+            n->attrs.resize(kept);
+            n->followers.erase(std::remove_if(n->followers.begin(), n->followers.end(),
+                                              [&](const node *f){ return !alive(f); }),
+                               n->followers.end());
+        }
+        for(auto u : victims){
+            std::string key = u->user.email;
+            nodes.erase(key);
+        }
+        wcc_stale = true;
+        version++;
+        if(soft_limit) check_memory();
+        return status;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name link()
+     * @brief Get the attributes of a link
+     * @param src --> std::string_view: Follower
+     * @param dest --> std::string_view: Followed user
+     * @return const link_t* --> Creation time and weight, nullptr if src doesn't follow dest
+    */
+    template<class Index, class Adjacency>
+    const typename network::BasicNetwork<Index, Adjacency>::link_t*
+    network::BasicNetwork<Index, Adjacency>::link(std::string_view src, std::string_view dest){
+        auto psrc = find(src);
+        auto pdest = find(dest);
+        if(!psrc || !pdest) return nullptr;
+        size_t at = position(psrc->links, pdest);
+        return at == psrc->links.size() ? nullptr : &psrc->attrs[at];
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name link_weight()
+     * @brief Change the weight of a link. The topology doesn't change, so the graph version
+     *        and the indexes are kept; only a current CSR snapshot is patched in place.
+     * @param src --> std::string_view: Follower
+     * @param dest --> std::string_view: Followed user
+     * @param weight --> float: New weight (finite, >= 0)
+     * @return status_t --> OK, NOT_FOUND, NOT_FOLLOWING or INVALID_WEIGHT
+    */
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::status_t
+    network::BasicNetwork<Index, Adjacency>::link_weight(std::string_view src, std::string_view dest, float weight){
+        auto psrc = find(src);
+        auto pdest = find(dest);
+        if(!psrc || !pdest) return NOT_FOUND;
+        if(!valid_weight(weight)) return INVALID_WEIGHT;
+        size_t at = position(psrc->links, pdest);
+        if(at == psrc->links.size()) return NOT_FOLLOWING;
+        link_t &a = psrc->attrs[at];
+        weighted_links += (weight != 1) - (a.weight != 1);
+        a.weight = weight;
+        if(csr_version == version) csr.set_weight(csr.find(src), csr.find(dest), weight);
+        if(time_version == version) times.reweight(psrc, pdest, a.time, weight);
+        return OK;
     }
 
     /**
@@ -141,7 +596,8 @@ namespace network{
      * @brief Search for a user by email and show informations (if user exists)
      * @param s --> const std::string: Email to be searched
     */
-    void network::Network::list_user(const std::string &s){
+    template<class Index, class Adjacency>
+    void network::BasicNetwork<Index, Adjacency>::list_user(const std::string &s){
         auto user = find(s);
         if(!user){
             std::cout << "Usuário inexistente!" << std::endl;
@@ -151,6 +607,7 @@ namespace network{
         std::cout << *user;
         std::cout << "Seguidores: " << indegree(s) << std::endl;
         std::cout << "Seguindo: " << outdegree(s) << std::endl;
+        if(user->community) std::cout << "Comunidade: " << user->community << std::endl;
         std::cout << std::endl;
     }
 
@@ -160,7 +617,8 @@ namespace network{
      * @name list_users()
      * @brief List informations about all users in the network graph
     */
-    void network::Network::list_users(){
+    template<class Index, class Adjacency>
+    void network::BasicNetwork<Index, Adjacency>::list_users(){
         std::cout << std::endl;
         std::cout << "Usuários da rede:" << std::endl;
         for(auto &it : nodes){
@@ -179,7 +637,8 @@ namespace network{
      * @brief Get the medium indegree rate of the network graph
      * @attention Specially used for list_network() member function  
     */
-    double network::Network::network_indegree_rate(){
+    template<class Index, class Adjacency>
+    double network::BasicNetwork<Index, Adjacency>::network_indegree_rate(){
         double ans = 0;
         for(const auto &usr : nodes)
             ans += indegree(usr.first);
@@ -193,7 +652,8 @@ namespace network{
      * @brief Get the medium outdegree rate of the network graph
      * @attention Specially used for list_network() member function  
     */
-    double network::Network::network_outdegree_rate(){
+    template<class Index, class Adjacency>
+    double network::BasicNetwork<Index, Adjacency>::network_outdegree_rate(){
         double ans = 0;
         for(const auto &usr : nodes)
             ans += outdegree(usr.first);
@@ -207,7 +667,8 @@ namespace network{
      * @brief Get the most followed user of the network
      * @attention Specially used for list_network() member function  
     */
-    std::string network::Network::most_followed_user(){
+    template<class Index, class Adjacency>
+    std::string network::BasicNetwork<Index, Adjacency>::most_followed_user(){
         std::string ans;
         unsigned int max = 0;
         for(const auto& node : nodes){
@@ -224,16 +685,499 @@ namespace network{
      * @namespace network
      * @class Network
      * @name network_graph_diameter()
-     * @brief Get the graph diameter of network graph
+     * @brief Get the graph diameter of network graph (longest shortest path)
      * @attention Specially used for list_network() member function  
     */
-    int network::Network::network_graph_diameter(){
-        int ans = 0;
-        for(auto it1 = nodes.begin(); it1 != nodes.end(); ++it1){
-            for(auto it2 = std::next(it1); it2 != nodes.end(); ++it2){
-                int distance = dijkstra(it1->first, it2->first, true);
-                if(distance > ans) ans = distance;
+    template<class Index, class Adjacency>
+    int network::BasicNetwork<Index, Adjacency>::network_graph_diameter(){
+        if(packed_enabled) return graph_diameter(packed_layout());
+        return graph_diameter(layout());
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name graph_diameter()
+     * @brief Longest shortest path of a layout, with a breadth-first search from
+     *        every user in parallel. Safe to run on a snapshot in a background job: the
+     *        searches stop when the job is cancelled or out of time, and the result is then
+     *        the largest eccentricity found so far (a lower bound of the diameter).
+     * @param g --> const G: Graph snapshot (CSR or CompressedCSR)
+     * @param control --> jobs::Control*: Progress/cancellation of the job (nullptr: none)
+     * @return int --> Diameter (or its lower bound if stopped early)
+    */
+    template<class Index, class Adjacency>
+    template<class G>
+    int network::BasicNetwork<Index, Adjacency>::graph_diameter(const G &g, jobs::Control *control){
+        unsigned int n = g.size();
+        const unsigned int NONE = -1;
+        std::vector<std::vector<unsigned int>> dist(workers(), std::vector<unsigned int>(n, NONE));
+        std::vector<std::vector<unsigned int>> queue(workers());
+        std::vector<unsigned int> ecc(workers(), 0);
+        if(control) control->total(n);
+        parallel_for(n, [&](size_t s, unsigned int tid){
+            if(control && control->stopped()) return;
+            auto &d = dist[tid];
+            auto &q = queue[tid];
+            q.assign(1, s);
+            d[s] = 0;
+            for(size_t head = 0; head < q.size(); head++){
+                unsigned int u = q[head];
+                g.for_each_out(u, [&](unsigned int w){
+                    if(d[w] == NONE){
+                        d[w] = d[u] + 1;
+                        q.push_back(w);
+                    }
+                });
+            }
+            ecc[tid] = std::max(ecc[tid], d[q.back()]);
+            for(unsigned int v : q) d[v] = NONE;
+            if(control) control->advance();
+        }, 1);
+        return n ? *std::max_element(ecc.begin(), ecc.end()) : 0;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name layout()
+     * @brief Get a contiguous (CSR) snapshot of the network graph for the analytics.
+     *        The snapshot is cached and only rebuilt after the graph changes.
+     * @return const CSR& --> Snapshot of the current graph
+    */
+    template<class Index, class Adjacency>
+    const network::CSR& network::BasicNetwork<Index, Adjacency>::layout(){
+        if(csr_version == version)
+            return csr;
+        std::vector<std::string> vertices;
+        vertices.reserve(nodes.size());
+        std::unordered_map<const node*, unsigned int> ids;
+        ids.reserve(nodes.size());
+        for(const auto &n : nodes){
+            ids[&n.second] = vertices.size();
+            vertices.push_back(n.first);
+        }
+        std::vector<std::pair<unsigned int, unsigned int>> edges;
+        std::vector<float> weights;
+        for(const auto &n : nodes){
+            unsigned int src = ids[&n.second];
+            for(const auto link : n.second.links)
+                edges.emplace_back(src, ids[link]);
+            if(weighted_links)
+                for(const auto &a : n.second.attrs) weights.push_back(a.weight);
+        }
+        csr.assign(std::move(vertices), edges, weights);
+        if(order_method != VertexOrder::NONE) csr.permute(VertexOrder::compute(csr, order_method));
+        csr_version = version;
+        return csr;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name weak_index()
+     * @brief Get the weakly connected components union-find. It is updated by every
+     *        insert_node()/follow(), and rebuilt here only after an unfollow/removal.
+     * @return DisjointSet& --> Union-find indexed by node uid
+    */
+    template<class Index, class Adjacency>
+    network::DisjointSet& network::BasicNetwork<Index, Adjacency>::weak_index(){
+        if(!wcc_stale) return wcc;
+        wcc.clear();
+        for(auto &n : nodes) n.second.uid = wcc.add();
+        for(const auto &n : nodes)
+            for(const auto link : n.second.links) wcc.unite(n.second.uid, link->uid);
+        wcc_stale = false;
+        return wcc;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name strong_index()
+     * @brief Get the strongly connected components/reachability index (rebuilt after mutations)
+     * @return Reachability& --> Index over the vertex ids of packed_layout() when the compressed
+     *                           topology is enabled, of layout() otherwise
+    */
+    template<class Index, class Adjacency>
+    network::Reachability& network::BasicNetwork<Index, Adjacency>::strong_index(){
+        if(scc_version != version){
+            if(packed_enabled) scc.build(packed_layout());
+            else scc.build(layout());
+            scc_version = version;
+        }
+        return scc;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name reachable()
+     * @brief Check if there is a path between two users. Users in different weak components
+     *        are rejected by the union-find, the remaining cases by the condensed DAG index.
+     * @param src --> const std::string: First user (Source)
+     * @param dest --> const std::string: Second user (Destination)
+     * @return bool --> true: A path exists, false: No path (or unknown user)
+    */
+    template<class Index, class Adjacency>
+    bool network::BasicNetwork<Index, Adjacency>::reachable(const std::string &src, const std::string &dest){
+        auto psrc = find(src);
+        auto pdest = find(dest);
+        if(!psrc || !pdest) return false;
+        if(psrc == pdest) return true;
+        DisjointSet &weak = weak_index();
+        if(weak.find(psrc->uid) != weak.find(pdest->uid)) return false;
+        Reachability &scc = strong_index();
+        if(packed_enabled) return scc.reachable(packed.find(src), packed.find(dest));
+        return scc.reachable(csr.find(src), csr.find(dest));
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name weak_component_sizes()
+     * @brief Get the size of every weakly connected component
+     * @return std::vector<unsigned int> --> Component sizes
+    */
+    template<class Index, class Adjacency>
+    std::vector<unsigned int> network::BasicNetwork<Index, Adjacency>::weak_component_sizes(){
+        DisjointSet &weak = weak_index();
+        std::vector<unsigned int> ans;
+        for(const auto &n : nodes)
+            if(weak.find(n.second.uid) == n.second.uid) ans.push_back(weak.set_size(n.second.uid));
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name distance_oracle()
+     * @brief Get the distance index, rebuilding it if the graph changed in a way that
+     *        couldn't be patched (follow() and insert_node() patch it in place)
+     * @return DistanceOracle& --> Up to date distance index
+    */
+    template<class Index, class Adjacency>
+    network::DistanceOracle& network::BasicNetwork<Index, Adjacency>::distance_oracle(){
+        if(oracle_version != version){
+            oracle.build(layout());
+            oracle_version = version;
+        }
+        return oracle;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name distance_index()
+     * @brief Enable/disable the exact distance index used by shortest_path()
+     * @param enable --> bool: true: Build and keep the index, false: Release it
+    */
+    template<class Index, class Adjacency>
+    void network::BasicNetwork<Index, Adjacency>::distance_index(bool enable){
+        oracle_enabled = enable;
+        if(enable) distance_oracle();
+        else{
+            oracle.clear();
+            oracle_version = -1;
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name packed_layout()
+     * @brief Get the compressed topology, encoding it again from the user nodes only after a
+     *        removal (insert_node(), follow() and unfollow() patch it through its overlay).
+     *        With a vertex order the lists are encoded once to compute the order, then again
+     *        in that order; no contiguous (CSR) snapshot is built.
+     * @return const CompressedCSR& --> Up to date compressed topology
+    */
+    template<class Index, class Adjacency>
+    const network::CompressedCSR& network::BasicNetwork<Index, Adjacency>::packed_layout(){
+        if(packed_version == version)
+            return packed;
+        std::vector<const node*> order;   // vertex id -> user
+        order.reserve(nodes.size());
+        for(const auto &n : nodes) order.push_back(&n.second);
+        auto encode = [this, &order](){
+            std::vector<std::string> vertices;
+            vertices.reserve(order.size());
+            std::unordered_map<const node*, unsigned int> ids;
+            ids.reserve(order.size());
+            for(const node *n : order){
+                ids[n] = vertices.size();
+                vertices.push_back(n->user.email);
+            }
+            packed.reset(std::move(vertices));
+            std::vector<unsigned int> out, in;
+            for(const node *n : order){
+                out.clear();
+                in.clear();
+                for(const auto link : n->links) out.push_back(ids[link]);
+                for(const auto flwr : n->followers) in.push_back(ids[flwr]);
+                packed.append(out, in);
+            }
+            packed.finish();
+        };
+        encode();
+        if(order_method != VertexOrder::NONE){
+            std::vector<unsigned int> perm = VertexOrder::compute(packed, order_method);
+            std::vector<const node*> placed(perm.size());
+            for(size_t v = 0; v < perm.size(); v++) placed[v] = order[perm[v]];
+            order.swap(placed);
+            encode();
+        }
+        packed_version = version;
+        return packed;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name compressed_layout()
+     * @brief Enable/disable the compressed topology. While enabled it replaces the contiguous
+     *        (CSR) snapshot for the reachability index, the unweighted path searches (single
+     *        and batch), the diameter and the duplicate link check of follow(). Weighted
+     *        paths, the distance index, k-hop ranges, cores and the analytics keep reading
+     *        the CSR snapshot, built only when one of them is used.
+     * @param enable --> bool: true: Build and keep it, false: Release it
+    */
+    template<class Index, class Adjacency>
+    void network::BasicNetwork<Index, Adjacency>::compressed_layout(bool enable){
+        packed_enabled = enable;
+        scc_version = -1;   // Vertex ids of the other layout
+        if(enable) packed_layout();
+        else{
+            packed.clear();
+            packed_version = -1;
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name vertex_order()
+     * @brief Choose the vertex order of the contiguous layouts (analytics, indexes and
+     *        path searches); emails keep mapping to the right vertices through the
+     *        layout id tables. The layouts are rebuilt in the new order.
+     * @param m --> VertexOrder::method_t: NONE, DEGREE, RCM or GORDER
+    */
+    template<class Index, class Adjacency>
+    void network::BasicNetwork<Index, Adjacency>::vertex_order(VertexOrder::method_t m){
+        if(m == order_method) return;
+        order_method = m;
+        csr_version = -1;
+        scc_version = -1;
+        packed_version = -1;
+        if(packed_enabled) packed_layout();
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name distance()
+     * @brief Length (number of links, weights ignored) of the shortest path between two users
+     *        (index when enabled, BFS otherwise)
+     * @param src --> const std::string: First user (Source)
+     * @param dest --> const std::string: Second user (Destination)
+     * @return int --> Distance, -1 if there is no path or a user doesn't exist
+    */
+    template<class Index, class Adjacency>
+    int network::BasicNetwork<Index, Adjacency>::distance(const std::string &src, const std::string &dest){
+        if(!find(src) || !find(dest)) return -1;
+        if(src == dest) return 0;
+        if(oracle_enabled) return distance_oracle().distance(src, dest);
+        int d = dijkstra(src, dest, true, false);
+        return d > 0 ? d : -1;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name weighted_distance()
+     * @brief Cost of the cheapest path between two users (sum of the link weights); while
+     *        every weight is 1 this is distance()
+     * @param src --> const std::string: First user (Source)
+     * @param dest --> const std::string: Second user (Destination)
+     * @return double --> Cost, 0 if src == dest, -1 if there is no path or a user doesn't exist
+    */
+    template<class Index, class Adjacency>
+    double network::BasicNetwork<Index, Adjacency>::weighted_distance(const std::string &src, const std::string &dest){
+        if(!weighted_links) return distance(src, dest);
+        if(!find(src) || !find(dest)) return -1;
+        if(src == dest) return 0;
+        if(!reachable(src, dest)) return -1;
+        const CSR &g = layout();
+        std::vector<unsigned int> parent;
+        return cheapest_path(g, g.find(src), g.find(dest), parent);
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name dump_distance_index()
+     * @brief Serialize the distance index (to be persisted with the database)
+     * @return std::string --> Serialized index, empty if the index is disabled
+    */
+    template<class Index, class Adjacency>
+    std::string network::BasicNetwork<Index, Adjacency>::dump_distance_index(){
+        return oracle_enabled ? distance_oracle().serialize() : std::string();
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name load_distance_index()
+     * @brief Restore a persisted distance index and enable it
+     * @param data --> const std::string: Output of dump_distance_index() for this graph
+     * @return bool --> true: Index restored, false: Data doesn't match the graph
+    */
+    template<class Index, class Adjacency>
+    bool network::BasicNetwork<Index, Adjacency>::load_distance_index(const std::string &data){
+        if(!oracle.deserialize(data, layout())) return false;
+        oracle_enabled = true;
+        oracle_version = version;
+        return true;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name fingerprint()
+     * @brief Order independent hash of the users and links, used to check that a persisted
+     *        index still matches the graph
+     * @return unsigned long --> Graph fingerprint
+    */
+    template<class Index, class Adjacency>
+    unsigned long network::BasicNetwork<Index, Adjacency>::fingerprint() const{
+        std::hash<std::string> h;
+        auto mix = [](unsigned long x){
+            x ^= x >> 33; x *= 0xff51afd7ed558ccdul;
+            x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ul;
+            return x ^ (x >> 33);
+        };
+        unsigned long ans = nodes.size();
+        for(const auto &n : nodes){
+            unsigned long hs = h(n.first);
+            ans += mix(hs);
+            for(const auto link : n.second.links) ans += mix(hs * 31 + mix(h(link->user.email)));
+        }
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name memory_report()
+     * @brief Memory used by the graph and its derived indexes
+     * @attention Sizes are estimated from the container capacities (node overhead of the
+     *            hash tables included), the allocator bookkeeping isn't counted
+     * @return MemoryReport --> Bytes and heap blocks per category
+    */
+    template<class Index, class Adjacency>
+    network::MemoryReport network::BasicNetwork<Index, Adjacency>::memory_report() const{
+        MemoryReport r;
+        size_t strings = 0, nstrings = 0, links = 0, nlinks = 0, attrs = 0, nattrs = 0;
+        size_t followers = 0, nfollowers = 0, edges = 0;
+        for(const auto &n : nodes){
+            for(const auto *s : {&n.first, &n.second.user.email, &n.second.user.name, &n.second.user.birthdate,
+                                 &n.second.user.phone, &n.second.user.city}){
+                size_t b = MemoryReport::heap(*s);
+                strings += b;
+                nstrings += b > 0;
             }
+            links += n.second.links.capacity() * sizeof(node*);
+            nlinks += n.second.links.capacity() > 0;
+            attrs += n.second.attrs.capacity() * sizeof(link_t);
+            nattrs += n.second.attrs.capacity() > 0;
+            followers += n.second.followers.capacity() * sizeof(node*);
+            nfollowers += n.second.followers.capacity() > 0;
+            edges += n.second.links.size();
+        }
+        if constexpr(Index::hashed) r.add("Tabela de usuários", nodes.bucket_count() * sizeof(void*), 1);
+        r.add("Nós", nodes.size() * (sizeof(std::pair<const std::string, node>) + Index::node_overhead), nodes.size());
+        r.add("Dados dos usuários (strings)", strings, nstrings);
+        r.add("Ligações", links, nlinks);
+        r.add("Atributos das ligações (data e peso)", attrs, nattrs);
+        r.add("Seguidores", followers, nfollowers);
+        if(csr_version != (unsigned long)-1) r.add("Topologia contígua (CSR)", csr.bytes(), 6);
+        if(packed_enabled) r.add("Topologia compactada", packed.bytes(), 12);
+        if(oracle_enabled) r.add("Índice de distâncias", oracle.bytes(), 2 + 4 * oracle.size());
+        r.add("Componentes", wcc.bytes() + scc.bytes(), 8);
+        if(time_version != (unsigned long)-1) r.add("Índice temporal das ligações", times.bytes(), times.blocks());
+        r.users = nodes.size();
+        r.links = edges;
+        return r;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name check_memory()
+     * @brief Compare the resident memory with the soft limit and warn once when it's exceeded
+    */
+    template<class Index, class Adjacency>
+    void network::BasicNetwork<Index, Adjacency>::check_memory(){
+        size_t rss = MemoryReport::resident();
+        if(rss > soft_limit && !over_limit){
+            over_limit = true;
+            std::cout << "Aviso: memória em uso (" << (rss >> 20) << " MB) acima do limite de "
+                      << (soft_limit >> 20) << " MB!" << std::endl;
+        }
+        else if(rss <= soft_limit) over_limit = false;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name khop_range()
+     * @brief Stream the users within k hops of a user, level by level
+     * @attention The range reads the cached layout: don't change the graph while iterating
+     * @param s --> const std::string: User email
+     * @param k --> unsigned int: Maximum number of hops
+     * @param followers --> bool: false: Users reached by following links, true: Users that reach s
+     * @return KHop --> Range of emails (empty if the user doesn't exist)
+    */
+    template<class Index, class Adjacency>
+    network::KHop network::BasicNetwork<Index, Adjacency>::khop_range(const std::string &s, unsigned int k, bool followers){
+        const CSR &g = layout();
+        return KHop(g, g.find(s), k, followers);
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name khop_count()
+     * @brief Number of users within k hops of a user (audience size), without storing them
+     * @param s --> const std::string: User email
+     * @param k --> unsigned int: Maximum number of hops
+     * @param followers --> bool: false: Out-links, true: In-links
+     * @return size_t --> Users reached (the user itself excluded)
+    */
+    template<class Index, class Adjacency>
+    size_t network::BasicNetwork<Index, Adjacency>::khop_count(const std::string &s, unsigned int k, bool followers){
+        return khop_range(s, k, followers).count();
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name khop()
+     * @brief Users within k hops of a user, closest first, limited to cap results
+     * @param s --> const std::string: User email
+     * @param k --> unsigned int: Maximum number of hops
+     * @param cap --> size_t: Maximum number of users returned
+     * @param followers --> bool: false: Out-links, true: In-links
+     * @return std::vector<std::string> --> Emails of the users reached
+    */
+    template<class Index, class Adjacency>
+    std::vector<std::string> network::BasicNetwork<Index, Adjacency>::khop(const std::string &s, unsigned int k, size_t cap, bool followers){
+        std::vector<std::string> ans;
+        if(!cap) return ans;
+        KHop range = khop_range(s, k, followers);
+        for(const auto &email : range){
+            ans.push_back(email);
+            if(ans.size() == cap) break;
         }
         return ans;
     }
@@ -242,13 +1186,18 @@ namespace network{
      * @namespace network
      * @class Network
      * @name create_dot()
-     * @brief Create the graph using dot language (graphviz dependence) to a file (.dot)
+     * @brief Create the graph using dot language (graphviz dependence) to a file (.dot).
+     *        Users are coloured by community when communities were detected
     */
-    void network::Network::create_dot() const{
+    template<class Index, class Adjacency>
+    void network::BasicNetwork<Index, Adjacency>::create_dot() const{
         std::string filename = "dot_exports/network.dot";
         std::ofstream dot(filename);
         dot << "Digraph{\n";
         for(auto n : nodes){
+            if(n.second.community)
+                dot << "\t\"" << n.first << "\" [style=filled, colorscheme=set312, fillcolor="
+                    << (n.second.community - 1) % 12 + 1 << "]\n";
             dot << "\t\"" << n.first << '"';
             if(!n.second.links.empty()){
                 dot << " -> { ";
@@ -262,6 +1211,284 @@ namespace network{
         dot << "}\n";
     }
 
+    /**
+     * @namespace network
+     * @class Network
+     * @name community()
+     * @brief Community of a user found by the last community detection
+     * @param s --> const std::string: User email
+     * @return unsigned int --> Community id (0: user doesn't exist or joined after the detection)
+    */
+    template<class Index, class Adjacency>
+    unsigned int network::BasicNetwork<Index, Adjacency>::community(const std::string &s){
+        auto user = find(s);
+        return user ? user->community : 0;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name community_members()
+     * @brief Users in the same community as a user (including the user)
+     * @param s --> const std::string: User email
+     * @return std::vector<std::string> --> Emails (empty if the user has no community)
+    */
+    template<class Index, class Adjacency>
+    std::vector<std::string> network::BasicNetwork<Index, Adjacency>::community_members(const std::string &s){
+        std::vector<std::string> ans;
+        unsigned int c = community(s);
+        if(!c) return ans;
+        for(const auto &n : nodes)
+            if(n.second.community == c) ans.push_back(n.first);
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name for_each_neighbour()
+     * @brief Visit the connections of a user (following, then followers; a mutual follow is
+     *        visited twice and self follows are skipped), as counted by the core numbers
+     * @param n --> const node*: User node
+     * @param fn --> Callable: fn(node*)
+    */
+    template<class Index, class Adjacency>
+    template<class F>
+    void network::BasicNetwork<Index, Adjacency>::for_each_neighbour(const node *n, F fn){
+        for(auto x : n->links) if(x != n) fn(x);
+        for(auto x : n->followers) if(x != n) fn(x);
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name core_index()
+     * @brief Compute the core number of every user (bucket algorithm, or level synchronous
+     *        peeling when there are several worker threads) if the graph changed in a way the
+     *        incremental maintenance doesn't follow (bulk loads, removed users)
+    */
+    template<class Index, class Adjacency>
+    void network::BasicNetwork<Index, Adjacency>::core_index(){
+        if(core_version == version) return;
+        const CSR &g = layout();
+        CoreDecomposition cores;
+        if(workers() > 1) cores.build_parallel(g);
+        else cores.build(g);
+        core_count.assign(cores.degeneracy() + 1, 0);
+        for(unsigned int v = 0; v < g.size(); v++){
+            find(g.ids[v])->core = cores.numbers()[v];
+            core_count[cores.numbers()[v]]++;
+        }
+        core_version = version;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name core_insert()
+     * @brief Update the core numbers after a follow (traversal algorithm): only users with
+     *        core r = min(core(u), core(v)) connected to the link through rising users can
+     *        rise, and only to r + 1. A user can only rise with more than r connections that
+     *        have a higher core or could rise themselves (core r and more than r connections
+     *        of core >= r), so the search only goes on from those users. Then candidates left
+     *        with r or fewer connections of core >= r are dropped, cascading to their
+     *        neighbours, and the remaining ones rise.
+     * @param u --> node*: Follower
+     * @param v --> node*: Followed user (the link is already in the lists)
+     * @return bool --> false: More than CORE_UPDATE_LIMIT users affected, nothing changed
+     *                  (the core numbers are rebuilt on the next query)
+    */
+    template<class Index, class Adjacency>
+    bool network::BasicNetwork<Index, Adjacency>::core_insert(node *u, node *v){
+        if(u == v) return true;
+        unsigned int r = std::min(u->core, v->core);
+        std::unordered_map<node*, unsigned int> cd;   // Connections of core >= r (computed once)
+        auto count = [&](node *w) -> unsigned int&{
+            auto it = cd.find(w);
+            if(it == cd.end()){
+                unsigned int c = 0;
+                for_each_neighbour(w, [&](node *x){ c += x->core >= r; });
+                it = cd.emplace(w, c).first;
+            }
+            return it->second;
+        };
+        std::unordered_set<node*> visited, out;
+        std::vector<node*> stack, sub, evict;
+        for(node *root : {u, v})
+            if(root->core == r && visited.insert(root).second) stack.push_back(root);
+        while(!stack.empty()){
+            if(sub.size() == CORE_UPDATE_LIMIT) return false;
+            node *w = stack.back();
+            stack.pop_back();
+            sub.push_back(w);
+            unsigned int pure = 0;
+            if(count(w) > r)
+                for_each_neighbour(w, [&](node *x){ pure += x->core > r || (x->core == r && count(x) > r); });
+            if(pure <= r){
+                out.insert(w);
+                evict.push_back(w);
+                continue;
+            }
+            for_each_neighbour(w, [&](node *x){
+                if(x->core == r && visited.insert(x).second) stack.push_back(x);
+            });
+        }
+        while(!evict.empty()){
+            node *w = evict.back();
+            evict.pop_back();
+            for_each_neighbour(w, [&](node *x){
+                if(x->core != r || out.count(x) || !visited.count(x)) return;
+                if(--count(x) <= r && out.insert(x).second) evict.push_back(x);
+            });
+        }
+        if(core_count.size() < r + 2) core_count.resize(r + 2, 0);
+        for(node *w : sub){
+            if(out.count(w)) continue;
+            w->core = r + 1;
+            core_count[r]--;
+            core_count[r + 1]++;
+        }
+        return true;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name core_remove()
+     * @brief Update the core numbers after an unfollow: only users with core
+     *        r = min(core(u), core(v)) can drop, and only to r - 1. Starting at u and v, a
+     *        user left with fewer than r connections of core >= r drops and its neighbours
+     *        of core r are checked next (their count is taken the first time they are
+     *        reached, then lowered once per link to a dropping user), so only the dropping
+     *        area is visited.
+     * @param u --> node*: Former follower
+     * @param v --> node*: Former followed user (the link is already out of the lists)
+     * @return bool --> false: More than CORE_UPDATE_LIMIT users affected, nothing changed
+    */
+    template<class Index, class Adjacency>
+    bool network::BasicNetwork<Index, Adjacency>::core_remove(node *u, node *v){
+        if(u == v) return true;
+        unsigned int r = std::min(u->core, v->core);
+        if(!r) return true;
+        std::unordered_map<node*, unsigned int> cd;
+        std::unordered_set<node*> out;
+        std::vector<node*> evict;
+        auto count = [&](node *w) -> unsigned int&{
+            auto it = cd.find(w);
+            if(it == cd.end()){
+                unsigned int c = 0;
+                for_each_neighbour(w, [&](node *x){ c += x->core >= r; });
+                it = cd.emplace(w, c).first;
+            }
+            return it->second;
+        };
+        for(node *root : {u, v})
+            if(root->core == r && count(root) < r && out.insert(root).second) evict.push_back(root);
+        while(!evict.empty()){
+            if(out.size() > CORE_UPDATE_LIMIT) return false;
+            node *w = evict.back();
+            evict.pop_back();
+            for_each_neighbour(w, [&](node *x){
+                if(x->core != r || out.count(x)) return;
+                if(--count(x) < r && out.insert(x).second) evict.push_back(x);
+            });
+        }
+        for(node *w : out){
+            w->core = r - 1;
+            core_count[r]--;
+            core_count[r - 1]++;
+        }
+        while(core_count.size() > 1 && !core_count.back()) core_count.pop_back();
+        return true;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name core_number()
+     * @brief Core number of a user: the largest k such that the user is in a group where
+     *        everyone has at least k connections inside the group
+     * @param s --> const std::string: User email
+     * @return unsigned int --> Core number (0 if the user doesn't exist)
+    */
+    template<class Index, class Adjacency>
+    unsigned int network::BasicNetwork<Index, Adjacency>::core_number(const std::string &s){
+        core_index();
+        auto user = find(s);
+        return user ? user->core : 0;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name degeneracy()
+     * @brief Largest core number of the network graph (the innermost core)
+     * @return unsigned int --> Degeneracy
+    */
+    template<class Index, class Adjacency>
+    unsigned int network::BasicNetwork<Index, Adjacency>::degeneracy(){
+        core_index();
+        unsigned int k = core_count.size();
+        while(k > 0 && !core_count[k - 1]) k--;
+        return k ? k - 1 : 0;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name core_members()
+     * @brief Users of the k-core (core number >= k)
+     * @param k --> unsigned int: Core
+     * @return std::vector<std::string> --> Emails
+    */
+    template<class Index, class Adjacency>
+    std::vector<std::string> network::BasicNetwork<Index, Adjacency>::core_members(unsigned int k){
+        core_index();
+        std::vector<std::string> ans;
+        for(const auto &n : nodes)
+            if(n.second.core >= k) ans.push_back(n.first);
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name remove_node()
+     * @brief Remove a user and all user connections without asking for confirmation
+     * @param s --> const std::string: User email
+     * @return error_t --> Struct defined in network.h to handle errors  
+    */
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::error_t
+    network::BasicNetwork<Index, Adjacency>::remove_node(const std::string &s){
+        errors.reset();
+        auto temp = find(s);
+        if(!temp){
+            errors.flag = true;
+            errors.errmsg = "O usuário não existe!";
+            return errors;
+        }
+        for(auto flwr : temp->followers){
+            if(flwr == temp) continue;
+            size_t at = detach(flwr->links, temp);
+            link_count--;
+            weighted_links -= flwr->attrs[at].weight != 1;
+            flwr->attrs.erase(flwr->attrs.begin() + at);
+        }
+        for(auto link : temp->links)
+            if(link != temp) detach(link->followers, temp);
+        link_count -= temp->links.size();
+        for(const auto &a : temp->attrs) weighted_links -= a.weight != 1;
+        if(time_version == version){
+            times.remove_user(temp);
+            time_version = version + 1;
+        }
+        nodes.erase(s);
+        wcc_stale = true;
+        version++;
+        return errors;
+    }
+
     /**
      * @namespace network
      * @class Network
@@ -270,7 +1497,9 @@ namespace network{
      * @param s --> const std::string: User email to be searched
      * @return error_t --> Struct defined in network.h to handle errors  
     */
-    network::Network::error_t network::Network::remove(const std::string &s){
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::error_t
+    network::BasicNetwork<Index, Adjacency>::remove(const std::string &s){
         errors.reset();
         auto temp = find(s);
         int op;
@@ -287,13 +1516,7 @@ namespace network{
         std::cin >> op;
         switch(op){
             case 1:
-                for(auto &n : nodes){
-                    auto &lnks = n.second.links;
-                    auto it = std::find(lnks.begin(), lnks.end(), temp);
-                    if(it != lnks.end()) lnks.erase(it);
-                }
-                nodes.erase(s);
-                return errors;
+                return remove_node(s);
             
             case 2:
                 errors.errmsg = "Operação cancelada!";
@@ -315,12 +1538,11 @@ namespace network{
      * @param s --> const std::string: User email to be searched
      * @return unsigned int --> Indegree number of the user node  
     */
-    unsigned int network::Network::indegree(const std::string &s) const{
-        unsigned int count = 0;
-        for(auto n : nodes)
-            for(auto link : n.second.links) 
-                if(link->user.email == s) count++;
-        return count;
+    template<class Index, class Adjacency>
+    unsigned int network::BasicNetwork<Index, Adjacency>::indegree(const std::string &s) const{
+        auto it = nodes.find(s);
+        if(it == nodes.end()) return 0;
+        return it->second.followers.size();
     }
 
     /**
@@ -331,7 +1553,8 @@ namespace network{
      * @param s --> const std::string: User email to be searched
      * @return unsigned int --> Outdegree number of the user node  
     */
-    unsigned int network::Network::outdegree(const std::string &s){
+    template<class Index, class Adjacency>
+    unsigned int network::BasicNetwork<Index, Adjacency>::outdegree(const std::string &s){
         auto pnode = find(s);
         if(!pnode) return 0;
         return pnode->links.size();
@@ -342,63 +1565,193 @@ namespace network{
      * @class Network
      * @name dijkstra()
      * @brief Get the shortest path between two users
-     * @attention All the costs (weight) of the graph are considered: 1
-     *            Also used to find the diameter of the graph
+     * @attention While every link weight is 1 the search is a breadth-first search (distance
+     *            index or contiguous layout); otherwise the cheapest path is searched with a
+     *            binary heap (weighted_path())
      * @param src --> const std::string: First user (Source)
      * @param dest --> const std::string: Second user (Destination)
      * @param flag --> bool: Used to show the path user by user (If false: Show) (False by default)
+     * @param weighted --> bool: Use the link weights (false: fewest links)
      * @return int --> Size of the path   
     */
-    int network::Network::dijkstra(const std::string &src, const std::string &dest, bool flag = false){
-        const long INF = (long)1e9;
+    template<class Index, class Adjacency>
+    int network::BasicNetwork<Index, Adjacency>::dijkstra(const std::string &src, const std::string &dest, bool flag,
+                                                          bool weighted)
+    {
         if(!find(src) || !find(dest)) return -1;
-        std::unordered_map<std::string, int> distances;
-        std::unordered_map<std::string, std::string> paths;
-        std::unordered_map<std::string, bool> visited;
-        for(const auto &n : nodes) 
-            distances[n.first] = INF;
-        distances[src] = 0;
-        while(true){
-            std::string min;
-            int mindist = INF;
-            for(const auto &n : nodes){
-                if(!visited[n.first] && distances[n.first] < mindist){
-                    min = n.first;
-                    mindist = distances[n.first];
+        if(!reachable(src, dest)) return 0;
+        if(weighted && weighted_links) return weighted_path(src, dest, flag);
+        if(oracle_enabled) return indexed_path(src, dest, flag);
+        if(packed_enabled) return layout_path(packed_layout(), src, dest, flag);
+        return layout_path(layout(), src, dest, flag);
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name indexed_path()
+     * @brief Shortest path using the distance index: from the source, always step to a
+     *        followed user whose indexed distance to the destination is one less
+     * @param src --> const std::string: First user (Source)
+     * @param dest --> const std::string: Second user (Destination)
+     * @param flag --> bool: Used to show the path user by user (If false: Show)
+     * @return int --> Size of the path (0 if there is no path)
+    */
+    template<class Index, class Adjacency>
+    int network::BasicNetwork<Index, Adjacency>::indexed_path(const std::string &src, const std::string &dest, bool flag){
+        DistanceOracle &idx = distance_oracle();
+        int d = idx.distance(src, dest);
+        if(d <= 0) return 0;
+        if(!flag){
+            std::vector<std::string> path = {src};
+            node *curr = find(src);
+            for(int left = d - 1; left >= 0; left--){
+                for(auto link : curr->links){
+                    if(idx.distance(link->user.email, dest) == left){
+                        curr = link;
+                        break;
+                    }
                 }
+                path.push_back(curr->user.email);
             }
-            if(min.empty() || mindist == INF) break;
-            visited[min] = true;
-            auto &node = nodes[min];
-            for(auto &link : node.links){
-                if(!visited[link->user.email]){
-                    int newdist = distances[min] + 1; // Considerei peso como 1
-                    if(newdist < distances[link->user.email]){
-                        distances[link->user.email] = newdist;
-                        paths[link->user.email] = min;
+            std::reverse(path.begin(), path.end());
+            print_path(src, dest, path, d);
+        }
+        return d;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name layout_path()
+     * @brief Shortest path with a breadth-first search over a contiguous layout
+     *        (CSR snapshot or compressed topology)
+     * @param g --> const G: Layout (CSR or CompressedCSR)
+     * @param src --> const std::string: First user (Source)
+     * @param dest --> const std::string: Second user (Destination)
+     * @param flag --> bool: Used to show the path user by user (If false: Show)
+     * @return int --> Size of the path (0 if there is no path)
+    */
+    template<class Index, class Adjacency>
+    template<class G>
+    int network::BasicNetwork<Index, Adjacency>::layout_path(const G &g, const std::string &src, const std::string &dest, bool flag){
+        const unsigned int NONE = -1;
+        unsigned int s = g.find(src), t = g.find(dest);
+        if(s == t) return 0;
+        std::vector<unsigned int> parent(g.size(), NONE);
+        std::vector<unsigned int> frontier = {s}, next;
+        parent[s] = s;
+        while(!frontier.empty() && parent[t] == NONE){
+            next.clear();
+            for(unsigned int u : frontier){
+                g.for_each_out(u, [&](unsigned int w){
+                    if(parent[w] == NONE){
+                        parent[w] = u;
+                        next.push_back(w);
                     }
-                }
+                });
             }
+            frontier.swap(next);
         }
-        if(distances[dest] == INF) return 0;
+        if(parent[t] == NONE) return 0;
         std::vector<std::string> path;
-        std::string curr = dest;
-        while(curr != src){
-            path.push_back(curr);
-            curr = paths[curr];
-        }
+        for(unsigned int v = t; v != s; v = parent[v]) path.push_back(g.ids[v]);
         path.push_back(src);
-        if(!flag){
-            std::cout << "Menor caminho de " << src << " para " << dest << ": ";
-            for(auto it = path.rbegin(); it != path.rend(); ++it){
-                std::cout << *it;
-                if(it + 1 != path.rend()) std::cout << " -> ";
+        int size = path.size() - 1;
+        if(!flag) print_path(src, dest, path, size);
+        return size;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name cheapest_path()
+     * @brief Dijkstra with a binary heap (lazy deletion: an outdated entry is skipped when
+     *        popped), stopping as soon as the destination is settled
+     * @param g --> const CSR: Snapshot with the link weights
+     * @param s --> unsigned int: Source vertex id
+     * @param t --> unsigned int: Destination vertex id
+     * @param parent --> std::vector<unsigned int>: Output, previous vertex on the cheapest paths
+     * @return double --> Cost of the cheapest path, -1 if there is no path
+    */
+    template<class Index, class Adjacency>
+    double network::BasicNetwork<Index, Adjacency>::cheapest_path(const CSR &g, unsigned int s, unsigned int t,
+                                                                  std::vector<unsigned int> &parent)
+    {
+        const unsigned int NONE = -1;
+        typedef std::pair<double, unsigned int> entry;
+        std::vector<double> dist(g.size(), std::numeric_limits<double>::infinity());
+        std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap;
+        parent.assign(g.size(), NONE);
+        dist[s] = 0;
+        parent[s] = s;
+        heap.emplace(0.0, s);
+        while(!heap.empty()){
+            auto [d, u] = heap.top();
+            heap.pop();
+            if(d > dist[u]) continue;
+            if(u == t) return d;
+            for(unsigned int e = g.out_offsets[u]; e < g.out_offsets[u + 1]; e++){
+                unsigned int w = g.out_edges[e];
+                double nd = d + g.weight(e);
+                if(nd < dist[w]){
+                    dist[w] = nd;
+                    parent[w] = u;
+                    heap.emplace(nd, w);
+                }
             }
-            std::cout << std::endl;
-            std::cout << "Tamanho do caminho: " << distances[dest] << std::endl;
-            std::cout << std::endl;
         }
-        return distances[dest];
+        return -1;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name weighted_path()
+     * @brief Cheapest path using the link weights (contiguous layout)
+     * @param src --> const std::string: First user (Source)
+     * @param dest --> const std::string: Second user (Destination)
+     * @param flag --> bool: Used to show the path user by user (If false: Show)
+     * @return int --> Size of the path (0 if there is no path)
+    */
+    template<class Index, class Adjacency>
+    int network::BasicNetwork<Index, Adjacency>::weighted_path(const std::string &src, const std::string &dest, bool flag){
+        const CSR &g = layout();
+        unsigned int s = g.find(src), t = g.find(dest);
+        if(s == t) return 0;
+        std::vector<unsigned int> parent;
+        double cost = cheapest_path(g, s, t, parent);
+        if(cost < 0) return 0;
+        std::vector<std::string> path;
+        for(unsigned int v = t; v != s; v = parent[v]) path.push_back(g.ids[v]);
+        path.push_back(src);
+        int size = path.size() - 1;
+        if(!flag) print_path(src, dest, path, size, cost);
+        return size;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name print_path()
+     * @brief Show a path user by user
+     * @param path --> const std::vector<std::string>: Path from dest back to src
+     * @param size --> int: Size of the path
+     * @param cost --> double: Sum of the link weights (0: not shown)
+    */
+    template<class Index, class Adjacency>
+    void network::BasicNetwork<Index, Adjacency>::print_path(const std::string &src, const std::string &dest,
+                                      const std::vector<std::string> &path, int size, double cost) const
+    {
+        std::cout << "Menor caminho de " << src << " para " << dest << ": ";
+        for(auto it = path.rbegin(); it != path.rend(); ++it){
+            std::cout << *it;
+            if(it + 1 != path.rend()) std::cout << " -> ";
+        }
+        std::cout << std::endl;
+        std::cout << "Tamanho do caminho: " << size << std::endl;
+        if(cost) std::cout << "Custo do caminho (soma dos pesos): " << cost << std::endl;
+        std::cout << std::endl;
     }
 
     /**
@@ -412,7 +1765,9 @@ namespace network{
      * @param dest --> const std::string: Second user (Destination) 
      * @return error_t --> Struct defined in network.h to handle errors  
     */
-    network::Network::error_t network::Network::shortest_path(const std::string &src, const std::string &dest){
+    template<class Index, class Adjacency>
+    typename network::BasicNetwork<Index, Adjacency>::error_t
+    network::BasicNetwork<Index, Adjacency>::shortest_path(const std::string &src, const std::string &dest){
         errors.reset();
         int dist = dijkstra(src, dest);
         switch(dist){
@@ -429,24 +1784,218 @@ namespace network{
             default:
                 return errors;
         }
-    } 
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name shortest_paths()
+     * @brief Answer many shortest path queries at once. Queries are grouped by source, or by
+     *        destination over the followers lists when that gives fewer groups, and every
+     *        group runs a single breadth-first search that stops once all its targets are
+     *        reached. The groups are spread over the worker threads (per-thread buffers);
+     *        pairs without a path are dropped first by the reachability index.
+     * @param queries --> const std::vector<std::pair>: (source, destination) emails
+     * @param paths --> bool: Also return the users of every path
+     * @return std::vector<path_t> --> Distance (and path) of every query, in input order
+    */
+    template<class Index, class Adjacency>
+    std::vector<typename network::BasicNetwork<Index, Adjacency>::path_t>
+    network::BasicNetwork<Index, Adjacency>::shortest_paths(const std::vector<std::pair<std::string, std::string>> &queries,
+                                                            bool paths)
+    {
+        Reachability &scc = strong_index();
+        if(packed_enabled) return shortest_paths(packed_layout(), scc, queries, paths);
+        return shortest_paths(layout(), scc, queries, paths);
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name shortest_paths()
+     * @brief Batch breadth-first searches of shortest_paths() over one layout
+     * @param g --> const G: Layout the reachability index was built on (CSR or CompressedCSR)
+     * @param scc --> Reachability: Index over the vertex ids of g
+     * @param queries --> const std::vector<std::pair>: (source, destination) emails
+     * @param paths --> bool: Also return the users of every path
+     * @return std::vector<path_t> --> Distance (and path) of every query, in input order
+    */
+    template<class Index, class Adjacency>
+    template<class G>
+    std::vector<typename network::BasicNetwork<Index, Adjacency>::path_t>
+    network::BasicNetwork<Index, Adjacency>::shortest_paths(const G &g, Reachability &scc,
+                                                            const std::vector<std::pair<std::string, std::string>> &queries,
+                                                            bool paths)
+    {
+        const unsigned int NONE = -1;
+        std::vector<path_t> ans(queries.size());
+        std::vector<unsigned int> src(queries.size()), dst(queries.size());
+        std::vector<size_t> pending;
+        for(size_t i = 0; i < queries.size(); i++){
+            int s = g.find(queries[i].first), t = g.find(queries[i].second);
+            if(s < 0 || t < 0) continue;
+            if(s == t){
+                ans[i].distance = 0;
+                if(paths) ans[i].path.push_back(g.ids[s]);
+                continue;
+            }
+            if(!scc.reachable(s, t)) continue;
+            src[i] = s;
+            dst[i] = t;
+            pending.push_back(i);
+        }
+        auto distinct = [&](const std::vector<unsigned int> &end){
+            std::vector<unsigned int> v;
+            v.reserve(pending.size());
+            for(size_t i : pending) v.push_back(end[i]);
+            std::sort(v.begin(), v.end());
+            return std::unique(v.begin(), v.end()) - v.begin();
+        };
+        bool backward = distinct(dst) < distinct(src);
+        const std::vector<unsigned int> &root = backward ? dst : src, &target = backward ? src : dst;
+        std::stable_sort(pending.begin(), pending.end(), [&](size_t a, size_t b){ return root[a] < root[b]; });
+        std::vector<size_t> groups;
+        for(size_t i = 0; i < pending.size(); i++)
+            if(!i || root[pending[i]] != root[pending[i - 1]]) groups.push_back(i);
+        groups.push_back(pending.size());
+        struct buffers_t{
+            std::vector<unsigned int> dist;
+            std::vector<unsigned int> parent;   // Previous user on the path from the group root
+            std::vector<unsigned int> mark;     // Group (+1) that has the user as a target
+            std::vector<unsigned int> queue;
+        };
+        std::vector<buffers_t> local(workers());
+        parallel_for(groups.size() - 1, [&](size_t k, unsigned int tid){
+            buffers_t &b = local[tid];
+            if(b.dist.empty()){
+                b.dist.assign(g.size(), NONE);
+                b.mark.assign(g.size(), 0);
+                if(paths) b.parent.resize(g.size());
+            }
+            unsigned int r = root[pending[groups[k]]], stamp = k + 1;
+            size_t left = 0;
+            for(size_t j = groups[k]; j < groups[k + 1]; j++){
+                unsigned int t = target[pending[j]];
+                if(b.mark[t] != stamp){
+                    b.mark[t] = stamp;
+                    left++;
+                }
+            }
+            b.queue.assign(1, r);
+            b.dist[r] = 0;
+            for(size_t head = 0; head < b.queue.size() && left; head++){
+                unsigned int u = b.queue[head];
+                auto visit = [&](unsigned int w){
+                    if(!left || b.dist[w] != NONE) return;
+                    b.dist[w] = b.dist[u] + 1;
+                    if(paths) b.parent[w] = u;
+                    b.queue.push_back(w);
+                    if(b.mark[w] == stamp) left--;
+                };
+                if(backward) g.for_each_in(u, visit);
+                else g.for_each_out(u, visit);
+            }
+            for(size_t j = groups[k]; j < groups[k + 1]; j++){
+                size_t i = pending[j];
+                unsigned int t = target[i];
+                if(b.dist[t] == NONE) continue;
+                ans[i].distance = b.dist[t];
+                if(!paths) continue;
+                for(unsigned int v = t; v != r; v = b.parent[v]) ans[i].path.push_back(g.ids[v]);
+                ans[i].path.push_back(g.ids[r]);
+                if(!backward) std::reverse(ans[i].path.begin(), ans[i].path.end());
+            }
+            for(unsigned int v : b.queue) b.dist[v] = NONE;
+        }, 1);
+        return ans;
+    }
 
     /**
      * @namespace network
-     * @overload --> "<<" operator
-     * @brief Friend function (Not a member function of the class but have access to private members)
-     *        Used to bind user information in a output stream (ostream)
-     * @param os --> std::ostream: Output stream that store the node data 
-     * @param n --> Network::node: Network class user node (user informations)
-     * @return os --> Output stream with the user informations
+     * @class Network
+     * @name time_index()
+     * @brief Get the links ordered by creation time. It follows every follow/unfollow and
+     *        removed user; after a bulk load it is rebuilt at once (one sort of all the links)
+     * @return TimeIndex --> Per-user and global time ordered links
     */
-    std::ostream& operator<<(std::ostream &os, const network::Network::node &n){
-        os << "Email: " << n.user.email << std::endl;
-        os << "Nome: " << n.user.name << std::endl;
-        os << "Data de nascimento: " << n.user.birthdate << std::endl;
-        os << "Número de telefone: " << n.user.phone << std::endl;
-        os << "Cidade: " << n.user.city << std::endl;
-        return os;
+    template<class Index, class Adjacency>
+    const network::TimeIndex<const typename network::BasicNetwork<Index, Adjacency>::node*>&
+    network::BasicNetwork<Index, Adjacency>::time_index(){
+        if(time_version == version) return times;
+        std::vector<typename TimeIndex<const node*>::edge> edges;
+        size_t total = 0;
+        for(const auto &n : nodes) total += n.second.links.size();
+        edges.reserve(total);
+        for(const auto &n : nodes)
+            for(size_t i = 0; i < n.second.links.size(); i++)
+                edges.push_back({n.second.attrs[i].time, &n.second, n.second.links[i], n.second.attrs[i].weight});
+        times.build(std::move(edges));
+        time_version = version;
+        return times;
     }
 
+    /**
+     * @namespace network
+     * @class Network
+     * @name time_window()
+     * @brief Followers (or followed users) of a user whose link was created within a time window
+     * @param s --> const std::string: User email
+     * @param from --> unsigned int: Window start, Unix time (inclusive)
+     * @param to --> unsigned int: Window end, Unix time (inclusive)
+     * @param followers --> bool: true: Followers gained, false: Users followed
+     * @return std::vector<std::pair> --> (email, creation time), oldest first (empty if the user doesn't exist)
+    */
+    template<class Index, class Adjacency>
+    std::vector<std::pair<std::string, unsigned int>>
+    network::BasicNetwork<Index, Adjacency>::time_window(const std::string &s, unsigned int from,
+                                                         unsigned int to, bool followers)
+    {
+        std::vector<std::pair<std::string, unsigned int>> ans;
+        const node *u = find(s);
+        if(!u) return ans;
+        const auto &index = time_index();
+        auto r = followers ? index.in_range(u, from, to) : index.out_range(u, from, to);
+        ans.reserve(r.second - r.first);
+        for(auto p = r.first; p != r.second; ++p) ans.emplace_back(p->user->user.email, p->time);
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class Network
+     * @name snapshot()
+     * @brief The graph as it was at a given time: every current user and the links created
+     *        up to it (only the log partitions before the time are read)
+     * @attention Unfollowed links and removed users aren't kept, so they don't show up in
+     *            past snapshots either
+     * @param time --> unsigned int: Unix time (inclusive)
+     * @return CSR --> Contiguous graph of the snapshot (same layout as the analytics use)
+    */
+    template<class Index, class Adjacency>
+    network::CSR network::BasicNetwork<Index, Adjacency>::snapshot(unsigned int time){
+        std::vector<std::string> vertices;
+        vertices.reserve(nodes.size());
+        std::unordered_map<const node*, unsigned int> ids;
+        ids.reserve(nodes.size());
+        for(const auto &n : nodes){
+            ids[&n.second] = vertices.size();
+            vertices.push_back(n.first);
+        }
+        std::vector<std::pair<unsigned int, unsigned int>> edges;
+        std::vector<float> weights;
+        time_index().for_each_until(time, [&](const node *src, const node *dest, unsigned int, float weight){
+            edges.emplace_back(ids[src], ids[dest]);
+            if(weighted_links) weights.push_back(weight);
+        });
+        CSR g;
+        g.assign(std::move(vertices), edges, weights);
+        return g;
+    }
+
+    // Compile every member with every policy pair (BasicNetwork<> is one of them, chosen at build time)
+    template class BasicNetwork<HashIndex, VectorAdjacency>;
+    template class BasicNetwork<HashIndex, SortedAdjacency>;
+    template class BasicNetwork<OrderedIndex, VectorAdjacency>;
+    template class BasicNetwork<OrderedIndex, SortedAdjacency>;
+
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
  * @headerfile network.h (header file)
  * 
  * Network class interface/structure
+ * BasicNetwork is a template over the user table and adjacency policies (policies.h);
+ * Network is the application graph, the current behavior by default.
  * Include guard
  * 
 */
@@ -11,13 +13,35 @@
 #ifndef NETWORK_H
 #define NETWORK_H
 
+#include <algorithm>
+#include <cmath>
+#include <ostream>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
+#include "lookup.h"
+#include "policies.h"
+#include "csr.h"
+#include "compressed.h"
+#include "components.h"
+#include "oracle.h"
+#include "khop.h"
+#include "reorder.h"
+#include "memory.h"
+#include "cores.h"
+#include "timeindex.h"
+#include "../Jobs/jobs.h"
 
 namespace network{
 
-class Network{
+template<class Index = DefaultIndex, class Adjacency = DefaultAdjacency>
+class BasicNetwork{
+public:
+    struct link_t{
+        unsigned int time = 0;   // Creation (Unix time in seconds, 0: unknown)
+        float weight = 1;        // Interaction weight, the cost of the link in the weighted paths
+    };
+
 protected:
     struct userdata{
         std::string email;
@@ -30,6 +54,11 @@ protected:
     struct node{
         userdata user;
         std::vector<node*> links;
+        std::vector<link_t> attrs;      // Attributes of the links (same positions)
+        std::vector<node*> followers;   // Reverse links (users that follow this one)
+        unsigned int uid = 0;   // Element of the weak components union-find
+        unsigned int community = 0;   // Last detected community (0: none)
+        unsigned int core = 0;        // Core number (valid while core_version is current)
         node(){}
         node(const std::string &mail, const std::string &nm,
              const std::string &brth, const std::string &phne,
@@ -52,26 +81,100 @@ protected:
         }
     };
     
-    std::unordered_map<std::string, node> nodes;
+    typename Index::template map<node> nodes;
     error_t errors;
+    unsigned long version = 0;       // Incremented on every graph mutation
+    unsigned long csr_version = -1;  // Graph version of the cached layout (-1: not built)
+    CSR csr;
+    DisjointSet wcc;
+    bool wcc_stale = false;           // Set when a link/user is removed (union-find can't split)
+    Reachability scc;
+    unsigned long scc_version = -1;
+    DistanceOracle oracle;
+    bool oracle_enabled = false;
+    unsigned long oracle_version = -1;
+    CompressedCSR packed;
+    bool packed_enabled = false;
+    unsigned long packed_version = -1;
+    VertexOrder::method_t order_method = VertexOrder::NONE;   // Applied to the contiguous layouts
+    std::vector<unsigned int> core_count;   // Users per core number
+    unsigned long core_version = -1;
+    TimeIndex<const node*> times;       // Links by creation time (per user and global)
+    unsigned long time_version = -1;
+    size_t link_count = 0;            // Links in the network (kept up to date by every change)
+    size_t weighted_links = 0;        // Links with weight != 1 (0: paths are breadth-first searches)
+    size_t soft_limit = 0;            // Resident memory warning threshold in bytes (0: disabled)
+    bool over_limit = false;          // Warning already shown (re-armed below the limit)
 
-    int dijkstra(const std::string &src, const std::string &dest, bool flag);
+    int dijkstra(const std::string &src, const std::string &dest, bool flag = false, bool weighted = true);
+    int weighted_path(const std::string &src, const std::string &dest, bool flag);
+    static double cheapest_path(const CSR &g, unsigned int s, unsigned int t, std::vector<unsigned int> &parent);
+    int indexed_path(const std::string &src, const std::string &dest, bool flag);
+    template<class G> int layout_path(const G &g, const std::string &src, const std::string &dest, bool flag);
+    void print_path(const std::string &src, const std::string &dest,
+                    const std::vector<std::string> &path, int size, double cost = 0) const;
     double network_indegree_rate();
     double network_outdegree_rate();
     int network_graph_diameter();
+    template<class G> static int graph_diameter(const G &g, jobs::Control *control = nullptr);
     std::string most_followed_user();
+    const CSR& layout();
+    DisjointSet& weak_index();
+    Reachability& strong_index();
+    DistanceOracle& distance_oracle();
+    const CompressedCSR& packed_layout();
+    void check_memory();
+    void core_index();
+    bool core_insert(node *u, node *v);
+    bool core_remove(node *u, node *v);
+    const TimeIndex<const node*>& time_index();
+    std::vector<std::pair<std::string, unsigned int>> time_window(const std::string &s, unsigned int from,
+                                                                 unsigned int to, bool followers);
+    template<class F> static void for_each_neighbour(const node *n, F fn);
+    static size_t position(const std::vector<node*> &list, const node *n);
+    static bool contains(const std::vector<node*> &list, const node *n) { return position(list, n) != list.size(); } // Inline
+    static size_t attach(std::vector<node*> &list, node *n);
+    static size_t detach(std::vector<node*> &list, const node *n);
+    static bool valid_weight(float w) { return std::isfinite(w) && w >= 0; } // Inline
 
 public:
-    Network();
-    Network(const node &n);
-    ~Network();
+    static constexpr size_t CORE_UPDATE_LIMIT = 4096;   // Users a follow/unfollow may revisit before a rebuild
+    static constexpr size_t MAX_MEMORY_LIMIT_MB = 1 << 20; // Largest soft memory limit accepted (1 TB)
+
+    struct path_t{
+        int distance = -1;                // As distance(): -1 no path (or a user doesn't exist), 0 same user
+        std::vector<std::string> path;    // src, ..., dest (if asked and there is a path)
+    };
+
+    enum status_t{
+        OK,
+        NOT_FOUND,         // A user doesn't exist
+        ALREADY_FOLLOWS,
+        NOT_FOLLOWING,
+        INVALID_WEIGHT     // Negative, infinite or not a number
+    };
+
+    BasicNetwork();
+    BasicNetwork(const node &n);
+    ~BasicNetwork();
     error_t insert_node(const std::string &mail, const std::string &nm,
                         const std::string &brth, const std::string &phne,
                         const std::string &cty);
     size_t size() const { return nodes.size(); } // Inline
-    node* find(const std::string &s);
+    size_t links() const { return link_count; } // Inline
+    node* find(std::string_view s);
+    status_t add_link(std::string_view src, std::string_view dest, link_t attr = {});
+    status_t remove_link(std::string_view src, std::string_view dest);
     error_t follow(const std::string &src, const std::string &dest);
     error_t unfollow(const std::string &src, const std::string &dest);
+    size_t insert_links(const std::vector<std::pair<std::string, std::string>> &pairs,
+                        const std::vector<link_t> &attrs = {}, std::vector<status_t> *status = nullptr);
+    std::vector<status_t> follow_many(const std::vector<std::pair<std::string, std::string>> &pairs);
+    std::vector<status_t> unfollow_many(const std::vector<std::pair<std::string, std::string>> &pairs);
+    std::vector<status_t> remove_many(const std::vector<std::string> &users);
+    const link_t* link(std::string_view src, std::string_view dest);
+    status_t link_weight(std::string_view src, std::string_view dest, float weight);
+    void reserve(size_t n) { if constexpr(Index::hashed) nodes.reserve(n); } // Inline
     void create_dot() const;
     void list_user(const std::string &s);
     void list_users();
@@ -79,12 +182,83 @@ public:
     unsigned int outdegree(const std::string &s);
     unsigned int degree(const std::string &s) { return indegree(s) + outdegree(s); } // Inline
     error_t remove(const std::string &s);
+    error_t remove_node(const std::string &s);
     error_t shortest_path(const std::string &src, const std::string &dest);
-    std::unordered_map<std::string, node> get_nodes() const { return nodes; } // Inline
-    friend std::ostream& operator<<(std::ostream &os, const node &n);
+    std::vector<path_t> shortest_paths(const std::vector<std::pair<std::string, std::string>> &queries,
+                                       bool paths = false);
+    bool reachable(const std::string &src, const std::string &dest);
+    unsigned int weak_components() { return weak_index().sets(); } // Inline
+    unsigned int strong_components() { return strong_index().components(); } // Inline
+    std::vector<unsigned int> weak_component_sizes();
+    std::vector<unsigned int> strong_component_sizes() { return strong_index().sizes(); } // Inline
+    void distance_index(bool enable);
+    bool distance_index() const { return oracle_enabled; } // Inline
+    int distance(const std::string &src, const std::string &dest);
+    double weighted_distance(const std::string &src, const std::string &dest);
+    void compressed_layout(bool enable);
+    bool compressed_layout() const { return packed_enabled; } // Inline
+    size_t compressed_bytes() { return packed_enabled ? packed_layout().bytes() : 0; } // Inline
+    void vertex_order(VertexOrder::method_t m);
+    VertexOrder::method_t vertex_order() const { return order_method; } // Inline
+    std::string dump_distance_index();
+    bool load_distance_index(const std::string &data);
+    unsigned long fingerprint() const;
+    MemoryReport memory_report() const;
+    void memory_limit(size_t mb) { soft_limit = mb << 20; over_limit = false; } // Inline
+    KHop khop_range(const std::string &s, unsigned int k, bool followers = false);
+    size_t khop_count(const std::string &s, unsigned int k, bool followers = false);
+    std::vector<std::string> khop(const std::string &s, unsigned int k, size_t cap, bool followers = false);
+    unsigned int community(const std::string &s);
+    unsigned int core_number(const std::string &s);
+    unsigned int degeneracy();
+    std::vector<std::string> core_members(unsigned int k);
+    std::vector<std::string> community_members(const std::string &s);
+    std::vector<std::pair<std::string, unsigned int>> followers_between(const std::string &s, unsigned int from,
+                                                                       unsigned int to = -1) { return time_window(s, from, to, true); } // Inline
+    std::vector<std::pair<std::string, unsigned int>> following_between(const std::string &s, unsigned int from,
+                                                                       unsigned int to = -1) { return time_window(s, from, to, false); } // Inline
+    size_t links_between(unsigned int from, unsigned int to = -1) { return time_index().count(from, to); } // Inline
+    CSR snapshot(unsigned int time);
+    typename Index::template map<node> get_nodes() const { return nodes; } // Inline
+    template<class UserFn, class LinkFn>
+    void visit(UserFn on_user, LinkFn on_link) const{ // Inline (users first, then links with their attributes)
+        for(const auto &n : nodes)
+            on_user(n.second.user.email, n.second.user.name, n.second.user.birthdate,
+                    n.second.user.phone, n.second.user.city);
+        for(const auto &n : nodes)
+            for(size_t i = 0; i < n.second.links.size(); i++)
+                on_link(n.first, n.second.links[i]->user.email, n.second.attrs[i]);
+    }
+
+protected:
+    template<class G> std::vector<path_t> shortest_paths(const G &g, Reachability &scc,
+                                                         const std::vector<std::pair<std::string, std::string>> &queries,
+                                                         bool paths);
+
+public:
+
+    /**
+     * @namespace network
+     * @overload --> "<<" operator
+     * @brief Friend function (Not a member function of the class but have access to private members).
+     *        Used to bind user information in a output stream (ostream)
+     * @param os --> std::ostream: Output stream that store the node data 
+     * @param n --> Network::node: Network class user node (user informations)
+     * @return os --> Output stream with the user informations
+    */
+    friend std::ostream& operator<<(std::ostream &os, const node &n){
+        os << "Email: " << n.user.email << std::endl;
+        os << "Nome: " << n.user.name << std::endl;
+        os << "Data de nascimento: " << n.user.birthdate << std::endl;
+        os << "Número de telefone: " << n.user.phone << std::endl;
+        os << "Cidade: " << n.user.city << std::endl;
+        return os;
+    }
 
 }; 
 
+using Network = BasicNetwork<>;   // Application graph (policies chosen at build time)
+
 } // namespace network
 
 #endif
\ No newline at end of file
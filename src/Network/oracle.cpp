@@ -0,0 +1,355 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file oracle.cpp (.cpp file) (implementation file)
+ * 
+ * DistanceOracle class member functions implementation
+ * 
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "oracle.h"
+#include "parallel.h"
+
+namespace network{
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name build()
+     * @brief Build the labels from scratch. Users are ranked by degree and a pruned BFS
+     *        (forward for in-labels, backward for out-labels) is run from every hub in rank
+     *        order. After the first hubs, BFSs run in parallel batches that only prune with
+     *        the labels of previous batches: labels may get slightly larger, never wrong.
+     * @param g --> const CSR: Graph snapshot
+    */
+    void network::DistanceOracle::build(const CSR &g){
+        unsigned int n = g.size();
+        std::vector<unsigned int> vertices(n);
+        for(unsigned int v = 0; v < n; v++) vertices[v] = v;
+        std::sort(vertices.begin(), vertices.end(), [&](unsigned int a, unsigned int b){
+            unsigned int da = g.outdegree(a) + g.indegree(a), db = g.outdegree(b) + g.indegree(b);
+            return da > db || (da == db && a < b);
+        });
+        order.resize(n);
+        ranks.clear();
+        ranks.reserve(n);
+        for(unsigned int r = 0; r < n; r++){
+            order[r] = g.ids[vertices[r]];
+            ranks[order[r]] = r;
+        }
+        attach(g);
+        lin.assign(n, {});
+        lout.assign(n, {});
+
+        const unsigned int SEQUENTIAL_HUBS = 64;
+        unsigned int nthreads = workers();
+        std::vector<std::vector<unsigned int>> scratch(nthreads, std::vector<unsigned int>(n, INF));
+        std::vector<std::vector<std::pair<unsigned int, unsigned int>>> found;
+        unsigned int k = 0;
+        while(k < n){
+            unsigned int batch = k < SEQUENTIAL_HUBS ? 1 : std::min(nthreads, n - k);
+            found.assign(2 * batch, {});
+            parallel_for(2 * batch, [&](size_t i, unsigned int tid){
+                pruned_bfs(k + i / 2, i % 2 == 0, found[i], scratch[tid]);
+            }, 1);
+            for(unsigned int i = 0; i < 2 * batch; i++){
+                unsigned int hub = k + i / 2;
+                auto &labels = i % 2 == 0 ? lin : lout;
+                for(const auto &f : found[i]) labels[f.first].push_back({hub, f.second});
+            }
+            k += batch;
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name attach()
+     * @brief Build the rank space adjacency (used by the incremental updates)
+    */
+    void network::DistanceOracle::attach(const CSR &g){
+        unsigned int n = g.size();
+        out_adj.assign(n, {});
+        in_adj.assign(n, {});
+        std::vector<unsigned int> rank_of(n);
+        for(unsigned int v = 0; v < n; v++) rank_of[v] = ranks.at(g.ids[v]);
+        for(unsigned int v = 0; v < n; v++){
+            for(const unsigned int *w = g.out_begin(v); w != g.out_end(v); ++w){
+                out_adj[rank_of[v]].push_back(rank_of[*w]);
+                in_adj[rank_of[*w]].push_back(rank_of[v]);
+            }
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name pruned_bfs()
+     * @brief BFS from a hub that stops at every vertex whose distance is already
+     *        covered by the current labels
+     * @param hub --> unsigned int: Hub rank
+     * @param forward --> bool: true: follow out-links (in-labels), false: in-links (out-labels)
+     * @param found --> std::vector: (vertex rank, distance) pairs to be labeled
+     * @param dist --> std::vector<unsigned int>: Scratch distances (INF filled, restored on return)
+    */
+    void network::DistanceOracle::pruned_bfs(unsigned int hub, bool forward,
+                                             std::vector<std::pair<unsigned int, unsigned int>> &found,
+                                             std::vector<unsigned int> &dist) const
+    {
+        std::vector<unsigned int> queue = {hub};
+        dist[hub] = 0;
+        for(size_t head = 0; head < queue.size(); head++){
+            unsigned int u = queue[head];
+            unsigned int d = dist[u];
+            if((forward ? query(hub, u) : query(u, hub)) <= d) continue;
+            found.emplace_back(u, d);
+            for(unsigned int w : forward ? out_adj[u] : in_adj[u]){
+                if(dist[w] == INF){
+                    dist[w] = d + 1;
+                    queue.push_back(w);
+                }
+            }
+        }
+        for(unsigned int u : queue) dist[u] = INF;
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name query()
+     * @brief Merge the out-label of s with the in-label of t (both sorted by hub)
+     * @return unsigned int --> Distance, INF if t isn't reachable from s
+    */
+    unsigned int network::DistanceOracle::query(unsigned int s, unsigned int t) const{
+        const auto &a = lout[s], &b = lin[t];
+        unsigned int ans = INF;
+        size_t i = 0, j = 0;
+        while(i < a.size() && j < b.size()){
+            if(a[i].hub < b[j].hub) i++;
+            else if(b[j].hub < a[i].hub) j++;
+            else{
+                ans = std::min(ans, a[i].dist + b[j].dist);
+                i++; j++;
+            }
+        }
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name distance()
+     * @brief Exact shortest path length between two users
+     * @param src --> std::string_view: First user (Source)
+     * @param dest --> std::string_view: Second user (Destination)
+     * @return int --> Distance, -1 if there is no path or a user isn't indexed
+    */
+    int network::DistanceOracle::distance(std::string_view src, std::string_view dest) const{
+        auto s = lookup(ranks, src);
+        if(s == ranks.end()) return -1;
+        unsigned int a = s->second;
+        auto t = lookup(ranks, dest);
+        if(t == ranks.end()) return -1;
+        unsigned int d = query(a, t->second);
+        return d == INF ? -1 : (int)d;
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name add_vertex()
+     * @brief Index a new user (lowest rank, labeled only with itself)
+    */
+    void network::DistanceOracle::add_vertex(const std::string &s){
+        unsigned int r = order.size();
+        order.push_back(s);
+        ranks[s] = r;
+        out_adj.emplace_back();
+        in_adj.emplace_back();
+        lin.push_back({{r, 0}});
+        lout.push_back({{r, 0}});
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name add_edge()
+     * @brief Patch the labels after a new link: every hub that reaches src resumes its
+     *        pruned BFS from dest, and every hub reached from dest resumes its backward
+     *        BFS from src (incremental PLL).
+     * @param src --> std::string_view: First user of the link
+     * @param dest --> std::string_view: Second user of the link
+    */
+    void network::DistanceOracle::add_edge(std::string_view src, std::string_view dest){
+        unsigned int a = lookup(ranks, src)->second, b = lookup(ranks, dest)->second;
+        out_adj[a].push_back(b);
+        in_adj[b].push_back(a);
+        std::vector<entry> forward = lin[a], backward = lout[b];
+        for(const auto &e : forward) resume(e.hub, b, e.dist + 1, true);
+        for(const auto &e : backward) resume(e.hub, a, e.dist + 1, false);
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name resume()
+     * @brief Pruned BFS of a hub restarted from one vertex, inserting/improving label entries
+    */
+    void network::DistanceOracle::resume(unsigned int hub, unsigned int start, unsigned int d, bool forward){
+        std::unordered_map<unsigned int, unsigned int> dist = {{start, d}};
+        std::vector<unsigned int> queue = {start};
+        for(size_t head = 0; head < queue.size(); head++){
+            unsigned int u = queue[head];
+            unsigned int du = dist[u];
+            if((forward ? query(hub, u) : query(u, hub)) <= du) continue;
+            auto &label = forward ? lin[u] : lout[u];
+            auto it = std::lower_bound(label.begin(), label.end(), hub, [](const entry &e, unsigned int h){
+                return e.hub < h;
+            });
+            if(it != label.end() && it->hub == hub) it->dist = du;
+            else label.insert(it, {hub, du});
+            for(unsigned int w : forward ? out_adj[u] : in_adj[u]){
+                if(!dist.count(w)){
+                    dist[w] = du + 1;
+                    queue.push_back(w);
+                }
+            }
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name clear()
+     * @brief Release the index
+    */
+    void network::DistanceOracle::clear(){
+        order.clear();
+        ranks.clear();
+        out_adj.clear();
+        in_adj.clear();
+        lin.clear();
+        lout.clear();
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name bytes()
+     * @brief Memory used by the index (labels, rank adjacency and email table)
+     * @return size_t --> Bytes
+    */
+    size_t network::DistanceOracle::bytes() const{
+        size_t ans = order.capacity() * sizeof(std::string) + ranks.bucket_count() * sizeof(void*)
+                   + ranks.size() * (sizeof(std::pair<const std::string, unsigned int>) + 2 * sizeof(void*));
+        for(const auto &s : order) ans += s.capacity() > 15 ? 2 * (s.capacity() + 1) : 0;
+        for(const auto *adj : {&out_adj, &in_adj}){
+            ans += adj->capacity() * sizeof(std::vector<unsigned int>);
+            for(const auto &l : *adj) ans += l.capacity() * sizeof(unsigned int);
+        }
+        for(const auto *lbl : {&lin, &lout}){
+            ans += lbl->capacity() * sizeof(std::vector<entry>);
+            for(const auto &l : *lbl) ans += l.capacity() * sizeof(entry);
+        }
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name label_entries()
+     * @brief Total number of label entries (index size)
+    */
+    size_t network::DistanceOracle::label_entries() const{
+        size_t ans = 0;
+        for(unsigned int r = 0; r < order.size(); r++) ans += lin[r].size() + lout[r].size();
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name serialize()
+     * @brief Binary dump of the ranking and the labels (adjacency is rebuilt on load)
+     * @return std::string --> Serialized index
+    */
+    std::string network::DistanceOracle::serialize() const{
+        std::string out;
+        auto put = [&](uint32_t x){ out.append(reinterpret_cast<const char*>(&x), sizeof(x)); };
+        put(order.size());
+        for(unsigned int r = 0; r < order.size(); r++){
+            put(order[r].size());
+            out += order[r];
+            for(const auto *label : {&lin[r], &lout[r]}){
+                put(label->size());
+                for(const auto &e : *label){
+                    put(e.hub);
+                    put(e.dist);
+                }
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @namespace network
+     * @class DistanceOracle
+     * @name deserialize()
+     * @brief Load an index produced by serialize() for the given graph
+     * @param data --> const std::string: Serialized index
+     * @param g --> const CSR: Graph the index was built for
+     * @return bool --> true: Index loaded, false: Corrupted data or different users
+    */
+    bool network::DistanceOracle::deserialize(const std::string &data, const CSR &g){
+        size_t pos = 0;
+        bool ok = true;
+        auto get = [&]() -> uint32_t {
+            uint32_t x = 0;
+            if(pos + sizeof(x) > data.size()){
+                ok = false;
+                return 0;
+            }
+            std::memcpy(&x, data.data() + pos, sizeof(x));
+            pos += sizeof(x);
+            return x;
+        };
+        clear();
+        uint32_t n = get();
+        if(!ok || n != g.size()) return false;
+        order.resize(n);
+        lin.resize(n);
+        lout.resize(n);
+        for(unsigned int r = 0; r < n && ok; r++){
+            uint32_t len = get();
+            if(!ok || pos + len > data.size()) break;
+            order[r] = data.substr(pos, len);
+            pos += len;
+            ranks[order[r]] = r;
+            for(auto *label : {&lin[r], &lout[r]}){
+                uint32_t size = get();
+                if(!ok || size > (data.size() - pos) / 8){
+                    ok = false;
+                    break;
+                }
+                label->resize(size);
+                for(auto &e : *label){
+                    e.hub = get();
+                    e.dist = get();
+                }
+            }
+        }
+        if(ok && pos == data.size() && ranks.size() == n){
+            ok = true;
+            for(const auto &id : g.ids) ok = ok && ranks.count(id);
+        } else ok = false;
+        if(!ok){
+            clear();
+            return false;
+        }
+        attach(g);
+        return true;
+    }
+
+} // namespace network
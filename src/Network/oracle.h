@@ -0,0 +1,61 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile oracle.h (header file)
+ * 
+ * DistanceOracle class interface/structure
+ * Exact distance index based on pruned landmark labeling (PLL): every user keeps a
+ * small sorted label of (hub, distance) pairs and a distance query is the merge of the
+ * source out-label with the destination in-label.
+ * Include guard
+ * 
+*/
+
+#ifndef ORACLE_H
+#define ORACLE_H
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "csr.h"
+
+namespace network{
+
+class DistanceOracle{
+public:
+    struct entry{
+        unsigned int hub;    // Hub rank
+        unsigned int dist;
+    };
+
+    void build(const CSR &g);
+    void clear();
+    void add_vertex(const std::string &s);
+    void add_edge(std::string_view src, std::string_view dest);
+    int distance(std::string_view src, std::string_view dest) const;
+    size_t size() const { return order.size(); } // Inline
+    size_t label_entries() const;
+    size_t bytes() const;
+    std::string serialize() const;
+    bool deserialize(const std::string &data, const CSR &g);
+
+private:
+    static constexpr unsigned int INF = -1;
+
+    std::vector<std::string> order;                       // Rank -> email (highest degree first)
+    string_map<unsigned int> ranks;                       // Email -> rank
+    std::vector<std::vector<unsigned int>> out_adj;       // Adjacency in rank space
+    std::vector<std::vector<unsigned int>> in_adj;
+    std::vector<std::vector<entry>> lin;                  // (hub, dist hub -> v)
+    std::vector<std::vector<entry>> lout;                 // (hub, dist v -> hub)
+
+    void attach(const CSR &g);
+    unsigned int query(unsigned int s, unsigned int t) const;
+    void pruned_bfs(unsigned int hub, bool forward, std::vector<std::pair<unsigned int, unsigned int>> &found,
+                    std::vector<unsigned int> &dist) const;
+    void resume(unsigned int hub, unsigned int start, unsigned int d, bool forward);
+};
+
+} // namespace network
+
+#endif // ORACLE_H
@@ -0,0 +1,91 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile parallel.h (header file)
+ * 
+ * Small thread helpers shared by the parallel graph algorithms
+ * Include guard
+ * 
+*/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace network{
+
+    /// @brief Number of worker threads used by the parallel algorithms (at least 1)
+    inline unsigned int workers(){
+        unsigned int n = std::thread::hardware_concurrency();
+        return n ? n : 1;
+    }
+
+    /**
+     * @namespace network
+     * @name parallel_for()
+     * @brief Run fn(i, tid) for every i in [0, n) across the worker threads.
+     *        Items are handed out in chunks through an atomic counter, so skewed
+     *        work (high degree vertices) is balanced dynamically.
+     * @param n --> size_t: Number of items
+     * @param fn --> Callable: fn(size_t item, unsigned int thread_id)
+     * @param chunk --> size_t: Items taken by a thread at once
+    */
+    template<typename F>
+    void parallel_for(size_t n, F &&fn, size_t chunk = 64){
+        unsigned int nthreads = workers();
+        if(nthreads == 1 || n <= chunk){
+            for(size_t i = 0; i < n; i++) fn(i, 0u);
+            return;
+        }
+        std::atomic<size_t> next(0);
+        auto work = [&](unsigned int tid){
+            while(true){
+                size_t begin = next.fetch_add(chunk);
+                if(begin >= n) return;
+                size_t end = begin + chunk < n ? begin + chunk : n;
+                for(size_t i = begin; i < end; i++) fn(i, tid);
+            }
+        };
+        std::vector<std::thread> pool;
+        for(unsigned int t = 1; t < nthreads; t++) pool.emplace_back(work, t);
+        work(0);
+        for(auto &t : pool) t.join();
+    }
+
+    /**
+     * @namespace network
+     * @name parallel_sort()
+     * @brief Sort a range across the worker threads: every thread sorts a slice and the
+     *        sorted slices are merged pairwise (the merges of a level run in parallel)
+     * @param first --> RandomIt: Begin of the range
+     * @param last --> RandomIt: End of the range
+     * @param cmp --> Compare: Strict weak ordering
+    */
+    template<typename RandomIt, typename Compare>
+    void parallel_sort(RandomIt first, RandomIt last, Compare cmp){
+        size_t n = last - first;
+        size_t parts = workers();
+        if(parts == 1 || n < (1u << 15)){
+            std::sort(first, last, cmp);
+            return;
+        }
+        std::vector<size_t> bounds(parts + 1);
+        for(size_t p = 0; p <= parts; p++) bounds[p] = n * p / parts;
+        parallel_for(parts, [&](size_t p, unsigned int){ std::sort(first + bounds[p], first + bounds[p + 1], cmp); }, 1);
+        for(size_t width = 1; width < parts; width *= 2){
+            size_t merges = (parts + 2 * width - 1) / (2 * width);
+            parallel_for(merges, [&](size_t m, unsigned int){
+                size_t lo = m * 2 * width;
+                size_t mid = std::min(lo + width, parts), hi = std::min(lo + 2 * width, parts);
+                if(mid < hi) std::inplace_merge(first + bounds[lo], first + bounds[mid], first + bounds[hi], cmp);
+            }, 1);
+        }
+    }
+
+} // namespace network
+
+#endif // PARALLEL_H
@@ -0,0 +1,62 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile policies.h (header file)
+ *
+ * Compile-time policies of the network graph (see BasicNetwork in network.h):
+ * Index --> container of the user table, Adjacency --> how the links/followers lists are kept.
+ * The application graph (network::Network) uses DefaultIndex/DefaultAdjacency, chosen at
+ * build time with -DGRAPHSOCIAL_ORDERED_INDEX and -DGRAPHSOCIAL_SORTED_LINKS.
+ * Include guard
+ *
+*/
+
+#ifndef POLICIES_H
+#define POLICIES_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include "lookup.h"
+
+namespace network{
+
+    /// @brief User table in a hash map (average O(1) lookups)
+    struct HashIndex{
+        static constexpr bool hashed = true;
+        static constexpr size_t node_overhead = 2 * sizeof(void*);   // Next pointer + cached hash
+        template<typename T> using map = string_map<T>;
+    };
+
+    /// @brief User table ordered by email (users listed in order, O(log n) lookups)
+    struct OrderedIndex{
+        static constexpr bool hashed = false;
+        static constexpr size_t node_overhead = 4 * sizeof(void*);   // Red-black tree links + color
+        template<typename T> using map = std::map<std::string, T, std::less<>>;
+    };
+
+    /// @brief Lists in insertion order: O(1) follow, linear duplicate check and removal
+    struct VectorAdjacency{
+        static constexpr bool sorted = false;
+    };
+
+    /// @brief Lists sorted by node address: binary search duplicate check and removal
+    ///        (faster for high degree users, the listing order isn't the follow order)
+    struct SortedAdjacency{
+        static constexpr bool sorted = true;
+    };
+
+#if defined(GRAPHSOCIAL_ORDERED_INDEX)
+    using DefaultIndex = OrderedIndex;
+#else
+    using DefaultIndex = HashIndex;
+#endif
+
+#if defined(GRAPHSOCIAL_SORTED_LINKS)
+    using DefaultAdjacency = SortedAdjacency;
+#else
+    using DefaultAdjacency = VectorAdjacency;
+#endif
+
+} // namespace network
+
+#endif // POLICIES_H
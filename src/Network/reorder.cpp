@@ -0,0 +1,175 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file reorder.cpp (.cpp file) (implementation file)
+ *
+ * VertexOrder class member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+#include "reorder.h"
+
+namespace network{
+
+    /**
+     * @namespace network
+     * @class VertexOrder
+     * @name compute()
+     * @brief Compute a vertex order of a layout
+     * @param g --> const G: Layout in its current order (CSR or CompressedCSR)
+     * @param m --> method_t: Ordering method
+     * @return std::vector<unsigned int> --> order[new id] = current id (empty for NONE)
+    */
+    template<class G>
+    std::vector<unsigned int> network::VertexOrder::compute(const G &g, method_t m){
+        switch(m){
+            case DEGREE: return degree(g);
+            case RCM: return rcm(g);
+            case GORDER: return gorder(g);
+            default: return {};
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class VertexOrder
+     * @name name()
+     * @brief Name shown to the user
+     * @param m --> method_t: Ordering method
+     * @return std::string --> Method name
+    */
+    std::string network::VertexOrder::name(method_t m){
+        switch(m){
+            case DEGREE: return "grau";
+            case RCM: return "RCM";
+            case GORDER: return "Gorder";
+            default: return "nenhuma";
+        }
+    }
+
+    /**
+     * @namespace network
+     * @class VertexOrder
+     * @name degree()
+     * @brief Highest degree (in + out) first, so the hubs touched by most traversals
+     *        share the first cache lines of every per-vertex array
+     * @param g --> const G: Layout
+     * @return std::vector<unsigned int> --> order[new id] = current id
+    */
+    template<class G>
+    std::vector<unsigned int> network::VertexOrder::degree(const G &g){
+        std::vector<unsigned int> order(g.size());
+        for(unsigned int v = 0; v < g.size(); v++) order[v] = v;
+        std::stable_sort(order.begin(), order.end(), [&g](unsigned int a, unsigned int b){
+            return g.indegree(a) + g.outdegree(a) > g.indegree(b) + g.outdegree(b);
+        });
+        return order;
+    }
+
+    /**
+     * @namespace network
+     * @class VertexOrder
+     * @name rcm()
+     * @brief Reverse Cuthill-McKee on the undirected view: breadth-first search from a
+     *        lowest degree user of every component, neighbors taken by increasing degree,
+     *        then the order is reversed. Users of the same BFS level end up adjacent.
+     * @param g --> const G: Layout
+     * @return std::vector<unsigned int> --> order[new id] = current id
+    */
+    template<class G>
+    std::vector<unsigned int> network::VertexOrder::rcm(const G &g){
+        unsigned int n = g.size();
+        auto deg = [&g](unsigned int v){ return g.indegree(v) + g.outdegree(v); };
+        std::vector<unsigned int> starts(n);
+        for(unsigned int v = 0; v < n; v++) starts[v] = v;
+        std::stable_sort(starts.begin(), starts.end(), [&](unsigned int a, unsigned int b){ return deg(a) < deg(b); });
+        std::vector<unsigned int> order;
+        order.reserve(n);
+        std::vector<bool> seen(n, false);
+        std::vector<unsigned int> found;
+        for(unsigned int s : starts){
+            if(seen[s]) continue;
+            seen[s] = true;
+            size_t head = order.size();
+            order.push_back(s);
+            while(head < order.size()){
+                unsigned int u = order[head++];
+                found.clear();
+                auto visit = [&](unsigned int w){ if(!seen[w]){ seen[w] = true; found.push_back(w); } };
+                g.for_each_out(u, visit);
+                g.for_each_in(u, visit);
+                std::sort(found.begin(), found.end(), [&](unsigned int a, unsigned int b){ return deg(a) < deg(b); });
+                order.insert(order.end(), found.begin(), found.end());
+            }
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+    /**
+     * @namespace network
+     * @class VertexOrder
+     * @name gorder()
+     * @brief Greedy Gorder: the next user is the one with the highest score against the
+     *        last WINDOW placed users, where a pair scores one per link between them and
+     *        one per common follower. Followers with more than sqrt(n) links are ignored
+     *        for the sibling score (they relate almost everyone). Scores are kept in a
+     *        lazy max-heap; when no candidate scores, the highest in-degree user left starts
+     *        a new region.
+     * @param g --> const G: Layout
+     * @return std::vector<unsigned int> --> order[new id] = current id
+    */
+    template<class G>
+    std::vector<unsigned int> network::VertexOrder::gorder(const G &g){
+        unsigned int n = g.size();
+        unsigned int hub = std::max(16u, (unsigned int)std::sqrt((double)n));
+        std::vector<unsigned int> fallback(n);
+        for(unsigned int v = 0; v < n; v++) fallback[v] = v;
+        std::stable_sort(fallback.begin(), fallback.end(), [&g](unsigned int a, unsigned int b){
+            return g.indegree(a) > g.indegree(b);
+        });
+        std::vector<int> score(n, 0);
+        std::vector<bool> placed(n, false);
+        std::priority_queue<std::pair<int, unsigned int>> heap;
+        auto bump = [&](unsigned int u, int d){
+            if(placed[u]) return;
+            score[u] += d;
+            if(score[u] > 0) heap.emplace(score[u], u);
+        };
+        auto update = [&](unsigned int v, int d){
+            g.for_each_out(v, [&](unsigned int w){ bump(w, d); });
+            g.for_each_in(v, [&](unsigned int p){
+                bump(p, d);
+                if(g.outdegree(p) > hub) return;
+                g.for_each_out(p, [&](unsigned int q){ if(q != v) bump(q, d); });
+            });
+        };
+        std::vector<unsigned int> order;
+        order.reserve(n);
+        size_t next = 0;
+        while(order.size() < n){
+            unsigned int v = n;
+            while(!heap.empty()){
+                auto top = heap.top();
+                heap.pop();
+                if(!placed[top.second] && score[top.second] == top.first){
+                    v = top.second;
+                    break;
+                }
+            }
+            if(v == n){
+                while(placed[fallback[next]]) next++;
+                v = fallback[next];
+            }
+            placed[v] = true;
+            order.push_back(v);
+            update(v, 1);
+            if(order.size() > WINDOW) update(order[order.size() - 1 - WINDOW], -1);
+        }
+        return order;
+    }
+
+} // namespace network
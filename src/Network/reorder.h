@@ -0,0 +1,39 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile reorder.h (header file)
+ *
+ * VertexOrder class interface/structure
+ * Vertex orderings applied to the contiguous layouts so that users visited together
+ * get close ids (neighbor ranges and per-vertex arrays then share cache lines):
+ * degree sort, reverse Cuthill-McKee (BFS levels) and a Gorder style greedy window.
+ * Include guard
+ *
+*/
+
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <string>
+#include <vector>
+#include "csr.h"
+
+namespace network{
+
+class VertexOrder{
+public:
+    enum method_t { NONE, DEGREE, RCM, GORDER };
+
+    static constexpr unsigned int WINDOW = 5;   // Gorder: recently placed users scored against
+
+    template<class G> static std::vector<unsigned int> compute(const G &g, method_t m);
+    static std::string name(method_t m);
+
+private:
+    template<class G> static std::vector<unsigned int> degree(const G &g);
+    template<class G> static std::vector<unsigned int> rcm(const G &g);
+    template<class G> static std::vector<unsigned int> gorder(const G &g);
+};
+
+} // namespace network
+
+#endif // REORDER_H
@@ -0,0 +1,271 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file timeindex.cpp (.cpp file) (implementation file)
+ *
+ * TimeIndex class member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include "timeindex.h"
+
+namespace network{
+
+    /**
+     * @namespace network
+     * @class TimeIndex
+     * @name build()
+     * @brief Bulk construction: the links are sorted by time once and appended in order, so
+     *        every per-user list and partition comes out sorted without further work
+     * @param edges --> std::vector<edge>: All the links (consumed)
+    */
+    template<class Key>
+    void network::TimeIndex<Key>::build(std::vector<edge> &&edges){
+        clear();
+        std::stable_sort(edges.begin(), edges.end(), [](const edge &a, const edge &b){ return a.time < b.time; });
+        for(const auto &e : edges){
+            out[e.src].push_back({e.time, e.dest});
+            in[e.dest].push_back({e.time, e.src});
+        }
+        for(size_t i = 0, j; i < edges.size(); i = j){
+            unsigned int p = edges[i].time / PARTITION;
+            for(j = i + 1; j < edges.size() && edges[j].time / PARTITION == p; j++);
+            log[p].assign(edges.begin() + i, edges.begin() + j);
+        }
+        total = edges.size();
+    }
+
+    /// @brief Insert keeping the list sorted by time (appended when it's the newest)
+    template<class Key>
+    void network::TimeIndex<Key>::insert(std::vector<entry> &list, unsigned int time, Key user){
+        if(list.empty() || list.back().time <= time){
+            list.push_back({time, user});
+            return;
+        }
+        auto p = std::upper_bound(list.begin(), list.end(), time,
+                                  [](unsigned int t, const entry &e){ return t < e.time; });
+        list.insert(p, {time, user});
+    }
+
+    /// @brief Remove the entry of a user among the ones with the same time
+    template<class Key>
+    void network::TimeIndex<Key>::erase(std::vector<entry> &list, unsigned int time, Key user){
+        auto p = std::lower_bound(list.begin(), list.end(), time,
+                                  [](const entry &e, unsigned int t){ return e.time < t; });
+        for(; p != list.end() && p->time == time; ++p)
+            if(p->user == user){
+                list.erase(p);
+                return;
+            }
+    }
+
+    /**
+     * @namespace network
+     * @class TimeIndex
+     * @name add()
+     * @brief Index a new link (O(1) when it's the newest, as a follow is)
+     * @param src --> Key: Follower
+     * @param dest --> Key: Followed user
+     * @param time --> unsigned int: Creation time
+     * @param weight --> float: Weight of the link
+    */
+    template<class Key>
+    void network::TimeIndex<Key>::add(Key src, Key dest, unsigned int time, float weight){
+        insert(out[src], time, dest);
+        insert(in[dest], time, src);
+        auto &part = log[time / PARTITION];
+        if(part.empty() || part.back().time <= time) part.push_back({time, src, dest, weight});
+        else part.insert(std::upper_bound(part.begin(), part.end(), time,
+                                          [](unsigned int t, const edge &e){ return t < e.time; }),
+                         {time, src, dest, weight});
+        total++;
+    }
+
+    /// @brief Log entry of a link (binary search in its partition), nullptr if it isn't indexed
+    template<class Key>
+    typename network::TimeIndex<Key>::edge*
+    network::TimeIndex<Key>::logged(Key src, Key dest, unsigned int time){
+        auto it = log.find(time / PARTITION);
+        if(it == log.end()) return nullptr;
+        auto &part = it->second;
+        auto p = std::lower_bound(part.begin(), part.end(), time,
+                                  [](const edge &e, unsigned int t){ return e.time < t; });
+        for(; p != part.end() && p->time == time; ++p)
+            if(p->src == src && p->dest == dest) return &*p;
+        return nullptr;
+    }
+
+    /// @brief Remove a link from the global log
+    template<class Key>
+    void network::TimeIndex<Key>::unlog(Key src, Key dest, unsigned int time){
+        edge *e = logged(src, dest, time);
+        if(!e) return;
+        auto &part = log[time / PARTITION];
+        part.erase(part.begin() + (e - part.data()));
+        total--;
+        if(part.empty()) log.erase(time / PARTITION);
+    }
+
+    /// @brief New weight of an indexed link
+    template<class Key>
+    void network::TimeIndex<Key>::reweight(Key src, Key dest, unsigned int time, float weight){
+        if(edge *e = logged(src, dest, time)) e->weight = weight;
+    }
+
+    /**
+     * @namespace network
+     * @class TimeIndex
+     * @name remove()
+     * @brief Remove a link (unfollow)
+     * @param src --> Key: Follower
+     * @param dest --> Key: Followed user
+     * @param time --> unsigned int: Creation time of the link
+    */
+    template<class Key>
+    void network::TimeIndex<Key>::remove(Key src, Key dest, unsigned int time){
+        auto o = out.find(src);
+        if(o != out.end()) erase(o->second, time, dest);
+        auto i = in.find(dest);
+        if(i != in.end()) erase(i->second, time, src);
+        unlog(src, dest, time);
+    }
+
+    /**
+     * @namespace network
+     * @class TimeIndex
+     * @name remove_user()
+     * @brief Remove a user with all its links (both directions)
+     * @param u --> Key: User
+    */
+    template<class Key>
+    void network::TimeIndex<Key>::remove_user(Key u){
+        auto o = out.find(u);
+        if(o != out.end()){
+            for(const auto &e : o->second){
+                if(e.user != u){
+                    auto i = in.find(e.user);
+                    if(i != in.end()) erase(i->second, e.time, u);
+                }
+                unlog(u, e.user, e.time);
+            }
+            out.erase(o);
+        }
+        auto i = in.find(u);
+        if(i != in.end()){
+            for(const auto &e : i->second){
+                if(e.user == u) continue;   // Self follow, already removed with the out list
+                auto f = out.find(e.user);
+                if(f != out.end()) erase(f->second, e.time, u);
+                unlog(e.user, u, e.time);
+            }
+            in.erase(i);
+        }
+    }
+
+    /// @brief Entries of a user list with from <= time <= to
+    template<class Key>
+    typename network::TimeIndex<Key>::range_t
+    network::TimeIndex<Key>::window(const std::unordered_map<Key, std::vector<entry>> &lists, Key u,
+                                    unsigned int from, unsigned int to){
+        auto it = lists.find(u);
+        if(it == lists.end() || from > to) return {nullptr, nullptr};
+        const entry *b = it->second.data(), *e = b + it->second.size();
+        auto first = std::lower_bound(b, e, from, [](const entry &x, unsigned int t){ return x.time < t; });
+        auto last = std::upper_bound(first, e, to, [](unsigned int t, const entry &x){ return t < x.time; });
+        return {first, last};
+    }
+
+    /**
+     * @namespace network
+     * @class TimeIndex
+     * @name out_range()
+     * @brief Users followed by u within a time window, oldest first (two binary searches)
+     * @param u --> Key: User
+     * @param from --> unsigned int: Window start (inclusive)
+     * @param to --> unsigned int: Window end (inclusive)
+     * @return range_t --> [first, second) of entries, valid until the index changes
+    */
+    template<class Key>
+    typename network::TimeIndex<Key>::range_t
+    network::TimeIndex<Key>::out_range(Key u, unsigned int from, unsigned int to) const{
+        return window(out, u, from, to);
+    }
+
+    /// @brief Followers gained by u within a time window, oldest first (as out_range())
+    template<class Key>
+    typename network::TimeIndex<Key>::range_t
+    network::TimeIndex<Key>::in_range(Key u, unsigned int from, unsigned int to) const{
+        return window(in, u, from, to);
+    }
+
+    /**
+     * @namespace network
+     * @class TimeIndex
+     * @name count()
+     * @brief Links created within a time window: the partitions fully inside count by their
+     *        size, only the two boundary partitions are binary searched
+     * @param from --> unsigned int: Window start (inclusive)
+     * @param to --> unsigned int: Window end (inclusive)
+     * @return size_t --> Number of links
+    */
+    template<class Key>
+    size_t network::TimeIndex<Key>::count(unsigned int from, unsigned int to) const{
+        if(from > to) return 0;
+        size_t ans = 0;
+        auto last = log.upper_bound(to / PARTITION);
+        for(auto it = log.lower_bound(from / PARTITION); it != last; ++it){
+            const auto &part = it->second;
+            if(part.front().time >= from && part.back().time <= to){
+                ans += part.size();
+                continue;
+            }
+            auto b = std::lower_bound(part.begin(), part.end(), from,
+                                      [](const edge &e, unsigned int t){ return e.time < t; });
+            auto e = std::upper_bound(b, part.end(), to,
+                                      [](unsigned int t, const edge &x){ return t < x.time; });
+            ans += e - b;
+        }
+        return ans;
+    }
+
+    /**
+     * @namespace network
+     * @class TimeIndex
+     * @name for_each_until()
+     * @brief Visit the links created up to a time, oldest first (later partitions aren't read)
+     * @param time --> unsigned int: Last creation time (inclusive)
+     * @param fn --> F: Called as fn(src, dest, time, weight)
+    */
+    template<class Key>
+    template<class F>
+    void network::TimeIndex<Key>::for_each_until(unsigned int time, F fn) const{
+        auto last = log.upper_bound(time / PARTITION);
+        for(auto it = log.begin(); it != last; ++it)
+            for(const auto &e : it->second){
+                if(e.time > time) return;
+                fn(e.src, e.dest, e.time, e.weight);
+            }
+    }
+
+    /// @brief Bytes used by the lists, the partitions and the hash tables
+    template<class Key>
+    size_t network::TimeIndex<Key>::bytes() const{
+        size_t ans = (out.bucket_count() + in.bucket_count()) * sizeof(void*);
+        for(const auto *lists : {&out, &in})
+            for(const auto &l : *lists)
+                ans += sizeof(l) + 2 * sizeof(void*) + l.second.capacity() * sizeof(entry);
+        for(const auto &p : log)
+            ans += sizeof(p) + 4 * sizeof(void*) + p.second.capacity() * sizeof(edge);
+        return ans;
+    }
+
+    /// @brief Drop every link
+    template<class Key>
+    void network::TimeIndex<Key>::clear(){
+        out.clear();
+        in.clear();
+        log.clear();
+        total = 0;
+    }
+
+} // namespace network
@@ -0,0 +1,75 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile timeindex.h (header file)
+ *
+ * TimeIndex class interface/structure
+ * Links ordered by creation time: for every user the followed users and the followers
+ * sorted by time (a window is found with binary search), plus a global log of the links
+ * split in partitions of PARTITION seconds (window counts and snapshots only touch the
+ * partitions inside the window). Only existing links are indexed: an unfollow removes
+ * the link, it isn't kept as history.
+ * Key is the user handle of the network (node pointer).
+ * Include guard
+ *
+*/
+
+#ifndef TIMEINDEX_H
+#define TIMEINDEX_H
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace network{
+
+template<class Key>
+class TimeIndex{
+public:
+    static constexpr unsigned int PARTITION = 3600;   // Seconds per partition of the log
+
+    struct entry{
+        unsigned int time;
+        Key user;   // Followed user (out lists) or follower (in lists)
+    };
+
+    struct edge{
+        unsigned int time;
+        Key src;
+        Key dest;
+        float weight = 1;   // Kept current by reweight() (snapshots read it from the log)
+    };
+
+    typedef std::pair<const entry*, const entry*> range_t;   // [first, second)
+
+    void build(std::vector<edge> &&edges);
+    void add(Key src, Key dest, unsigned int time, float weight = 1);
+    void reweight(Key src, Key dest, unsigned int time, float weight);
+    void remove(Key src, Key dest, unsigned int time);
+    void remove_user(Key u);
+    range_t out_range(Key u, unsigned int from, unsigned int to) const;
+    range_t in_range(Key u, unsigned int from, unsigned int to) const;
+    size_t count(unsigned int from, unsigned int to) const;
+    template<class F> void for_each_until(unsigned int time, F fn) const;
+    size_t size() const { return total; } // Inline
+    size_t bytes() const;
+    size_t blocks() const { return out.size() + in.size() + 2 * log.size() + 2; } // Inline
+    void clear();
+
+private:
+    std::unordered_map<Key, std::vector<entry>> out;   // User -> followed users by time
+    std::unordered_map<Key, std::vector<entry>> in;    // User -> followers by time
+    std::map<unsigned int, std::vector<edge>> log;     // Partition -> links by time
+    size_t total = 0;
+
+    static void insert(std::vector<entry> &list, unsigned int time, Key user);
+    static void erase(std::vector<entry> &list, unsigned int time, Key user);
+    static range_t window(const std::unordered_map<Key, std::vector<entry>> &lists, Key u,
+                          unsigned int from, unsigned int to);
+    edge* logged(Key src, Key dest, unsigned int time);
+    void unlog(Key src, Key dest, unsigned int time);
+};
+
+} // namespace network
+
+#endif // TIMEINDEX_H
@@ -0,0 +1,576 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file shard.cpp (.cpp file) (implementation file)
+ * 
+ * Shard and Coordinator classes members/member functions implementation
+ * 
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "shard.h"
+
+namespace shard{
+
+    /**
+     * @namespace shard
+     * @name shard_of()
+     * @brief Shard that owns a user (FNV-1a hash of the email, stable across builds
+     *        so the shard files stay valid)
+     * @param s --> const std::string: User email
+     * @param nshards --> unsigned int: Number of shards
+     * @return unsigned int --> Shard index
+    */
+    unsigned int shard_of(const std::string &s, unsigned int nshards){
+        uint64_t h = 1469598103934665603ull;
+        for(unsigned char c : s){
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h % nshards;
+    }
+
+    /**
+     * @namespace shard
+     * @name write_message()
+     * @brief Send a message: field count, then every field as (length, bytes)
+     * @return bool --> true: Message sent, false: Connection closed
+    */
+    static bool write_message(int fd, const std::vector<std::string> &fields){
+        std::string out;
+        auto put = [&](uint32_t x){ out.append(reinterpret_cast<const char*>(&x), sizeof(x)); };
+        put(fields.size());
+        for(const auto &f : fields){
+            put(f.size());
+            out += f;
+        }
+        size_t done = 0;
+        while(done < out.size()){
+            ssize_t n = ::send(fd, out.data() + done, out.size() - done, MSG_NOSIGNAL);
+            if(n <= 0) return false;
+            done += n;
+        }
+        return true;
+    }
+
+    /**
+     * @namespace shard
+     * @name read_full()
+     * @brief Read exactly len bytes
+    */
+    static bool read_full(int fd, char *buf, size_t len){
+        size_t done = 0;
+        while(done < len){
+            ssize_t n = ::read(fd, buf + done, len - done);
+            if(n <= 0) return false;
+            done += n;
+        }
+        return true;
+    }
+
+    /**
+     * @namespace shard
+     * @name read_message()
+     * @brief Receive a message written by write_message()
+     * @return bool --> true: Message received, false: Connection closed
+    */
+    static bool read_message(int fd, std::vector<std::string> &fields){
+        uint32_t count, len;
+        if(!read_full(fd, reinterpret_cast<char*>(&count), sizeof(count))) return false;
+        fields.resize(count);
+        for(auto &f : fields){
+            if(!read_full(fd, reinterpret_cast<char*>(&len), sizeof(len))) return false;
+            f.resize(len);
+            if(len && !read_full(fd, &f[0], len)) return false;
+        }
+        return true;
+    }
+
+    /// @brief Shard constructor, loads the shard slice from its own database file
+    /// @param idx --> unsigned int: Shard index
+    /// @param nshards --> unsigned int: Number of shards
+    /// @param dbname --> const std::string: Shard database file
+    shard::Shard::Shard(unsigned int idx, unsigned int nshards, const std::string &dbname)
+        : idx(idx), nshards(nshards), db(*this, dbname){}
+
+    /**
+     * @namespace shard
+     * @class Shard
+     * @name serve()
+     * @brief Answer the coordinator requests until it quits or closes the socket
+     * @param fd --> int: Socket connected to the coordinator
+    */
+    void shard::Shard::serve(int fd){
+        std::vector<std::string> cmd;
+        bool quit = false;
+        while(!quit && read_message(fd, cmd))
+            if(!write_message(fd, handle(cmd, quit))) break;
+    }
+
+    /**
+     * @namespace shard
+     * @class Shard
+     * @name handle()
+     * @brief Execute one request. Links to users of other shards point to "ghost" nodes
+     *        (email only), persisted like regular users so the links can be reloaded;
+     *        ghosts are never reported as users of this shard.
+     * @param cmd --> const std::vector<std::string>: Operation code and arguments
+     * @param quit --> bool: Set when the coordinator asks the shard to stop
+     * @return std::vector<std::string> --> Response fields
+    */
+    std::vector<std::string> shard::Shard::handle(const std::vector<std::string> &cmd, bool &quit){
+        if(cmd.empty()) return {"ERR", "Requisição vazia!"};
+        const std::string &op = cmd[0];
+        if(op == "I" && cmd.size() == 6){
+            error_t ins = insert_node(cmd[1], cmd[2], cmd[3], cmd[4], cmd[5]);
+            if(ins.flag) return {"ERR", ins.errmsg};
+            db.save_user(cmd[1], cmd[2], cmd[3], cmd[4], cmd[5]);
+            return {"OK"};
+        }
+        if(op == "E" && cmd.size() == 2) return {find(cmd[1]) && local(cmd[1]) ? "1" : "0"};
+        if(op == "F" && cmd.size() == 3){
+            if(!find(cmd[2]) && !local(cmd[2])){
+                insert_node(cmd[2], "", "", "", "");
+                db.save_user(cmd[2], "", "", "", "");
+            }
+            error_t flw = follow(cmd[1], cmd[2]);
+            if(flw.flag) return {"ERR", flw.errmsg};
+            const link_t *l = link(cmd[1], cmd[2]);
+            db.save_link(cmd[1], cmd[2], l->time, l->weight);
+            return {"OK", flw.errmsg};
+        }
+        if(op == "U" && cmd.size() == 3){
+            error_t unflw = unfollow(cmd[1], cmd[2]);
+            if(unflw.flag) return {"ERR", unflw.errmsg};
+            db.drop_link(cmd[1], cmd[2]);
+            return {"OK"};
+        }
+        if(op == "R" && cmd.size() == 2){
+            if(find(cmd[1])){
+                remove_node(cmd[1]);
+                db.drop_user(cmd[1]);
+            }
+            return {"OK"};
+        }
+        if(op == "X" || op == "Y"){
+            std::vector<std::string> ans;
+            for(size_t i = 1; i < cmd.size(); i++){
+                node *n = find(cmd[i]);
+                const std::vector<node*> *adj = nullptr;
+                if(n) adj = op == "X" ? (local(cmd[i]) ? &n->links : nullptr) : &n->followers;
+                ans.push_back(std::to_string(adj ? adj->size() : 0));
+                if(adj) for(auto w : *adj) ans.push_back(w->user.email);
+            }
+            return ans;
+        }
+        if(op == "L"){
+            std::vector<std::string> ans;
+            for(const auto &n : nodes) if(local(n.first)) ans.push_back(n.first);
+            return ans;
+        }
+        if(op == "N"){
+            size_t count = 0;
+            for(const auto &n : nodes) count += local(n.first);
+            return {std::to_string(count)};
+        }
+        if(op == "Q"){
+            quit = true;
+            return {"OK"};
+        }
+        return {"ERR", "Operação inválida!"};
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name Coordinator()
+     * @brief Start the shard processes (one socket pair each). Shard i stores its slice
+     *        in dir/shard_i.db and the number of shards is kept in dir/shard_count: the
+     *        users are placed by hash modulo N, so files written with another N are
+     *        refused (no shard is started, shards() is 0).
+     * @param nshards --> unsigned int: Number of shards (1 to MAX_SHARDS)
+     * @param dir --> const std::string: Directory of the shard database files
+    */
+    shard::Coordinator::Coordinator(unsigned int nshards, const std::string &dir){
+        nshards = std::clamp(nshards, 1u, MAX_SHARDS);
+        unsigned int stored = stored_shards(dir);
+        if(stored && stored != nshards){
+            std::cout << "Os dados em " << dir << " foram particionados em " << stored
+                      << " shards, use --shards " << stored << std::endl;
+            return;
+        }
+        std::cout.flush();
+        for(unsigned int i = 0; i < nshards; i++){
+            int fds[2];
+            if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0){
+                std::cout << "Erro ao criar o socket do shard " << i << std::endl;
+                break;
+            }
+            pid_t pid = fork();
+            if(pid == 0){
+                ::close(fds[0]);
+                for(const auto &c : channels) ::close(c.fd);
+                {
+                    Shard sh(i, nshards, dir + "/shard_" + std::to_string(i) + ".db");
+                    sh.serve(fds[1]);
+                }
+                std::cout.flush();
+                _exit(0);
+            }
+            ::close(fds[1]);
+            if(pid < 0){
+                std::cout << "Erro ao iniciar o processo do shard " << i << std::endl;
+                ::close(fds[0]);
+                break;
+            }
+            channels.push_back({fds[0], pid});
+        }
+        if(!stored && channels.size() == nshards){
+            std::ofstream count(dir + "/shard_count");
+            count << nshards << std::endl;
+        }
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name stored_shards()
+     * @brief Number of shards of the files in dir: dir/shard_count, or (files written
+     *        before it existed) the number of consecutive dir/shard_i.db files
+     * @param dir --> const std::string: Directory of the shard database files
+     * @return unsigned int --> Number of shards, 0 if there are no shard files
+    */
+    unsigned int shard::Coordinator::stored_shards(const std::string &dir){
+        std::ifstream count(dir + "/shard_count");
+        unsigned int n = 0;
+        if(count >> n && n) return n;
+        n = 0;
+        while(::access((dir + "/shard_" + std::to_string(n) + ".db").c_str(), F_OK) == 0) n++;
+        return n;
+    }
+
+    /// @brief Class destructor --> Stop the shards (they close their databases) and wait for them
+    shard::Coordinator::~Coordinator(){
+        for(unsigned int i = 0; i < channels.size(); i++) request(i, {"Q"});
+        for(auto &c : channels){
+            ::close(c.fd);
+            waitpid(c.pid, nullptr, 0);
+        }
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name request()
+     * @brief Send a request to a shard and wait for the response
+    */
+    std::vector<std::string> shard::Coordinator::request(unsigned int shard, const std::vector<std::string> &cmd){
+        std::vector<std::string> ans;
+        if(!write_message(channels[shard].fd, cmd) || !read_message(channels[shard].fd, ans))
+            return {"ERR", "Shard " + std::to_string(shard) + " indisponível!"};
+        return ans;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name exists()
+     * @brief Check if a user exists (asks the owner shard)
+    */
+    bool shard::Coordinator::exists(const std::string &s){
+        auto ans = request(shard_of(s, shards()), {"E", s});
+        return !ans.empty() && ans[0] == "1";
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name size()
+     * @brief Number of users in all shards
+    */
+    size_t shard::Coordinator::size(){
+        size_t ans = 0;
+        for(unsigned int i = 0; i < shards(); i++){
+            auto r = request(i, {"N"});
+            if(!r.empty() && r[0] != "ERR") ans += std::stoul(r[0]);
+        }
+        return ans;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name insert_node()
+     * @brief Insert a user in its owner shard
+     * @return error_t --> Struct defined in shard.h to handle errors
+    */
+    shard::Coordinator::error_t shard::Coordinator::insert_node(const std::string &mail, const std::string &nm,
+                                                                const std::string &brth, const std::string &phne,
+                                                                const std::string &cty)
+    {
+        error_t err;
+        auto ans = request(shard_of(mail, shards()), {"I", mail, nm, brth, phne, cty});
+        if(ans.empty() || ans[0] != "OK"){
+            err.flag = true;
+            err.errmsg = ans.size() > 1 ? ans[1] : "Erro no shard!";
+        }
+        return err;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name follow()
+     * @brief Create a link. It is stored by the shard of the first user; the second user
+     *        must exist in its own shard.
+     * @return error_t --> Struct defined in shard.h to handle errors
+    */
+    shard::Coordinator::error_t shard::Coordinator::follow(const std::string &src, const std::string &dest){
+        error_t err;
+        if(!exists(src) || !exists(dest)){
+            err.flag = true;
+            err.errmsg = "Um dos usuários informados não existe na rede!";
+            return err;
+        }
+        auto ans = request(shard_of(src, shards()), {"F", src, dest});
+        if(ans.empty() || ans[0] != "OK") err.flag = true;
+        err.errmsg = ans.size() > 1 ? ans[1] : "";
+        return err;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name unfollow()
+     * @brief Delete a link (in the shard of the first user)
+     * @return error_t --> Struct defined in shard.h to handle errors
+    */
+    shard::Coordinator::error_t shard::Coordinator::unfollow(const std::string &src, const std::string &dest){
+        error_t err;
+        auto ans = request(shard_of(src, shards()), {"U", src, dest});
+        if(ans.empty() || ans[0] != "OK"){
+            err.flag = true;
+            err.errmsg = ans.size() > 1 ? ans[1] : "Erro no shard!";
+        }
+        return err;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name remove()
+     * @brief Remove a user: the owner drops the user, every other shard drops its ghost
+     *        (and so the links pointing to the user)
+     * @return error_t --> Struct defined in shard.h to handle errors
+    */
+    shard::Coordinator::error_t shard::Coordinator::remove(const std::string &s){
+        error_t err;
+        if(!exists(s)){
+            err.flag = true;
+            err.errmsg = "O usuário não existe!";
+            return err;
+        }
+        for(unsigned int i = 0; i < shards(); i++) write_message(channels[i].fd, {"R", s});
+        std::vector<std::string> ans;
+        for(unsigned int i = 0; i < shards(); i++) read_message(channels[i].fd, ans);
+        return err;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name expand()
+     * @brief Expand one BFS level. Out-links live in the owner shard, so each shard gets
+     *        the frontier users it owns; in-links (followers) can live in any shard, so the
+     *        whole frontier is broadcast. All requests are sent before any response is read,
+     *        so the shards work concurrently.
+     * @param frontier --> const std::vector<std::string>: Current level
+     * @param followers --> bool: false: Out-links, true: In-links
+     * @return std::vector<std::vector<std::string>> --> Neighbors of every frontier user
+    */
+    std::vector<std::vector<std::string>> shard::Coordinator::expand(const std::vector<std::string> &frontier,
+                                                                     bool followers)
+    {
+        unsigned int n = shards();
+        std::vector<std::vector<std::string>> ans(frontier.size());
+        std::vector<std::vector<size_t>> owned(n);
+        for(size_t i = 0; i < frontier.size(); i++){
+            if(followers) for(unsigned int s = 0; s < n; s++) owned[s].push_back(i);
+            else owned[shard_of(frontier[i], n)].push_back(i);
+        }
+        for(unsigned int s = 0; s < n; s++){
+            if(owned[s].empty()) continue;
+            std::vector<std::string> cmd = {followers ? "Y" : "X"};
+            for(size_t i : owned[s]) cmd.push_back(frontier[i]);
+            write_message(channels[s].fd, cmd);
+        }
+        std::vector<std::string> resp;
+        for(unsigned int s = 0; s < n; s++){
+            if(owned[s].empty()) continue;
+            if(!read_message(channels[s].fd, resp)) continue;
+            size_t pos = 0;
+            for(size_t i : owned[s]){
+                if(pos >= resp.size()) break;
+                size_t count = std::stoul(resp[pos++]);
+                for(size_t j = 0; j < count && pos < resp.size(); j++) ans[i].push_back(resp[pos++]);
+            }
+        }
+        return ans;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name bfs()
+     * @brief Level synchronous BFS across the shards
+     * @param src --> const std::string: Source user
+     * @param k --> unsigned int: Maximum depth
+     * @param followers --> bool: false: Out-links, true: In-links
+     * @param dest --> const std::string*: Stop when reached (nullptr: full traversal)
+     * @param path --> std::vector<std::string>*: Receives the path to dest (optional)
+     * @param reached --> size_t*: Receives the number of users reached (optional)
+     * @return int --> Distance to dest (or depth of the last level), -1 if dest wasn't reached
+    */
+    int shard::Coordinator::bfs(const std::string &src, unsigned int k, bool followers, const std::string *dest,
+                                std::vector<std::string> *path, size_t *reached)
+    {
+        std::unordered_map<std::string, std::string> parent = {{src, ""}};
+        std::vector<std::string> frontier = {src}, next;
+        unsigned int depth = 0;
+        bool found = dest && *dest == src;
+        while(!found && !frontier.empty() && depth < k){
+            auto nbrs = expand(frontier, followers);
+            next.clear();
+            for(size_t i = 0; i < frontier.size() && !found; i++){
+                for(const auto &w : nbrs[i]){
+                    if(!parent.emplace(w, frontier[i]).second) continue;
+                    next.push_back(w);
+                    if(dest && w == *dest){
+                        found = true;
+                        break;
+                    }
+                }
+            }
+            frontier.swap(next);
+            if(!frontier.empty()) depth++;
+        }
+        if(reached) *reached = parent.size() - 1;
+        if(!dest) return depth;
+        if(!found) return -1;
+        if(path){
+            path->clear();
+            for(std::string curr = *dest; !curr.empty(); curr = parent[curr]) path->push_back(curr);
+            std::reverse(path->begin(), path->end());
+        }
+        return depth;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name shortest_path()
+     * @brief Shortest path between two users (unit weights)
+     * @param path --> std::vector<std::string>*: Receives the path (optional)
+     * @return int --> Size of the path, -1 if there is no path or a user doesn't exist
+    */
+    int shard::Coordinator::shortest_path(const std::string &src, const std::string &dest,
+                                          std::vector<std::string> *path)
+    {
+        if(!exists(src) || !exists(dest)) return -1;
+        return bfs(src, -1, false, &dest, path, nullptr);
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name khop_count()
+     * @brief Number of users within k hops of a user
+     * @param followers --> bool: false: Out-links, true: In-links
+    */
+    size_t shard::Coordinator::khop_count(const std::string &s, unsigned int k, bool followers){
+        if(!exists(s)) return 0;
+        size_t reached = 0;
+        bfs(s, k, followers, nullptr, nullptr, &reached);
+        return reached;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name diameter()
+     * @brief Longest shortest path of the network (BFS from every user)
+    */
+    int shard::Coordinator::diameter(){
+        std::vector<std::string> users;
+        for(unsigned int i = 0; i < shards(); i++){
+            auto part = request(i, {"L"});
+            users.insert(users.end(), part.begin(), part.end());
+        }
+        int ans = 0;
+        for(const auto &u : users) ans = std::max(ans, bfs(u, -1, false, nullptr, nullptr, nullptr));
+        return ans;
+    }
+
+    /**
+     * @namespace shard
+     * @class Coordinator
+     * @name console()
+     * @brief Line oriented front end (one command per line), used to drive the
+     *        partitioned mode from a terminal or a script
+     * @param in --> std::istream: Commands
+     * @param out --> std::ostream: Results
+    */
+    void shard::Coordinator::console(std::istream &in, std::ostream &out){
+        std::string line;
+        while(std::getline(in, line)){
+            std::istringstream cmd(line);
+            std::string op, a, b;
+            cmd >> op;
+            if(op.empty()) continue;
+            if(op == "sair") return;
+            if(op == "usuario"){
+                std::string nm, brth, phne, cty;
+                cmd >> a >> nm >> brth >> phne >> cty;
+                error_t ins = insert_node(a, nm, brth, phne, cty);
+                out << (ins.flag ? ins.errmsg : "Usuário cadastrado com sucesso!") << std::endl;
+            } else if(op == "seguir"){
+                cmd >> a >> b;
+                error_t flw = follow(a, b);
+                out << flw.errmsg << std::endl;
+            } else if(op == "deixar"){
+                cmd >> a >> b;
+                error_t unflw = unfollow(a, b);
+                out << (unflw.flag ? unflw.errmsg : "Operação realizada com sucesso!") << std::endl;
+            } else if(op == "remover"){
+                cmd >> a;
+                error_t rem = remove(a);
+                out << (rem.flag ? rem.errmsg : "Usuário excluido com sucesso!") << std::endl;
+            } else if(op == "caminho"){
+                cmd >> a >> b;
+                std::vector<std::string> path;
+                int d = shortest_path(a, b, &path);
+                if(d < 0){
+                    out << "Não existe caminho possível!" << std::endl;
+                    continue;
+                }
+                out << "Menor caminho de " << a << " para " << b << ": ";
+                for(size_t i = 0; i < path.size(); i++) out << path[i] << (i + 1 < path.size() ? " -> " : "");
+                out << std::endl << "Tamanho do caminho: " << d << std::endl;
+            } else if(op == "alcance"){
+                unsigned int k = 0;
+                cmd >> a >> k >> b;
+                out << "Usuários alcançados em até " << k << " passos: "
+                    << khop_count(a, k, b == "seguidores") << std::endl;
+            } else if(op == "diametro") out << "Diâmetro da rede (grafo da rede): " << diameter() << std::endl;
+            else if(op == "tamanho") out << "Quantidade de usuários cadastrados: " << size() << std::endl;
+            else out << "Opção inválida, por favor insira novamente!" << std::endl;
+        }
+    }
+
+} // namespace shard
@@ -0,0 +1,87 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile shard.h (header file)
+ * 
+ * Shard and Coordinator classes interface/structure
+ * Users are partitioned by email hash across N shard processes on the same host.
+ * Every shard owns a Network slice and its own SQLite file; the coordinator routes
+ * the operations and runs traversals as level synchronous BFS, exchanging one batched
+ * frontier message per shard and level over Unix sockets.
+ * Include guard
+ * 
+ * @attention POSIX (fork/socketpair) is needed!
+ * 
+*/
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "../SocialMedia/socialmedia.h"
+#include "../Database/database.h"
+
+namespace shard{
+
+unsigned int shard_of(const std::string &s, unsigned int nshards);
+
+class Shard : public socialmedia::SocialMedia{
+public:
+    Shard(unsigned int idx, unsigned int nshards, const std::string &dbname);
+    void serve(int fd);
+
+private:
+    unsigned int idx;
+    unsigned int nshards;
+    database::Database db;
+
+    bool local(const std::string &s) const { return shard_of(s, nshards) == idx; } // Inline
+    std::vector<std::string> handle(const std::vector<std::string> &cmd, bool &quit);
+};
+
+class Coordinator{
+public:
+    static constexpr unsigned int MAX_SHARDS = 64;   // Shard processes
+
+    struct error_t{
+        bool flag = false;
+        std::string errmsg;
+    };
+
+    Coordinator(unsigned int nshards, const std::string &dir = "src/Database");
+    ~Coordinator();
+    unsigned int shards() const { return channels.size(); } // Inline
+    error_t insert_node(const std::string &mail, const std::string &nm,
+                        const std::string &brth, const std::string &phne,
+                        const std::string &cty);
+    error_t follow(const std::string &src, const std::string &dest);
+    error_t unfollow(const std::string &src, const std::string &dest);
+    error_t remove(const std::string &s);
+    bool exists(const std::string &s);
+    size_t size();
+    int shortest_path(const std::string &src, const std::string &dest, std::vector<std::string> *path = nullptr);
+    size_t khop_count(const std::string &s, unsigned int k, bool followers = false);
+    int diameter();
+    void console(std::istream &in, std::ostream &out);
+    Coordinator(const Coordinator&) = delete;
+    Coordinator& operator=(const Coordinator&) = delete;
+
+private:
+    struct channel{
+        int fd = -1;
+        pid_t pid = -1;
+    };
+    std::vector<channel> channels;
+
+    static unsigned int stored_shards(const std::string &dir);
+    std::vector<std::string> request(unsigned int shard, const std::vector<std::string> &cmd);
+    std::vector<std::vector<std::string>> expand(const std::vector<std::string> &frontier, bool followers);
+    int bfs(const std::string &src, unsigned int k, bool followers, const std::string *dest,
+            std::vector<std::string> *path, size_t *reached);
+};
+
+} // namespace shard
+
+#endif // SHARD_H
@@ -9,9 +9,23 @@
 
 #include <iostream>
 #include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <unordered_set>
+#include <sqlite3.h>
 #include "socialmedia.h"
 #include "../Network/network.cpp"
 #include "../Database/database.cpp"
+#include "../Storage/storage.cpp"
+#include "../Analytics/triangles.cpp"
+#include "../Analytics/pagerank.cpp"
+#include "../Analytics/hyperanf.cpp"
+#include "../Analytics/betweenness.cpp"
+#include "../Analytics/communities.cpp"
+#include "../Timeline/timeline.cpp"
+#include "../Trace/trace.cpp"
 
 namespace socialmedia{
 
@@ -40,6 +54,21 @@ namespace socialmedia{
         std::cout << "7 - Verificar caminho para um usuário" << std::endl;
         std::cout << "8 - Exportar rede" << std::endl;
         std::cout << "9 - Exibir informações da rede" << std::endl; 
+        std::cout << "10 - Exibir usuários mais influentes (PageRank)" << std::endl;
+        std::cout << "11 - Ativar/desativar índice de distâncias" << std::endl;
+        std::cout << "12 - Consultar alcance de um usuário (k passos)" << std::endl;
+        std::cout << "13 - Publicar post" << std::endl;
+        std::cout << "14 - Exibir linha do tempo de um usuário" << std::endl;
+        std::cout << "15 - Ativar/desativar topologia compactada" << std::endl;
+        std::cout << "16 - Reordenar vértices (localidade)" << std::endl;
+        std::cout << "17 - Estimar alcance e distâncias (HyperANF)" << std::endl;
+        std::cout << "18 - Tarefas em segundo plano" << std::endl;
+        std::cout << "19 - Exibir usuários-ponte (centralidade de intermediação)" << std::endl;
+        std::cout << "20 - Detectar comunidades" << std::endl;
+        std::cout << "21 - Consultar núcleos (k-core)" << std::endl;
+        std::cout << "22 - Definir peso de uma ligação" << std::endl;
+        std::cout << "23 - Novos seguidores (janela de tempo)" << std::endl;
+        std::cout << "24 - Executar operações em lote (arquivo)" << std::endl;
     }
 
     /**
@@ -73,8 +102,636 @@ namespace socialmedia{
         std::cout << std::endl;
         std::cout << "Digite a opção (Digite o número referente a opção!): ";
         std::cin >> temp;
-        if(is_number(temp) && std::stoi(temp) >= 0 && std::stoi(temp) < 10) return std::stoi(temp);
-        return -1;
+        if(!is_number(temp) || temp.size() > 2) return -1;   // Bounded before converting (stoi throws on overflow)
+        int option = std::stoi(temp);
+        return option < 25 ? option : -1;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name list_clustering()
+     * @brief Show the number of triangles and the local clustering coefficient of a user.
+     *        Only the user neighbourhood is read (undirected view, self follows excluded):
+     *        every link between two neighbours closes a triangle, found once per pair
+     *        from the out-links of the neighbours.
+     * @param s --> const std::string: User email
+    */
+    void socialmedia::SocialMedia::list_clustering(const std::string &s){
+        const node *u = find(s);
+        if(!u) return;
+        std::unordered_set<const node*> around;
+        for_each_neighbour(u, [&](const node *x){ around.insert(x); });
+        std::less<const node*> before;
+        std::vector<std::pair<const node*, const node*>> closed;
+        for(const node *a : around)
+            for(const node *x : a->links)
+                if(x != a && around.count(x)) closed.emplace_back(std::min(a, x, before), std::max(a, x, before));
+        std::sort(closed.begin(), closed.end());
+        unsigned long triangles = std::unique(closed.begin(), closed.end()) - closed.begin();
+        unsigned long d = around.size();
+        std::cout << "Triângulos do usuário: " << triangles << std::endl;
+        std::cout << "Coeficiente de agrupamento local: " << (d < 2 ? 0 : (double)triangles / (d * (d - 1) / 2)) << std::endl;
+        std::cout << std::endl;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name clustering_stats()
+     * @brief Triangle count and clustering coefficients of the network, recomputed only
+     *        if the graph changed since the last call (exact parallel counting, or wedge
+     *        sampling when there are too many wedges)
+     * @return clustering_t --> Statistics of the current graph
+    */
+    const socialmedia::SocialMedia::clustering_t& socialmedia::SocialMedia::clustering_stats(){
+        if(clustering_version == version) return clustering;
+        analytics::Triangles tr(layout());
+        clustering = clustering_t();
+        clustering.wedges = tr.wedges();
+        clustering.exact = tr.exact_feasible();
+        if(clustering.exact){
+            tr.count();
+            clustering.triangles = tr.total();
+            clustering.global = tr.global_clustering();
+            clustering.average = tr.average_clustering();
+        } else{
+            auto est = tr.sample();
+            clustering.estimate = est.triangles;
+            clustering.global = est.transitivity;
+            clustering.margin = est.margin;
+            clustering.samples = est.samples;
+        }
+        clustering_version = version;
+        return clustering;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name update_pagerank()
+     * @brief Recompute the PageRank scores if the graph changed since the last run.
+     *        The previous scores are used as the starting vector (warm start), so small
+     *        mutations converge in a few iterations.
+    */
+    void socialmedia::SocialMedia::update_pagerank(){
+        if(ranks_version == version) return;
+        const network::CSR &g = layout();
+        std::vector<double> warm(g.size(), g.size() ? 1.0 / g.size() : 0);
+        for(unsigned int v = 0; v < g.size(); v++){
+            auto it = ranks.find(g.ids[v]);
+            if(it != ranks.end()) warm[v] = it->second;
+        }
+        analytics::PageRank pr(g);
+        pr.run(ranks.empty() ? nullptr : &warm);
+        ranks.clear();
+        ranks.reserve(g.size());
+        for(unsigned int v = 0; v < g.size(); v++) ranks[g.ids[v]] = pr.scores()[v];
+        ranks_version = version;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name top_influencers()
+     * @brief Get the k most influent users by PageRank (harder to game than follower count)
+     * @param k --> size_t: Number of users
+     * @return std::vector<std::pair> --> (email, score) sorted by score (descending)
+    */
+    std::vector<std::pair<std::string, double>> socialmedia::SocialMedia::top_influencers(size_t k){
+        update_pagerank();
+        std::vector<std::pair<std::string, double>> ans(ranks.begin(), ranks.end());
+        k = std::min(k, ans.size());
+        std::partial_sort(ans.begin(), ans.begin() + k, ans.end(), [](const auto &a, const auto &b){
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        });
+        ans.resize(k);
+        return ans;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name top_influencers()
+     * @brief Get the k most influent users from the point of view of a user (personalised PageRank)
+     * @param seed --> const std::string: User email used as the teleport target
+     * @param k --> size_t: Number of users
+     * @return std::vector<std::pair> --> (email, score) sorted by score (descending), empty if
+     *                                    the user doesn't exist
+    */
+    std::vector<std::pair<std::string, double>> socialmedia::SocialMedia::top_influencers(const std::string &seed,
+                                                                                         size_t k)
+    {
+        std::vector<std::pair<std::string, double>> ans;
+        const network::CSR &g = layout();
+        int s = g.find(seed);
+        if(s < 0) return ans;
+        analytics::PageRank pr(g);
+        pr.run_personalized({(unsigned int)s});
+        for(const auto &p : pr.top(k)) ans.emplace_back(g.ids[p.first], p.second);
+        return ans;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name neighbourhood_function()
+     * @brief Approximate neighbourhood function (HyperANF), recomputed only if the graph or
+     *        the direction changed since the last run
+     * @param followers --> bool: false: Following links, true: Followers
+     * @return const analytics::HyperANF --> Counters of the current graph
+    */
+    const analytics::HyperANF& socialmedia::SocialMedia::neighbourhood_function(bool followers){
+        if(!anf || anf_version != version || anf_followers != followers){
+            anf.reset(new analytics::HyperANF(layout()));
+            anf->run(followers);
+            anf_version = version;
+            anf_followers = followers;
+        }
+        return *anf;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name diameter_job()
+     * @brief Graph diameter computed in the background on a snapshot of the current graph
+     *        (compressed topology when enabled), so the menu keeps answering while it runs.
+     *        The job is reused while the graph doesn't change; a job of an older graph is
+     *        cancelled and replaced.
+     * @param budget --> double: Time limit in seconds (0: none), the result is then partial
+     * @return const jobs::Job<int> --> Handle of the job (progress, wait, cancel, result)
+    */
+    const jobs::Job<int>& socialmedia::SocialMedia::diameter_job(double budget){
+        if(diameter.valid() && diameter_version == version && !(diameter.finished() && diameter.partial()))
+            return diameter;
+        if(diameter.valid()) diameter.cancel();
+        if(compressed_layout()){
+            auto g = std::make_shared<network::CompressedCSR>(packed_layout());
+            diameter = scheduler.submit<int>("Diâmetro da rede", [g](jobs::Control &control){
+                return graph_diameter(*g, &control);
+            }, budget);
+        }
+        else{
+            auto g = std::make_shared<network::CSR>(layout());
+            diameter = scheduler.submit<int>("Diâmetro da rede", [g](jobs::Control &control){
+                return graph_diameter(*g, &control);
+            }, budget);
+        }
+        diameter_version = version;
+        return diameter;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name estimated_reach()
+     * @brief Estimated audience of a user: users within k hops (HyperLogLog counters, so the
+     *        cost is shared by every user instead of one BFS per query)
+     * @param s --> const std::string: User email
+     * @param k --> unsigned int: Maximum number of hops
+     * @param followers --> bool: false: Users reached by following links, true: Users that reach s
+     * @return double --> Estimated reach (-1 if the user doesn't exist)
+    */
+    double socialmedia::SocialMedia::estimated_reach(const std::string &s, unsigned int k, bool followers){
+        const analytics::HyperANF &f = neighbourhood_function(followers);
+        int v = layout().find(s);
+        return v < 0 ? -1 : f.reach(v, k);
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name rank_bridges()
+     * @brief Most central users by betweenness (bridge accounts between communities)
+     * @param g --> const network::CSR: Graph snapshot
+     * @param k --> size_t: Number of users
+     * @param samples --> unsigned long: Sampled sources (0: exact if feasible, else the default sample)
+     * @param control --> jobs::Control*: Progress/cancellation of the job (nullptr: none)
+     * @return bridges_t --> Top k users, error bound and sources used
+    */
+    socialmedia::SocialMedia::bridges_t socialmedia::SocialMedia::rank_bridges(const network::CSR &g, size_t k,
+                                                                               unsigned long samples,
+                                                                               jobs::Control *control)
+    {
+        bridges_t ans;
+        analytics::Betweenness bc(g);
+        if(!samples && bc.exact_feasible()) bc.run(control);
+        else bc.sample(samples ? samples : analytics::Betweenness::DEFAULT_SAMPLES, 0.95, 42, control);
+        for(const auto &p : bc.top(k)) ans.top.emplace_back(g.ids[p.first], p.second);
+        ans.margin = bc.margin();
+        ans.sources = bc.sampled();
+        return ans;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name top_bridges()
+     * @brief Get the k users with the highest betweenness centrality
+     * @param k --> size_t: Number of users
+     * @param samples --> unsigned long: Sampled sources (0: exact if feasible, else the default sample)
+     * @return bridges_t --> Top k users, error bound and sources used
+    */
+    socialmedia::SocialMedia::bridges_t socialmedia::SocialMedia::top_bridges(size_t k, unsigned long samples){
+        return rank_bridges(layout(), k, samples, nullptr);
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name bridges_job()
+     * @brief top_bridges() in the background on a snapshot of the current graph. The job is
+     *        reused while the graph and the query don't change. A stopped job keeps the
+     *        estimate from the sources done so far. k and samples are capped at the
+     *        number of users.
+     * @param k --> size_t: Number of users
+     * @param samples --> unsigned long: Sampled sources (0: exact if feasible, else the default sample)
+     * @param budget --> double: Time limit in seconds (0: none)
+     * @return const jobs::Job<bridges_t> --> Handle of the job
+    */
+    const jobs::Job<socialmedia::SocialMedia::bridges_t>& socialmedia::SocialMedia::bridges_job(size_t k,
+                                                                                               unsigned long samples,
+                                                                                               double budget)
+    {
+        k = std::min(k, size());
+        samples = std::min<unsigned long>(samples, size());
+        std::pair<size_t, unsigned long> query(k, samples);
+        if(bridges.valid() && bridges_version == version && bridges_query == query &&
+           !(bridges.finished() && bridges.partial()))
+            return bridges;
+        if(bridges.valid()) bridges.cancel();
+        auto g = std::make_shared<network::CSR>(layout());
+        bridges = scheduler.submit<bridges_t>("Centralidade de intermediação", [g, k, samples](jobs::Control &control){
+            return rank_bridges(*g, k, samples, &control);
+        }, budget);
+        bridges_version = version;
+        bridges_query = query;
+        return bridges;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name detect_communities()
+     * @brief Group the users into communities and keep the community of every user (used by
+     *        list_user(), community_members() and the colours of create_dot()). Community 1
+     *        is the largest one.
+     * @param louvain --> bool: true: Louvain (quality) // false: Label propagation (speed)
+     * @return communities_t --> Number of communities, modularity and sizes
+    */
+    socialmedia::SocialMedia::communities_t socialmedia::SocialMedia::detect_communities(bool louvain){
+        communities_t ans;
+        const network::CSR &g = layout();
+        analytics::Communities cm(g);
+        if(louvain) cm.louvain();
+        else cm.label_propagation();
+        std::vector<unsigned int> sizes = cm.sizes(), rank(sizes.size());
+        std::iota(rank.begin(), rank.end(), 0u);
+        std::sort(rank.begin(), rank.end(), [&](unsigned int a, unsigned int b){
+            return sizes[a] > sizes[b] || (sizes[a] == sizes[b] && a < b);
+        });
+        std::vector<unsigned int> id(sizes.size());
+        for(unsigned int i = 0; i < rank.size(); i++){
+            id[rank[i]] = i + 1;
+            ans.sizes.push_back(sizes[rank[i]]);
+        }
+        for(unsigned int v = 0; v < g.size(); v++) find(g.ids[v])->community = id[cm.labels()[v]];
+        ans.count = cm.count();
+        ans.modularity = cm.modularity();
+        return ans;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name publish()
+     * @brief Publish a post. Regular accounts push it to every follower home timeline
+     *        (fan-out on write); accounts with more than CELEBRITY_FOLLOWERS followers
+     *        don't, their posts are pulled when a timeline is read. The choice is kept in
+     *        the post (posts loaded from storage are decided again on load).
+     * @param author --> const std::string: Author email
+     * @param text --> const std::string: Post content
+     * @param time --> long long: Publication time (Unix time)
+     * @param id --> unsigned long: Post id (0: new id, other: loaded from the database)
+     * @return const post* --> Published post, nullptr if the author doesn't exist
+    */
+    const timeline::Timeline::post* socialmedia::SocialMedia::publish(const std::string &author, const std::string &text,
+                                                                      long long time, unsigned long id)
+    {
+        node *pauthor = find(author);
+        if(!pauthor) return nullptr;
+        bool push = pauthor->followers.size() <= timeline::Timeline::CELEBRITY_FOLLOWERS;
+        const auto &p = timelines.add_post(author, time, text, push, id);
+        if(push)
+            for(auto flwr : pauthor->followers) timelines.deliver(flwr->user.email, p.id);
+        return &p;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name home_timeline()
+     * @brief Most recent posts of the user and of everyone the user follows: the inbox
+     *        (pushed posts, kept while the user still follows the author, checked on the
+     *        shorter of the two adjacency lists), the user's own posts and the pulled posts
+     *        of the followed authors
+     * @param user --> const std::string: User email
+     * @param limit --> size_t: Maximum number of posts
+     * @return std::vector<const post*> --> Posts, newest first (empty if the user doesn't exist)
+    */
+    std::vector<const timeline::Timeline::post*> socialmedia::SocialMedia::home_timeline(const std::string &user,
+                                                                                         size_t limit)
+    {
+        node *puser = find(user);
+        if(!puser) return {};
+        std::vector<const std::vector<unsigned long>*> lists;
+        if(auto own = timelines.own_posts(user)) lists.push_back(own);
+        for(auto link : puser->links)
+            if(auto read = timelines.pulled_posts(link->user.email)) lists.push_back(read);
+        auto follows = [this, puser](const timeline::Timeline::post &p){
+            const node *author = find(p.author);
+            if(!author) return false;
+            if(author->followers.size() < puser->links.size()) return contains(author->followers, puser);
+            return contains(puser->links, author);
+        };
+        return timelines.merge(user, lists, follows, limit);
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name remove_node()
+     * @brief Remove a user without asking for confirmation, along with the user posts
+     *        and home timeline (used when replaying a storage log)
+     * @param s --> const std::string: User email
+     * @return error_t --> Struct defined in network.h to handle errors
+    */
+    network::Network::error_t socialmedia::SocialMedia::remove_node(const std::string &s){
+        error_t rm = network::Network::remove_node(s);
+        if(!rm.flag) timelines.remove_user(s);
+        return rm;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name follow_many()
+     * @brief Create many links at once (as Network::follow_many()) and save the new ones in
+     *        a single storage transaction
+     * @param pairs --> const std::vector<std::pair<std::string, std::string>>: (follower, followed) links
+     * @param db --> storage::Storage: Where the changes are persisted
+     * @return std::vector<status_t> --> Result of every link, in input order
+    */
+    std::vector<network::Network::status_t>
+    socialmedia::SocialMedia::follow_many(const std::vector<std::pair<std::string, std::string>> &pairs,
+                                          storage::Storage &db)
+    {
+        link_t attr{static_cast<unsigned int>(std::time(nullptr)), 1};   // Every new link gets the same attributes
+        std::vector<status_t> status;
+        insert_links(pairs, std::vector<link_t>(pairs.size(), attr), &status);
+        db.begin();
+        for(size_t i = 0; i < pairs.size(); i++)
+            if(status[i] == OK) db.save_link(pairs[i].first, pairs[i].second, attr.time, attr.weight);
+        db.commit();
+        return status;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name unfollow_many()
+     * @brief Delete many links at once (Network::unfollow_many()) in a single storage transaction
+     * @param pairs --> const std::vector<std::pair<std::string, std::string>>: (follower, followed) links
+     * @param db --> storage::Storage: Where the changes are persisted
+     * @return std::vector<status_t> --> Result of every link, in input order
+    */
+    std::vector<network::Network::status_t>
+    socialmedia::SocialMedia::unfollow_many(const std::vector<std::pair<std::string, std::string>> &pairs,
+                                            storage::Storage &db)
+    {
+        auto status = network::Network::unfollow_many(pairs);
+        db.begin();
+        for(size_t i = 0; i < pairs.size(); i++)
+            if(status[i] == OK) db.drop_link(pairs[i].first, pairs[i].second);
+        db.commit();
+        return status;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name remove_many()
+     * @brief Remove many users at once (Network::remove_many()) with their posts and home
+     *        timelines, in a single storage transaction
+     * @param users --> const std::vector<std::string>: User emails
+     * @param db --> storage::Storage: Where the changes are persisted
+     * @return std::vector<status_t> --> OK or NOT_FOUND for every user, in input order
+    */
+    std::vector<network::Network::status_t>
+    socialmedia::SocialMedia::remove_many(const std::vector<std::string> &users, storage::Storage &db){
+        auto status = network::Network::remove_many(users);
+        db.begin();
+        for(size_t i = 0; i < users.size(); i++){
+            if(status[i] != OK) continue;
+            timelines.remove_user(users[i]);
+            db.drop_user(users[i]);
+        }
+        db.commit();
+        return status;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name record_trace()
+     * @brief Start recording the menu operations to a trace file (see trace::Replayer)
+     * @param path --> const std::string: Trace file (overwritten)
+     * @return bool --> true: Recording, false: The file can't be created
+    */
+    bool socialmedia::SocialMedia::record_trace(const std::string &path){
+        recorder = std::make_unique<trace::Recorder>(path);
+        if(recorder->good()) return true;
+        recorder.reset();
+        return false;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name execute()
+     * @brief Run a recorded operation the way the menu does, without the terminal output
+     *        (removals are not confirmed)
+     * @param r --> const trace::record_t: Recorded operation
+     * @param db --> storage::Storage: Where the changes are persisted
+     * @return bool --> true: Operation done, false: Rejected (missing user, invalid input...)
+    */
+    bool socialmedia::SocialMedia::execute(const trace::record_t &r, storage::Storage &db){
+        static const size_t ARGS[] = {0, 5, 2, 2, 1, 1, 2, 1, 3, 2, 1, 0, 0, 0, 0};   // 0: batch
+        if(r.op < trace::USER || r.op >= trace::OPS) return false;
+        if(!ARGS[r.op]){
+            auto status = batch(r, db);
+            return !status.empty() && std::all_of(status.begin(), status.end(), [](status_t st){ return st == OK; });
+        }
+        if(r.args.size() != ARGS[r.op]) return false;
+        const std::vector<std::string> &a = r.args;
+        switch(r.op){
+            case trace::USER:
+                if(insert_node(a[0], a[1], a[2], a[3], a[4]).flag) return false;
+                return db.save_user(a[0], a[1], a[2], a[3], a[4]);
+
+            case trace::FOLLOW:
+            {
+                if(follow(a[0], a[1]).flag) return false;
+                const link_t *l = link(a[0], a[1]);
+                return db.save_link(a[0], a[1], l->time, l->weight);
+            }
+
+            case trace::UNFOLLOW:
+                if(unfollow(a[0], a[1]).flag) return false;
+                return db.drop_link(a[0], a[1]);
+
+            case trace::LOOKUP:
+                return find(a[0]) != nullptr;
+
+            case trace::REMOVE:
+                if(remove_node(a[0]).flag) return false;
+                return db.drop_user(a[0]);
+
+            case trace::PATH:
+                return distance(a[0], a[1]) >= 0;
+
+            case trace::RANKING:
+                if(a[0] == "*") return !top_influencers(10).empty();
+                return find(a[0]) && !top_influencers(a[0], 10).empty();
+
+            case trace::REACH:
+                if(!find(a[0]) || !is_number(a[1]) || a[1].size() > 9 || (a[2] != "1" && a[2] != "2")) return false;
+                khop_count(a[0], std::stoul(a[1]), a[2] == "2");
+                return true;
+
+            case trace::POST:
+            {
+                auto p = publish(a[0], a[1], std::time(nullptr));
+                return p && db.save_post(p->id, p->author, p->time, p->text);
+            }
+
+            case trace::TIMELINE:
+                if(!find(a[0])) return false;
+                home_timeline(a[0], 20);
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name batch()
+     * @brief Apply a batch operation (FOLLOW_MANY, UNFOLLOW_MANY and PATH_MANY: pairs of
+     *        emails, REMOVE_MANY: emails) with follow_many(), unfollow_many(), shortest_paths()
+     *        or remove_many()
+     * @param r --> const trace::record_t: Batch operation
+     * @param db --> storage::Storage: Where the changes are persisted
+     * @param paths --> std::vector<path_t>*: Receives the distance of every PATH_MANY query (optional)
+     * @return std::vector<status_t> --> Result of every pair/user (empty: not a valid batch);
+     *         a PATH_MANY query is OK when there is a path, NOT_FOUND otherwise
+    */
+    std::vector<network::Network::status_t>
+    socialmedia::SocialMedia::batch(const trace::record_t &r, storage::Storage &db, std::vector<path_t> *paths){
+        const std::vector<std::string> &a = r.args;
+        if(r.op == trace::REMOVE_MANY) return a.empty() ? std::vector<status_t>() : remove_many(a, db);
+        if((r.op != trace::FOLLOW_MANY && r.op != trace::UNFOLLOW_MANY && r.op != trace::PATH_MANY)
+           || a.empty() || a.size() % 2)
+            return {};
+        std::vector<std::pair<std::string, std::string>> pairs;
+        pairs.reserve(a.size() / 2);
+        for(size_t i = 0; i < a.size(); i += 2) pairs.emplace_back(a[i], a[i + 1]);
+        if(r.op == trace::PATH_MANY){
+            std::vector<path_t> found = shortest_paths(pairs);
+            std::vector<status_t> status(found.size());
+            for(size_t i = 0; i < found.size(); i++) status[i] = found[i].distance >= 0 ? OK : NOT_FOUND;
+            if(paths) *paths = std::move(found);
+            return status;
+        }
+        return r.op == trace::FOLLOW_MANY ? follow_many(pairs, db) : unfollow_many(pairs, db);
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name run_batch()
+     * @brief Apply a file of operations, one per line: "seguir <email1> <email2>",
+     *        "deixar <email1> <email2>", "remover <email>" or "caminho <email1> <email2>".
+     *        Consecutive lines with the same command run as one batch (one storage
+     *        transaction, one trace record); the distances of a path batch are shown.
+     * @param path --> const std::string: File with the operations
+     * @param db --> storage::Storage: Where the changes are persisted
+     * @return bool --> false: The file couldn't be read
+    */
+    bool socialmedia::SocialMedia::run_batch(const std::string &path, storage::Storage &db){
+        std::ifstream file(path);
+        if(!file.is_open()) return false;
+        trace::record_t run{trace::OPS, 0, {}};
+        size_t done = 0, rejected = 0, invalid = 0;
+        auto apply = [&](){
+            if(run.args.empty()) return;
+            record(run.op, run.args);
+            std::vector<path_t> paths;
+            for(status_t st : batch(run, db, &paths)){
+                if(st == OK) done++;
+                else rejected++;
+            }
+            for(size_t i = 0; i < paths.size(); i++){
+                const std::string &src = run.args[2 * i], &dest = run.args[2 * i + 1];
+                if(paths[i].distance < 0) std::cout << "Não há caminho de " << src << " para " << dest << std::endl;
+                else std::cout << "Distância de " << src << " para " << dest << ": " << paths[i].distance << std::endl;
+            }
+            run.args.clear();
+        };
+        std::string line;
+        while(std::getline(file, line)){
+            std::istringstream in(line);
+            std::string cmd, a, b;
+            if(!(in >> cmd)) continue;
+            trace::op_t op = cmd == "seguir" ? trace::FOLLOW_MANY : cmd == "deixar" ? trace::UNFOLLOW_MANY
+                           : cmd == "remover" ? trace::REMOVE_MANY : cmd == "caminho" ? trace::PATH_MANY : trace::OPS;
+            bool pair = op != trace::REMOVE_MANY;
+            if(op == trace::OPS || !(in >> a) || (pair && !(in >> b))){
+                invalid++;
+                continue;
+            }
+            if(op != run.op) apply();
+            run.op = op;
+            run.args.push_back(a);
+            if(pair) run.args.push_back(b);
+        }
+        apply();
+        std::cout << std::endl << "Operações em lote: " << done << " realizadas, " << rejected
+                  << " rejeitadas, " << invalid << " linhas inválidas" << std::endl;
+        return true;
+    }
+
+    /**
+     * @namespace socialmedia
+     * @class SocialMedia
+     * @name memory_report()
+     * @brief Memory used by the network graph plus the posts, the PageRank scores and
+     *        the SQLite page cache
+     * @return MemoryReport --> Bytes and heap blocks per category
+    */
+    network::MemoryReport socialmedia::SocialMedia::memory_report() const{
+        network::MemoryReport r = network::Network::memory_report();
+        r.add("Publicações e timelines", timelines.bytes(), 3 + 2 * timelines.size());
+        size_t scores = ranks.bucket_count() * sizeof(void*);
+        for(const auto &p : ranks)
+            scores += sizeof(p) + 2 * sizeof(void*) + network::MemoryReport::heap(p.first);
+        r.add("Ranking (PageRank)", scores, 1 + ranks.size());
+        if(anf) r.add("Vizinhança estimada (HyperANF)", anf->bytes(), 2 + anf->iterations());
+        r.add("SQLite (cache de páginas)", sqlite3_memory_used(), 0);
+        return r;
     }
 
     /**
@@ -91,8 +748,59 @@ namespace socialmedia{
         os << "Quantidade de usuários cadastrados: " << sm.nodes.size() << std::endl;
         os << "Grau médio de entrada: " << sm.network_indegree_rate() << std::endl;
         os << "Grau médio de saída: " << sm.network_outdegree_rate() << std::endl;
-        os << "Diâmetro da rede (grafo da rede): " << sm.network_graph_diameter() << std::endl;
+        const jobs::Job<int> &diameter = sm.diameter_job();
+        diameter.wait_for(std::chrono::milliseconds(200));   // Small graphs: answer right away
+        os << "Diâmetro da rede (grafo da rede): ";
+        if(const int *d = diameter.result())
+            os << *d << (diameter.partial() ? " (parcial, limite inferior)" : "") << std::endl;
+        else
+            os << "calculando em segundo plano (" << (int)(diameter.progress() * 100)
+               << "%, tarefa " << diameter.id() << ", veja a opção 18)" << std::endl;
         os << "Usuário com maior número de seguidores: " << sm.most_followed_user() << std::endl;
+        auto weak = sm.weak_component_sizes();
+        auto strong = sm.strong_component_sizes();
+        os << "Componentes fracamente conexos: " << weak.size() << " (maior: "
+           << (weak.empty() ? 0 : *std::max_element(weak.begin(), weak.end())) << " usuários)" << std::endl;
+        os << "Componentes fortemente conexos: " << strong.size() << " (maior: "
+           << (strong.empty() ? 0 : *std::max_element(strong.begin(), strong.end())) << " usuários)" << std::endl;
+        unsigned int d = sm.degeneracy();
+        os << "Degeneração (maior k-core): " << d << " (" << sm.core_count[d] << " usuários no núcleo)" << std::endl;
+        if(sm.compressed_layout()){
+            size_t links = sm.packed_layout().edges();
+            os << "Topologia compactada: " << sm.compressed_bytes() << " bytes ("
+               << (links ? (double)sm.compressed_bytes() / links : 0) << " por ligação)" << std::endl;
+        }
+        const jobs::Job<SocialMedia::bridges_t> &bridges = sm.bridges_job();
+        bridges.wait_for(std::chrono::milliseconds(200));
+        os << "Usuários-ponte (intermediação): ";
+        if(const SocialMedia::bridges_t *b = bridges.result()){
+            for(size_t i = 0; i < b->top.size(); i++){
+                os << b->top[i].first << " (" << b->top[i].second << ")";
+                if(i + 1 != b->top.size()) os << ", ";
+            }
+            if(b->margin) os << " [estimativa: ± " << b->margin << ", " << b->sources << " fontes]";
+            os << std::endl;
+        } else
+            os << "calculando em segundo plano (" << (int)(bridges.progress() * 100)
+               << "%, tarefa " << bridges.id() << ", veja a opção 18)" << std::endl;
+        auto influencers = sm.top_influencers(3);
+        os << "Usuários mais influentes (PageRank): ";
+        for(size_t i = 0; i < influencers.size(); i++){
+            os << influencers[i].first << " (" << influencers[i].second << ")";
+            if(i + 1 != influencers.size()) os << ", ";
+        }
+        os << std::endl;
+        const auto &cl = sm.clustering_stats();
+        if(cl.exact){
+            os << "Quantidade de triângulos: " << cl.triangles << std::endl;
+            os << "Coeficiente de agrupamento global: " << cl.global << std::endl;
+            os << "Coeficiente de agrupamento médio: " << cl.average << std::endl;
+        } else{
+            os << "Quantidade de triângulos (estimativa): " << cl.estimate
+               << " ± " << cl.margin * cl.wedges / 3.0 << std::endl;
+            os << "Coeficiente de agrupamento global (estimativa): " << cl.global
+               << " ± " << cl.margin << " (95%, " << cl.samples << " amostras)" << std::endl;
+        }
         return os;
     }
 
@@ -104,15 +812,25 @@ namespace socialmedia{
      *        using a switch statement to delegate what the application will do.
      *        Also control the database flow (insert/delete users and links).
      * @param sm --> SocialMedia object
+     * @param backend --> const std::string: Storage backend ("sqlite", "log" or "memory")
     */
-    void socialmedia::SocialMedia::init(socialmedia::SocialMedia &sm){
-        database::Database db(sm);
+    void socialmedia::SocialMedia::init(socialmedia::SocialMedia &sm, const std::string &backend){
+        auto db = storage::open(backend, sm);
+        if(!db){
+            std::cout << "Armazenamento inválido: " << backend << std::endl;
+            return;
+        }
+        std::string index;
+        unsigned long fp;
+        if(db->load_distance_index(index, fp) && fp == fingerprint() && load_distance_index(index))
+            std::cout << "Índice de distâncias carregado!" << std::endl;
         show_menu();
         int ins;
         while(true){
             ins = get_instruction();
             switch(ins){
                 case 0:
+                    db->save_distance_index(dump_distance_index(), fingerprint());
                     std::cout << std::endl;
                     std::cout << "Até mais!" << std::endl;
                     return;
@@ -137,13 +855,14 @@ namespace socialmedia{
                     std::cout << "Cidade: ";
                     std::cin >> cty;
                     std::cout << std::endl;
+                    record(trace::USER, {mail, nm, brth, phne, cty});
                     error_t insert = insert_node(mail, nm, brth, phne, cty);
                     if(insert.flag){
                         std::cout << std::endl << insert.errmsg << std::endl;
                         break;
                     }
                     show_menu();
-                    db.save_user(mail, nm, brth, phne, cty);
+                    db->save_user(mail, nm, brth, phne, cty);
                     std::cout << std::endl;
                     std::cout << "Usuário cadastrado com sucesso!" << std::endl;
                     std::cout << std::endl;
@@ -160,15 +879,17 @@ namespace socialmedia{
                     std::cout << "Informe o email do segundo usuário: ";
                     std::cin >> mail2;
                     std::cout << std::endl;
+                    record(trace::FOLLOW, {mail, mail2});
                     error_t flw = follow(mail, mail2);
                     if(flw.flag){
                         std::cout << std::endl << flw.errmsg << std::endl;
                         break;
                     }
                     show_menu();
-                    db.save_link(mail, mail2);
+                    const link_t *l = link(mail, mail2);
+                    db->save_link(mail, mail2, l->time, l->weight);
                     std::cout << std::endl;
-                    std::cout << flw.errmsg << std::endl;
+                    std::cout << "Usuario: " << mail << " começou a seguir: " << mail2 << std::endl;
                     std::cout << std::endl;
                     break;
                 }
@@ -183,11 +904,13 @@ namespace socialmedia{
                     std::cout << "Informe o email do segundo usuário: ";
                     std::cin >> mail2;
                     std::cout << std::endl;
+                    record(trace::UNFOLLOW, {mail, mail2});
                     error_t unflw = unfollow(mail, mail2);
                     if(unflw.flag){
                         std::cout << std::endl << unflw.errmsg << std::endl;
                         break;
                     }
+                    db->drop_link(mail, mail2);
                     show_menu();
                     std::cout << std::endl;
                     std::cout << "Operação realizada com sucesso!" << std::endl;
@@ -208,7 +931,9 @@ namespace socialmedia{
                     std::cin >> mail;
                     std::cout << std::endl;
                     show_menu();
+                    record(trace::LOOKUP, {mail});
                     list_user(mail);
+                    list_clustering(mail);
                     break;
                 }
 
@@ -225,7 +950,9 @@ namespace socialmedia{
                         break;
                     }
                     show_menu();
-                    db.drop_user(mail);
+                    record(trace::REMOVE, {mail});
+                    timelines.remove_user(mail);
+                    db->drop_user(mail);
                     std::cout << std::endl;
                     std::cout << "Usuário excluido com sucesso!" << std::endl;
                     std::cout << std::endl;
@@ -243,6 +970,7 @@ namespace socialmedia{
                     std::cin >> mail2;
                     std::cout << std::endl;
                     show_menu();
+                    record(trace::PATH, {mail, mail2});
                     error_t path = shortest_path(mail, mail2);
                     if(path.flag){
                         std::cout << std::endl << path.errmsg << std::endl;
@@ -276,7 +1004,389 @@ namespace socialmedia{
                 case 9:
                     show_menu();
                     std::cout << std::endl << sm << std::endl;
+                    std::cout << sm.memory_report() << std::endl;
+                    break;
+
+                case 10:
+                {
+                    std::string mail;
+                    std::cout << std::endl;
+                    std::cout << "Informe o email do usuário para um ranking personalizado (* para o ranking global): ";
+                    std::cin >> mail;
+                    std::cout << std::endl;
+                    show_menu();
+                    record(trace::RANKING, {mail});
+                    if(mail != "*" && !find(mail)){
+                        std::cout << std::endl << "Usuário inexistente!" << std::endl;
+                        break;
+                    }
+                    auto top = mail == "*" ? top_influencers(10) : top_influencers(mail, 10);
+                    std::cout << std::endl << "Usuários mais influentes:" << std::endl;
+                    for(size_t i = 0; i < top.size(); i++)
+                        std::cout << i + 1 << ". " << top[i].first << " (" << top[i].second << ")" << std::endl;
+                    std::cout << std::endl;
+                    break;
+                }
+
+                case 11:
+                    show_menu();
+                    distance_index(!distance_index());
+                    std::cout << std::endl << "Índice de distâncias "
+                              << (distance_index() ? "ativado!" : "desativado!") << std::endl;
+                    break;
+
+                case 12:
+                {
+                    std::string mail, hops, dir;
+                    std::cout << std::endl;
+                    std::cout << "Informe o email do usuário: ";
+                    std::cin >> mail;
+                    std::cout << std::endl;
+                    std::cout << "Informe o número de passos (k): ";
+                    std::cin >> hops;
+                    std::cout << std::endl;
+                    std::cout << "Direção (1 = quem o usuário alcança // 2 = quem alcança o usuário): ";
+                    std::cin >> dir;
+                    std::cout << std::endl;
+                    show_menu();
+                    record(trace::REACH, {mail, hops, dir});
+                    if(!find(mail)){
+                        std::cout << std::endl << "Usuário inexistente!" << std::endl;
+                        break;
+                    }
+                    if(!is_number(hops) || hops.size() > 9 || (dir != "1" && dir != "2")){   // k fits an unsigned int
+                        std::cout << std::endl << "Opção inválida!" << std::endl;
+                        break;
+                    }
+                    const size_t SHOWN = 20;
+                    unsigned int k = std::stoul(hops);
+                    bool followers = dir == "2";
+                    auto users = khop(mail, k, SHOWN, followers);
+                    std::cout << std::endl << "Usuários alcançados em até " << k << " passos: "
+                              << khop_count(mail, k, followers) << std::endl;
+                    for(const auto &u : users) std::cout << u << std::endl;
+                    std::cout << std::endl;
                     break;
+                }
+
+                case 13:
+                {
+                    std::string mail, text;
+                    std::cout << std::endl;
+                    std::cout << "Informe o email do autor: ";
+                    std::cin >> mail;
+                    std::cout << std::endl;
+                    std::cout << "Texto do post: ";
+                    std::getline(std::cin >> std::ws, text);
+                    std::cout << std::endl;
+                    show_menu();
+                    record(trace::POST, {mail, text});
+                    auto p = publish(mail, text, std::time(nullptr));
+                    if(!p){
+                        std::cout << std::endl << "Usuário inexistente!" << std::endl;
+                        break;
+                    }
+                    db->save_post(p->id, p->author, p->time, p->text);
+                    std::cout << std::endl << "Post publicado com sucesso!" << std::endl;
+                    std::cout << std::endl;
+                    break;
+                }
+
+                case 14:
+                {
+                    std::string mail;
+                    std::cout << std::endl;
+                    std::cout << "Informe o email do usuário: ";
+                    std::cin >> mail;
+                    std::cout << std::endl;
+                    show_menu();
+                    record(trace::TIMELINE, {mail});
+                    if(!find(mail)){
+                        std::cout << std::endl << "Usuário inexistente!" << std::endl;
+                        break;
+                    }
+                    const size_t SHOWN = 20;
+                    std::cout << std::endl << "Linha do tempo de " << mail << ":" << std::endl;
+                    for(auto p : home_timeline(mail, SHOWN)){
+                        char date[32];
+                        std::time_t t = p->time;
+                        std::strftime(date, sizeof(date), "%d/%m/%Y %H:%M", std::localtime(&t));
+                        std::cout << std::endl << p->author << " (" << date << "):" << std::endl;
+                        std::cout << p->text << std::endl;
+                    }
+                    std::cout << std::endl;
+                    break;
+                }
+
+                case 15:
+                    show_menu();
+                    compressed_layout(!compressed_layout());
+                    std::cout << std::endl << "Topologia compactada "
+                              << (compressed_layout() ? "ativada!" : "desativada!") << std::endl;
+                    break;
+
+                case 16:
+                {
+                    std::string method;
+                    std::cout << std::endl;
+                    std::cout << "Ordem (0 = nenhuma // 1 = grau // 2 = RCM // 3 = Gorder): ";
+                    std::cin >> method;
+                    std::cout << std::endl;
+                    show_menu();
+                    if(method.size() != 1 || method[0] < '0' || method[0] > '3'){
+                        std::cout << std::endl << "Opção inválida, por favor insira novamente!" << std::endl;
+                        break;
+                    }
+                    vertex_order(static_cast<network::VertexOrder::method_t>(method[0] - '0'));
+                    std::cout << std::endl << "Ordem dos vértices: "
+                              << network::VertexOrder::name(vertex_order()) << std::endl;
+                    break;
+                }
+
+                case 17:
+                {
+                    std::string mail, hops, dir = "1";
+                    std::cout << std::endl;
+                    std::cout << "Informe o email do usuário (* para a rede inteira): ";
+                    std::cin >> mail;
+                    std::cout << std::endl;
+                    if(mail != "*"){
+                        std::cout << "Informe o número de passos (k): ";
+                        std::cin >> hops;
+                        std::cout << std::endl;
+                        std::cout << "Direção (1 = quem o usuário alcança // 2 = quem alcança o usuário): ";
+                        std::cin >> dir;
+                        std::cout << std::endl;
+                    }
+                    show_menu();
+                    if(mail != "*" && !find(mail)){
+                        std::cout << std::endl << "Usuário inexistente!" << std::endl;
+                        break;
+                    }
+                    if((mail != "*" && (!is_number(hops) || hops.size() > 9)) || (dir != "1" && dir != "2")){
+                        std::cout << std::endl << "Opção inválida!" << std::endl;
+                        break;
+                    }
+                    if(mail != "*"){
+                        unsigned int k = std::stoul(hops);
+                        std::cout << std::endl << "Usuários alcançados em até " << k << " passos (estimativa): "
+                                  << std::llround(estimated_reach(mail, k, dir == "2")) << std::endl;
+                        break;
+                    }
+                    const analytics::HyperANF &f = neighbourhood_function();
+                    std::cout << std::endl << "Pares de usuários a até t passos (estimativa):" << std::endl;
+                    for(size_t t = 0; t < f.neighbourhood().size(); t++)
+                        std::cout << "t = " << t << ": " << std::llround(f.neighbourhood()[t]) << std::endl;
+                    std::cout << "Diâmetro efetivo (90%): " << f.effective_diameter() << std::endl;
+                    std::cout << "Distância média: " << f.average_distance() << std::endl;
+                    break;
+                }
+
+                case 18:
+                {
+                    show_menu();
+                    auto tasks = list_jobs();
+                    std::cout << std::endl;
+                    if(tasks.empty()){
+                        std::cout << "Nenhuma tarefa em segundo plano!" << std::endl;
+                        break;
+                    }
+                    const char *states[] = {"na fila", "executando", "concluída", "parcial"};
+                    for(const auto &t : tasks){
+                        std::cout << t.id << " - " << t.name << ": " << states[t.status] << " ("
+                                  << (int)(t.progress * 100) << "%, " << t.elapsed << " s)" << std::endl;
+                    }
+                    std::string id;
+                    std::cout << std::endl;
+                    std::cout << "Informe o número da tarefa a cancelar (0 = nenhuma): ";
+                    std::cin >> id;
+                    std::cout << std::endl;
+                    if(!is_number(id) || id.size() > 9){   // Bounded before converting (stoul throws on overflow)
+                        std::cout << "Opção inválida!" << std::endl;
+                        break;
+                    }
+                    if(id == "0") break;
+                    if(cancel_job(std::stoul(id)))
+                        std::cout << "Tarefa cancelada (o resultado parcial fica disponível)!" << std::endl;
+                    else
+                        std::cout << "Tarefa inexistente ou já concluída!" << std::endl;
+                    break;
+                }
+
+                case 19:
+                {
+                    std::string k, samples;
+                    std::cout << std::endl;
+                    std::cout << "Informe a quantidade de usuários: ";
+                    std::cin >> k;
+                    std::cout << std::endl;
+                    std::cout << "Informe o número de fontes amostradas (0 = automático): ";
+                    std::cin >> samples;
+                    std::cout << std::endl;
+                    show_menu();
+                    if(!is_number(k) || k.size() > 9 || k == "0" || !is_number(samples) || samples.size() > 9){
+                        std::cout << std::endl << "Opção inválida!" << std::endl;
+                        break;
+                    }
+                    const jobs::Job<bridges_t> &job = bridges_job(std::stoul(k), std::stoul(samples));
+                    job.wait_for(std::chrono::seconds(1));
+                    const bridges_t *b = job.result();
+                    std::cout << std::endl;
+                    if(!b){
+                        std::cout << "Calculando em segundo plano (" << (int)(job.progress() * 100) << "%, tarefa "
+                                  << job.id() << "): repita a opção para ver o resultado." << std::endl;
+                        break;
+                    }
+                    std::cout << "Usuários-ponte (centralidade de intermediação):" << std::endl;
+                    for(size_t i = 0; i < b->top.size(); i++)
+                        std::cout << i + 1 << ". " << b->top[i].first << " (" << b->top[i].second << ")" << std::endl;
+                    if(b->margin)
+                        std::cout << "Estimativa com " << b->sources << " fontes: erro de até ± " << b->margin
+                                  << " (95%)" << std::endl;
+                    break;
+                }
+
+                case 20:
+                {
+                    std::string method;
+                    std::cout << std::endl;
+                    std::cout << "Método (1 = Louvain // 2 = Propagação de rótulos, mais rápido): ";
+                    std::cin >> method;
+                    std::cout << std::endl;
+                    show_menu();
+                    if(method != "1" && method != "2"){
+                        std::cout << std::endl << "Opção inválida!" << std::endl;
+                        break;
+                    }
+                    communities_t cm = detect_communities(method == "1");
+                    std::cout << std::endl << "Comunidades encontradas: " << cm.count << std::endl;
+                    std::cout << "Modularidade: " << cm.modularity << std::endl;
+                    std::cout << "Maiores comunidades: ";
+                    for(size_t i = 0; i < std::min<size_t>(5, cm.sizes.size()); i++)
+                        std::cout << (i ? ", " : "") << i + 1 << " (" << cm.sizes[i] << " usuários)";
+                    std::cout << std::endl;
+                    std::cout << "A comunidade de cada usuário aparece na opção 5 e nas cores da exportação (opção 8)." << std::endl;
+                    break;
+                }
+
+                case 21:
+                {
+                    std::string mail;
+                    std::cout << std::endl;
+                    std::cout << "Informe o email do usuário (* para o núcleo mais interno): ";
+                    std::cin >> mail;
+                    std::cout << std::endl;
+                    show_menu();
+                    if(mail != "*"){
+                        if(!find(mail)){
+                            std::cout << std::endl << "Usuário inexistente!" << std::endl;
+                            break;
+                        }
+                        std::cout << std::endl << "Núcleo do usuário (k-core): " << core_number(mail) << std::endl;
+                        break;
+                    }
+                    unsigned int k = degeneracy();
+                    auto members = core_members(k);
+                    std::cout << std::endl << "Núcleo mais interno: " << k << "-core com " << members.size()
+                              << " usuários" << std::endl;
+                    for(size_t i = 0; i < std::min<size_t>(10, members.size()); i++)
+                        std::cout << members[i] << std::endl;
+                    if(members.size() > 10) std::cout << "..." << std::endl;
+                    break;
+                }
+
+                case 22:
+                {
+                    std::string mail, mail2, weight;
+                    std::cout << std::endl;
+                    std::cout << "Informe o email do seguidor: ";
+                    std::cin >> mail;
+                    std::cout << std::endl;
+                    std::cout << "Informe o email do usuário seguido: ";
+                    std::cin >> mail2;
+                    std::cout << std::endl;
+                    std::cout << "Peso da ligação (custo no menor caminho, 1 = padrão): ";
+                    std::cin >> weight;
+                    std::cout << std::endl;
+                    show_menu();
+                    float w = -1;
+                    try{ w = std::stof(weight); } catch(const std::exception&){}
+                    switch(link_weight(mail, mail2, w)){
+                        case NOT_FOUND:
+                            std::cout << std::endl << "Um/Ambos usuário(s) não existe(m) na rede!" << std::endl;
+                            break;
+                        case NOT_FOLLOWING:
+                            std::cout << std::endl << "O usuário: " << mail << " não segue: " << mail2 << "!" << std::endl;
+                            break;
+                        case INVALID_WEIGHT:
+                            std::cout << std::endl << "Peso inválido (deve ser um número finito maior ou igual a 0)!" << std::endl;
+                            break;
+                        default:
+                        {
+                            const link_t *l = link(mail, mail2);
+                            db->save_link(mail, mail2, l->time, l->weight);
+                            std::cout << std::endl << "Peso da ligação atualizado!" << std::endl;
+                        }
+                    }
+                    break;
+                }
+
+                case 23:
+                {
+                    std::string mail, hours;
+                    std::cout << std::endl;
+                    std::cout << "Informe o email do usuário (* para toda a rede): ";
+                    std::cin >> mail;
+                    std::cout << std::endl;
+                    std::cout << "Últimas quantas horas? ";
+                    std::cin >> hours;
+                    std::cout << std::endl;
+                    show_menu();
+                    if(!is_number(hours) || hours.size() > 6){
+                        std::cout << std::endl << "Número de horas inválido!" << std::endl;
+                        break;
+                    }
+                    long long now = std::time(nullptr), start = now - 3600LL * std::stoll(hours);
+                    unsigned int from = std::max(0LL, start);
+                    if(mail == "*"){
+                        network::CSR before = from ? snapshot(from - 1) : network::CSR();   // The network when the period started
+                        unsigned int linked = 0;
+                        for(unsigned int v = 0; v < before.size(); v++) linked += before.outdegree(v) || before.indegree(v);
+                        std::cout << std::endl << "Ligações criadas nas últimas " << hours << " horas: "
+                                  << links_between(from) << std::endl;
+                        std::cout << "Rede no início do período: " << before.edges() << " ligações entre " << linked
+                                  << " usuários (grau médio de saída: "
+                                  << (before.size() ? (double)before.edges() / before.size() : 0) << ")" << std::endl;
+                        break;
+                    }
+                    if(!find(mail)){
+                        std::cout << std::endl << "Usuário inexistente!" << std::endl;
+                        break;
+                    }
+                    auto gained = followers_between(mail, from);
+                    std::cout << std::endl << "Novos seguidores de " << mail << " nas últimas " << hours
+                              << " horas: " << gained.size() << std::endl;
+                    for(auto it = gained.rbegin(); it != gained.rend(); ++it){
+                        char date[32];
+                        std::time_t t = it->second;
+                        std::strftime(date, sizeof(date), "%d/%m/%Y %H:%M", std::localtime(&t));
+                        std::cout << it->first << " (" << date << ")" << std::endl;
+                    }
+                    break;
+                }
+
+                case 24:
+                {
+                    std::string path;
+                    std::cout << std::endl;
+                    std::cout << "Informe o arquivo com as operações: ";
+                    std::cin >> path;
+                    std::cout << std::endl;
+                    show_menu();
+                    if(!run_batch(path, *db))
+                        std::cout << std::endl << "Erro ao abrir o arquivo: " << path << std::endl;
+                    break;
+                }
 
                 default:
                     show_menu();
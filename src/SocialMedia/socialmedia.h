@@ -12,20 +12,102 @@
 #define SOCIALMEDIA_H
 
 #include "../Network/network.h"
+#include "../Timeline/timeline.h"
+#include "../Analytics/hyperanf.h"
+#include "../Analytics/betweenness.h"
+#include "../Analytics/communities.h"
+#include "../Storage/storage.h"
+#include "../Trace/trace.h"
+#include <initializer_list>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace socialmedia{
 
 class SocialMedia : public network::Network{
 public:
+    struct bridges_t{
+        std::vector<std::pair<std::string, double>> top;   // (email, betweenness) descending
+        double margin = 0;                                 // Error bound of the scores (0: exact)
+        unsigned long sources = 0;                         // Sources used (all users: exact)
+    };
+
+    struct communities_t{
+        unsigned int count = 0;
+        double modularity = 0;
+        std::vector<unsigned int> sizes;   // Users per community (id - 1), descending
+    };
+
     SocialMedia();
     virtual ~SocialMedia();
-    void init(socialmedia::SocialMedia &sm);
+    void init(socialmedia::SocialMedia &sm, const std::string &backend = "sqlite");
+    std::vector<std::pair<std::string, double>> top_influencers(size_t k);
+    std::vector<std::pair<std::string, double>> top_influencers(const std::string &seed, size_t k);
+    const timeline::Timeline::post* publish(const std::string &author, const std::string &text,
+                                            long long time, unsigned long id = 0);
+    std::vector<const timeline::Timeline::post*> home_timeline(const std::string &user, size_t limit);
+    error_t remove_node(const std::string &s);
+    std::vector<status_t> follow_many(const std::vector<std::pair<std::string, std::string>> &pairs,
+                                      storage::Storage &db);
+    std::vector<status_t> unfollow_many(const std::vector<std::pair<std::string, std::string>> &pairs,
+                                        storage::Storage &db);
+    std::vector<status_t> remove_many(const std::vector<std::string> &users, storage::Storage &db);
+    const analytics::HyperANF& neighbourhood_function(bool followers = false);
+    double estimated_reach(const std::string &s, unsigned int k, bool followers = false);
+    const jobs::Job<int>& diameter_job(double budget = 0);
+    bridges_t top_bridges(size_t k, unsigned long samples = 0);
+    const jobs::Job<bridges_t>& bridges_job(size_t k = 3, unsigned long samples = 0, double budget = 0);
+    communities_t detect_communities(bool louvain = true);
+    std::vector<jobs::Scheduler::info_t> list_jobs() const { return scheduler.list(); } // Inline
+    bool cancel_job(unsigned long id) { return scheduler.cancel(id); } // Inline
+    network::MemoryReport memory_report() const;
+    const timeline::Timeline& get_timelines() const { return timelines; } // Inline
+    bool record_trace(const std::string &path);
+    bool execute(const trace::record_t &r, storage::Storage &db);
+    bool run_batch(const std::string &path, storage::Storage &db);
 
 private:
+    std::unordered_map<std::string, double> ranks;   // Last PageRank scores (warm start)
+    unsigned long ranks_version = -1;                 // Graph version of the scores
+    timeline::Timeline timelines;
+    struct clustering_t{
+        bool exact = true;              // false: wedge sampling estimate
+        unsigned long triangles = 0;    // Exact count
+        double estimate = 0;            // Estimated count (± margin * wedges / 3)
+        unsigned long wedges = 0;
+        double global = 0;              // Transitivity
+        double margin = 0;              // Half width of the transitivity interval
+        double average = 0;             // Mean local coefficient (exact only)
+        unsigned long samples = 0;
+    };
+
+    clustering_t clustering;                          // Last triangle statistics
+    unsigned long clustering_version = -1;            // Graph version of clustering
+    std::unique_ptr<analytics::HyperANF> anf;         // Last neighbourhood function
+    unsigned long anf_version = -1;                   // Graph version of anf
+    bool anf_followers = false;                       // Direction of anf
+    jobs::Scheduler scheduler;                        // Background analytics (one worker)
+    jobs::Job<int> diameter;                          // Last diameter job
+    unsigned long diameter_version = -1;              // Graph version of the diameter job
+    jobs::Job<bridges_t> bridges;                     // Last betweenness job
+    unsigned long bridges_version = -1;               // Graph version of the betweenness job
+    std::pair<size_t, unsigned long> bridges_query;   // (k, samples) of the betweenness job
+    std::unique_ptr<trace::Recorder> recorder;        // Trace of the menu operations (nullptr: off)
+
     bool is_number(const std::string& s);
     void show_menu();
     int get_instruction();
+    void list_clustering(const std::string &s);
+    void update_pagerank();
+    const clustering_t& clustering_stats();
+    void record(trace::op_t op, std::initializer_list<std::string> args) { if(recorder) recorder->record(op, args); } // Inline
+    void record(trace::op_t op, const std::vector<std::string> &args) { if(recorder) recorder->record(op, args); } // Inline
+    std::vector<status_t> batch(const trace::record_t &r, storage::Storage &db, std::vector<path_t> *paths = nullptr);
+    static bridges_t rank_bridges(const network::CSR &g, size_t k, unsigned long samples,
+                                  jobs::Control *control);
     friend std::ostream& operator<<(std::ostream &os, SocialMedia &sm);
 };
 
@@ -0,0 +1,531 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file logstorage.cpp (.cpp file) (implementation file)
+ *
+ * LogStorage class members/member functions implementation
+ * Integers are stored little-endian; strings as a 32 bit length followed by the bytes.
+ * Link records end with the creation time and the weight (double bits); older logs
+ * without them are read with time 0 and weight 1.
+ *
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
+#include "logstorage.h"
+#include "../SocialMedia/socialmedia.h"
+
+namespace storage{
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @brief Class constructor. Open (or create) the log and replay it into the network.
+     * @param sm --> SocialMedia object that receives the logged mutations
+     * @param path --> const std::string: Log file path
+    */
+    storage::LogStorage::LogStorage(socialmedia::SocialMedia &sm, const std::string &path)
+        : sm(sm), path(path)
+    {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        if(fd < 0){
+            std::cout << "Erro ao abrir o log: " << path << std::endl;
+            return;
+        }
+        buffer.reserve(FLUSH_BYTES + 4096);
+        replay();
+        last_sync = std::chrono::steady_clock::now();
+        flusher = std::thread([this]{ run_flusher(); });
+    }
+
+    /// @brief Class destructor. Stop the flusher, wait for a running compaction and sync the pending records.
+    storage::LogStorage::~LogStorage(){
+        if(flusher.joinable()){
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            flusher.join();
+        }
+        std::lock_guard<std::mutex> guard(mutex);
+        if(compacting) finish_compaction();
+        flush_sync();
+        if(fd >= 0) ::close(fd);
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name run_flusher()
+     * @brief Flusher thread: sleep while nothing is pending, otherwise wake up when
+     *        SYNC_INTERVAL_MS has passed since the last sync and write + fdatasync the
+     *        buffer, so an acknowledged record is durable within the interval even if
+     *        no other record follows it
+    */
+    void storage::LogStorage::run_flusher(){
+        std::unique_lock<std::mutex> guard(mutex);
+        while(!stopping){
+            bool pending = !batching && (!buffer.empty() || dirty);
+            auto deadline = last_sync + std::chrono::milliseconds(SYNC_INTERVAL_MS);
+            if(pending && std::chrono::steady_clock::now() >= deadline) flush_sync();
+            else if(pending) wake.wait_until(guard, deadline);
+            else wake.wait(guard);
+        }
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name crc32()
+     * @brief CRC-32 (IEEE, table driven) of a byte range
+     * @param data --> const char*: First byte
+     * @param n --> size_t: Number of bytes
+     * @return uint32_t --> Checksum
+    */
+    uint32_t storage::LogStorage::crc32(const char *data, size_t n){
+        static const auto table = []{
+            struct { uint32_t v[256]; } t;
+            for(uint32_t i = 0; i < 256; i++){
+                uint32_t c = i;
+                for(int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t.v[i] = c;
+            }
+            return t;
+        }();
+        uint32_t crc = 0xFFFFFFFFu;
+        for(size_t i = 0; i < n; i++)
+            crc = table.v[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name open_record()
+     * @brief Start a record: reserve the header (crc + length) and write the type
+     * @param out --> std::string: Destination buffer
+     * @param type --> record_t: Record type
+     * @return size_t --> Record start offset (passed to seal)
+    */
+    size_t storage::LogStorage::open_record(std::string &out, record_t type){
+        size_t start = out.size();
+        out.append(8, '\0');
+        out.push_back(static_cast<char>(type));
+        return start;
+    }
+
+    /// @brief Append a string field (32 bit length + bytes).
+    void storage::LogStorage::put(std::string &out, const std::string &field){
+        uint32_t len = field.size();
+        for(int i = 0; i < 4; i++) out.push_back(static_cast<char>(len >> (8 * i)));
+        out.append(field);
+    }
+
+    /// @brief Append a 64 bit integer field.
+    void storage::LogStorage::put(std::string &out, uint64_t value){
+        for(int i = 0; i < 8; i++) out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name seal()
+     * @brief Fill the header of a record: length of type + fields and their checksum
+     * @param out --> std::string: Buffer holding the record
+     * @param start --> size_t: Record start offset
+    */
+    void storage::LogStorage::seal(std::string &out, size_t start){
+        uint32_t len = out.size() - start - 8;
+        uint32_t crc = crc32(out.data() + start + 8, len);
+        for(int i = 0; i < 4; i++){
+            out[start + i] = static_cast<char>(crc >> (8 * i));
+            out[start + 4 + i] = static_cast<char>(len >> (8 * i));
+        }
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name append_record()
+     * @brief Seal the last record of the buffer, write the buffer when it is full and
+     *        sync when SYNC_INTERVAL_MS has passed since the last sync (otherwise the
+     *        flusher thread syncs it when the interval ends). Inside a batch the sync is
+     *        left to commit().
+     * @attention Called with the mutex held
+     * @param start --> size_t: Record start offset
+     * @return bool --> true: Record accepted, false: Write error
+    */
+    bool storage::LogStorage::append_record(size_t start){
+        if(start == 0 && !dirty && !batching) wake.notify_one();   // First pending record: start the flusher timer
+        seal(buffer, start);
+        total++;
+        if(compacting){
+            tail.append(buffer, start, std::string::npos);
+            tail_records++;
+        }
+        bool ok = true;
+        if(buffer.size() >= FLUSH_BYTES) ok = flush();
+        auto now = std::chrono::steady_clock::now();
+        if(!batching && now - last_sync >= std::chrono::milliseconds(SYNC_INTERVAL_MS)) ok = flush_sync() && ok;
+        maybe_compact();
+        return ok;
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name flush()
+     * @brief Write the buffered records to the log file (without syncing)
+     * @return bool --> true: Buffer written, false: Write error
+    */
+    bool storage::LogStorage::flush(){
+        if(fd < 0) return false;
+        size_t done = 0;
+        while(done < buffer.size()){
+            ssize_t w = ::write(fd, buffer.data() + done, buffer.size() - done);
+            if(w < 0){
+                if(errno == EINTR) continue;
+                std::cout << "Erro ao escrever no log: " << path << std::endl;
+                buffer.erase(0, done);
+                return false;
+            }
+            done += w;
+        }
+        if(done) dirty = true;
+        buffer.clear();
+        return true;
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name sync()
+     * @brief Write the buffered records and fdatasync the log now
+     * @return bool --> true: Records are durable, false: Write/sync error
+    */
+    bool storage::LogStorage::sync(){
+        std::lock_guard<std::mutex> guard(mutex);
+        return flush_sync();
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name begin()
+     * @brief Start a batch: the following records are only written when the buffer fills
+     *        and are synced together by commit() (one fdatasync instead of one per interval).
+     *        A batch isn't atomic: after a crash the log keeps the records already written.
+     * @return bool --> true: Batch started
+    */
+    bool storage::LogStorage::begin(){
+        std::lock_guard<std::mutex> guard(mutex);
+        batching = true;
+        return true;
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name commit()
+     * @brief End the batch started by begin(): write and fdatasync its records
+     * @return bool --> true: Records are durable, false: Write/sync error
+    */
+    bool storage::LogStorage::commit(){
+        std::lock_guard<std::mutex> guard(mutex);
+        batching = false;
+        return flush_sync();
+    }
+
+    /// @brief sync() with the mutex already held
+    bool storage::LogStorage::flush_sync(){
+        bool ok = flush();
+        if(ok && dirty){
+            ok = fdatasync(fd) == 0;
+            dirty = !ok;
+        }
+        last_sync = std::chrono::steady_clock::now();
+        return ok;
+    }
+
+    bool storage::LogStorage::save_user(const std::string &mail, const std::string &nme,
+                                        const std::string &brth, const std::string &phne,
+                                        const std::string &cty)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        size_t start = open_record(buffer, USER);
+        put(buffer, mail);
+        put(buffer, nme);
+        put(buffer, brth);
+        put(buffer, phne);
+        put(buffer, cty);
+        return append_record(start);
+    }
+
+    bool storage::LogStorage::drop_user(const std::string &s){
+        std::lock_guard<std::mutex> guard(mutex);
+        size_t start = open_record(buffer, DROP);
+        put(buffer, s);
+        return append_record(start);
+    }
+
+    bool storage::LogStorage::save_link(const std::string &src, const std::string &dest, long long time, double weight){
+        std::lock_guard<std::mutex> guard(mutex);
+        size_t start = open_record(buffer, LINK);
+        put(buffer, src);
+        put(buffer, dest);
+        put(buffer, static_cast<uint64_t>(time));
+        put(buffer, bits(weight));
+        return append_record(start);
+    }
+
+    bool storage::LogStorage::drop_link(const std::string &src, const std::string &dest){
+        std::lock_guard<std::mutex> guard(mutex);
+        size_t start = open_record(buffer, UNLINK);
+        put(buffer, src);
+        put(buffer, dest);
+        return append_record(start);
+    }
+
+    bool storage::LogStorage::save_post(unsigned long id, const std::string &author, long long time,
+                                        const std::string &text)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        size_t start = open_record(buffer, POST);
+        put(buffer, static_cast<uint64_t>(id));
+        put(buffer, static_cast<uint64_t>(time));
+        put(buffer, author);
+        put(buffer, text);
+        return append_record(start);
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name replay()
+     * @brief Apply every record of the log to the network. Reading stops at the first
+     *        torn (incomplete) or corrupted record, and the file is truncated there so
+     *        new records are appended after the last valid one.
+    */
+    void storage::LogStorage::replay(){
+        std::string data;
+        char chunk[1 << 16];
+        ssize_t r;
+        while((r = ::read(fd, chunk, sizeof(chunk))) != 0){
+            if(r < 0){
+                if(errno == EINTR) continue;
+                std::cout << "Erro ao ler o log: " << path << std::endl;
+                return;
+            }
+            data.append(chunk, r);
+        }
+
+        auto u32 = [&data](size_t at){
+            uint32_t v = 0;
+            for(int i = 0; i < 4; i++) v |= uint32_t(static_cast<unsigned char>(data[at + i])) << (8 * i);
+            return v;
+        };
+        size_t pos = 0;
+        while(pos + 9 <= data.size()){
+            uint32_t crc = u32(pos), len = u32(pos + 4);
+            if(!len || len > data.size() - pos - 8 || crc32(data.data() + pos + 8, len) != crc) break;
+            size_t at = pos + 9, stop = pos + 8 + len;
+            bool ok = true;
+            auto field = [&](std::string &s){
+                if(stop - at < 4 || u32(at) > stop - at - 4){ ok = false; return; }
+                s.assign(data, at + 4, u32(at));
+                at += 4 + s.size();
+            };
+            auto view = [&](std::string_view &s){   // Links are replayed without copying the emails
+                if(stop - at < 4 || u32(at) > stop - at - 4){ ok = false; return; }
+                s = std::string_view(data.data() + at + 4, u32(at));
+                at += 4 + s.size();
+            };
+            auto number = [&](uint64_t &v){
+                if(stop - at < 8){ ok = false; return; }
+                v = uint64_t(u32(at)) | uint64_t(u32(at + 4)) << 32;
+                at += 8;
+            };
+            std::string a, b, c, d, e;
+            std::string_view src, dest;
+            uint64_t id = 0, time = 0, weight = bits(1.0);
+            switch(static_cast<unsigned char>(data[pos + 8])){
+                case USER:
+                    field(a); field(b); field(c); field(d); field(e);
+                    if(ok) sm.insert_node(a, b, c, d, e);
+                    break;
+                case LINK:
+                    view(src); view(dest);
+                    if(ok && at < stop){ number(time); number(weight); }
+                    if(ok){
+                        double w;
+                        std::memcpy(&w, &weight, sizeof(w));
+                        if(sm.add_link(src, dest, {static_cast<unsigned int>(time), static_cast<float>(w)})
+                           == socialmedia::SocialMedia::ALREADY_FOLLOWS)
+                            sm.link_weight(src, dest, w);   // Weight update of an existing link
+                    }
+                    break;
+                case UNLINK:
+                    view(src); view(dest);
+                    if(ok) sm.remove_link(src, dest);
+                    break;
+                case DROP:
+                    field(a);
+                    if(ok) sm.remove_node(a);
+                    break;
+                case POST:
+                    number(id); number(time); field(a); field(b);
+                    if(ok) sm.publish(a, b, static_cast<long long>(time), id);
+                    break;
+                default:
+                    ok = false;
+            }
+            if(!ok) break;
+            pos = stop;
+            total++;
+        }
+        if(pos < data.size()){
+            std::cout << "Log: " << data.size() - pos << " bytes inválidos descartados (registro incompleto ou corrompido)." << std::endl;
+            if(ftruncate(fd, pos) != 0 || fdatasync(fd) != 0)
+                std::cout << "Erro ao truncar o log: " << path << std::endl;
+        }
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name encode_snapshot()
+     * @brief Encode the current state as a minimal log: users, links, then posts
+     * @param sm --> SocialMedia object
+     * @param out --> std::string: Destination buffer
+     * @param count --> unsigned long: Number of records written
+    */
+    void storage::LogStorage::encode_snapshot(socialmedia::SocialMedia &sm, std::string &out, unsigned long &count){
+        count = 0;
+        sm.visit(
+            [&](const std::string &mail, const std::string &nme, const std::string &brth,
+                const std::string &phne, const std::string &cty)
+            {
+                size_t start = open_record(out, USER);
+                put(out, mail); put(out, nme); put(out, brth); put(out, phne); put(out, cty);
+                seal(out, start);
+                count++;
+            },
+            [&](const std::string &src, const std::string &dest, const auto &attr){
+                size_t start = open_record(out, LINK);
+                put(out, src); put(out, dest);
+                put(out, static_cast<uint64_t>(attr.time)); put(out, bits(attr.weight));
+                seal(out, start);
+                count++;
+            });
+        for(auto p : sm.get_timelines().all()){
+            size_t start = open_record(out, POST);
+            put(out, static_cast<uint64_t>(p->id));
+            put(out, static_cast<uint64_t>(p->time));
+            put(out, p->author);
+            put(out, p->text);
+            seal(out, start);
+            count++;
+        }
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name maybe_compact()
+     * @brief Start a background compaction when the log holds more than twice the live
+     *        records (users, links and posts, counted by the network and the timelines).
+     *        The snapshot is encoded here, on the caller's thread (the network isn't
+     *        thread safe), so the append that triggers it waits for the encoding; the
+     *        thread only writes and syncs it, while new records go to the old log and to
+     *        the tail that is appended to the snapshot when it is done.
+    */
+    void storage::LogStorage::maybe_compact(){
+        if(compacted) finish_compaction();
+        if(compacting || total < next_check || fd < 0) return;
+        unsigned long live = sm.size() + sm.links() + sm.get_timelines().size();   // Records of a snapshot
+        if(2 * live >= total){
+            next_check = std::max(COMPACT_MIN_RECORDS, 2 * live + 1);
+            return;
+        }
+        std::string snapshot;
+        encode_snapshot(sm, snapshot, snapshot_records);
+        if(!flush()) return;
+        compacting = true;
+        tail.clear();
+        tail_records = 0;
+        std::string target = path + ".compact";
+        compactor = std::thread([this, target, snapshot = std::move(snapshot)]{
+            bool ok = false;
+            int out = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if(out >= 0){
+                size_t done = 0;
+                while(done < snapshot.size()){
+                    ssize_t w = ::write(out, snapshot.data() + done, snapshot.size() - done);
+                    if(w < 0 && errno == EINTR) continue;
+                    if(w < 0) break;
+                    done += w;
+                }
+                ok = done == snapshot.size() && fdatasync(out) == 0;
+                ::close(out);
+            }
+            compact_ok = ok;
+            compacted = true;
+        });
+    }
+
+    /**
+     * @namespace storage
+     * @class LogStorage
+     * @name finish_compaction()
+     * @brief Join the compactor, append the tail to the snapshot and replace the log
+     *        with it (rename is atomic: a crash leaves either the old or the new log;
+     *        the directory is synced so the new name survives a crash).
+     * @attention Called with the mutex held
+    */
+    void storage::LogStorage::finish_compaction(){
+        compactor.join();
+        compacting = false;
+        compacted = false;
+        std::string target = path + ".compact";
+        bool ok = compact_ok && flush();
+        int out = ok ? ::open(target.c_str(), O_WRONLY | O_APPEND) : -1;
+        if(out >= 0){
+            size_t done = 0;
+            while(done < tail.size()){
+                ssize_t w = ::write(out, tail.data() + done, tail.size() - done);
+                if(w < 0 && errno == EINTR) continue;
+                if(w < 0) break;
+                done += w;
+            }
+            ok = done == tail.size() && fdatasync(out) == 0;
+            ::close(out);
+        }
+        else ok = false;
+        if(ok && std::rename(target.c_str(), path.c_str()) == 0){
+            size_t slash = path.find_last_of('/');
+            std::string dir = slash == std::string::npos ? "." : path.substr(0, slash ? slash : 1);
+            int d = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);   // Make the rename itself durable
+            if(d < 0 || ::fsync(d) != 0) std::cout << "Erro ao sincronizar o diretório do log: " << dir << std::endl;
+            if(d >= 0) ::close(d);
+            ::close(fd);
+            fd = ::open(path.c_str(), O_RDWR | O_APPEND);
+            dirty = false;
+            total = snapshot_records + tail_records;
+            next_check = std::max(COMPACT_MIN_RECORDS, 2 * total);
+        }
+        else{
+            std::remove(target.c_str());
+            next_check = total + COMPACT_MIN_RECORDS;
+        }
+        tail.clear();
+        tail.shrink_to_fit();
+        tail_records = 0;
+    }
+
+} // namespace storage
@@ -0,0 +1,98 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile logstorage.h (header file)
+ *
+ * LogStorage class interface/structure
+ * Append-only binary log of mutations. Every record is framed as
+ * [crc32][length][type][fields], appended to a buffer and written in batches.
+ * A flusher thread writes and fdatasyncs pending records at most SYNC_INTERVAL_MS
+ * after the last sync, even when no new record arrives; the records written between
+ * begin() and commit() are synced once, at commit(). On startup the log is replayed
+ * and cut at the first torn or corrupted record. When most records are dead
+ * (unfollows, removed users) the log is rewritten from a snapshot: the snapshot is
+ * encoded by the append that detects it, then written and synced by a background thread.
+ * Include guard
+ *
+*/
+
+#ifndef LOGSTORAGE_H
+#define LOGSTORAGE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "storage.h"
+
+namespace storage{
+
+class LogStorage : public Storage{
+public:
+    static constexpr size_t FLUSH_BYTES = 1 << 16;           // Buffered bytes before a write
+    static constexpr long SYNC_INTERVAL_MS = 50;             // Maximum time a record waits for fdatasync
+    static constexpr unsigned long COMPACT_MIN_RECORDS = 1 << 16;
+
+    LogStorage(socialmedia::SocialMedia &sm, const std::string &path = "src/Database/graphsocial.log");
+    ~LogStorage() override;
+    bool save_user(const std::string &mail, const std::string &nme,
+                   const std::string &brth, const std::string &phne,
+                   const std::string &cty) override;
+    bool drop_user(const std::string &s) override;
+    bool save_link(const std::string &src, const std::string &dest, long long time, double weight) override;
+    bool drop_link(const std::string &src, const std::string &dest) override;
+    bool save_post(unsigned long id, const std::string &author, long long time,
+                   const std::string &text) override;
+    bool begin() override;
+    bool commit() override;
+    bool sync();
+    unsigned long records() const { return total; } // Inline
+    LogStorage(const LogStorage&) = delete;
+    LogStorage& operator=(const LogStorage&) = delete;
+
+private:
+    enum record_t : unsigned char { USER = 1, LINK, UNLINK, DROP, POST };
+
+    socialmedia::SocialMedia &sm;
+    std::string path;
+    int fd = -1;
+    std::string buffer;                  // Records not yet written
+    std::chrono::steady_clock::time_point last_sync;
+    bool dirty = false;                  // Written but not synced
+    unsigned long total = 0;             // Records in the log file
+    unsigned long next_check = COMPACT_MIN_RECORDS;
+    std::thread compactor;
+    std::atomic<bool> compacted{false};  // Set by the compactor thread when done
+    bool compacting = false;
+    bool compact_ok = false;
+    unsigned long snapshot_records = 0;
+    std::string tail;                    // Records appended while compacting
+    unsigned long tail_records = 0;
+    std::mutex mutex;                    // Guards the buffer and the file (shared with the flusher)
+    std::condition_variable wake;        // Signals the flusher when records become pending
+    std::thread flusher;
+    bool stopping = false;
+    bool batching = false;               // Between begin() and commit(): no interval sync
+
+    static uint32_t crc32(const char *data, size_t n);
+    static size_t open_record(std::string &out, record_t type);
+    static void put(std::string &out, const std::string &field);
+    static void put(std::string &out, uint64_t value);
+    static uint64_t bits(double value) { uint64_t b; std::memcpy(&b, &value, sizeof(b)); return b; } // Inline
+    static void seal(std::string &out, size_t start);
+    bool append_record(size_t start);
+    bool flush();
+    bool flush_sync();
+    void run_flusher();
+    void replay();
+    void maybe_compact();
+    void finish_compaction();
+    static void encode_snapshot(socialmedia::SocialMedia &sm, std::string &out, unsigned long &count);
+};
+
+} // namespace storage
+
+#endif // LOGSTORAGE_H
@@ -0,0 +1,32 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file storage.cpp (.cpp file) (implementation file)
+ *
+ * Storage backends selection
+ *
+*/
+
+#include <memory>
+#include "storage.h"
+#include "logstorage.cpp"
+#include "../Database/database.h"
+
+namespace storage{
+
+    /**
+     * @namespace storage
+     * @name open()
+     * @brief Create a storage backend and load its data into the network
+     * @param backend --> const std::string: "sqlite" (default database), "log" (append-only log)
+     *                    or "memory" (nothing is persisted)
+     * @param sm --> SocialMedia object
+     * @return std::unique_ptr<Storage> --> Backend, nullptr if the name is unknown
+    */
+    std::unique_ptr<storage::Storage> open(const std::string &backend, socialmedia::SocialMedia &sm){
+        if(backend == "sqlite") return std::make_unique<database::Database>(sm);
+        if(backend == "log") return std::make_unique<storage::LogStorage>(sm);
+        if(backend == "memory") return std::make_unique<storage::MemoryStorage>();
+        return nullptr;
+    }
+
+} // namespace storage
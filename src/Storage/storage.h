@@ -0,0 +1,58 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile storage.h (header file)
+ * 
+ * Storage interface (persistence of users, links and posts) and the in-memory backend.
+ * Implementations: database::Database (SQLite), storage::LogStorage (append-only log)
+ * and storage::MemoryStorage (no persistence, for benchmarks).
+ * Include guard
+ * 
+*/
+
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <memory>
+#include <string>
+
+namespace socialmedia{ class SocialMedia; }
+
+namespace storage{
+
+class Storage{
+public:
+    virtual ~Storage(){}
+    virtual bool save_user(const std::string &mail, const std::string &nme,
+                           const std::string &brth, const std::string &phne,
+                           const std::string &cty) = 0;
+    virtual bool drop_user(const std::string &s) = 0;
+    virtual bool save_link(const std::string &src, const std::string &dest, long long time,
+                           double weight) = 0;   // New link, or new weight of an existing one
+    virtual bool drop_link(const std::string &src, const std::string &dest) = 0;
+    virtual bool save_post(unsigned long id, const std::string &author, long long time,
+                           const std::string &text) = 0;
+    virtual bool save_distance_index(const std::string &, unsigned long) { return false; } // Optional
+    virtual bool load_distance_index(std::string &, unsigned long &) { return false; }     // Optional
+    virtual bool begin() { return true; }    // Optional: the writes until commit() are applied together
+    virtual bool commit() { return true; }   // Optional
+};
+
+class MemoryStorage : public Storage{
+public:
+    bool save_user(const std::string &, const std::string &, const std::string &,
+                   const std::string &, const std::string &) override { ops++; return true; } // Inline
+    bool drop_user(const std::string &) override { ops++; return true; } // Inline
+    bool save_link(const std::string &, const std::string &, long long, double) override { ops++; return true; } // Inline
+    bool drop_link(const std::string &, const std::string &) override { ops++; return true; } // Inline
+    bool save_post(unsigned long, const std::string &, long long, const std::string &) override { ops++; return true; } // Inline
+    unsigned long operations() const { return ops; } // Inline
+
+private:
+    unsigned long ops = 0;
+};
+
+std::unique_ptr<Storage> open(const std::string &backend, socialmedia::SocialMedia &sm);
+
+} // namespace storage
+
+#endif // STORAGE_H
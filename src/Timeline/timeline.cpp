@@ -0,0 +1,231 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file timeline.cpp (.cpp file) (implementation file)
+ * 
+ * Timeline class members/member functions implementation
+ * 
+*/
+
+#include <algorithm>
+#include <queue>
+#include <tuple>
+#include "timeline.h"
+
+namespace timeline{
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name add_post()
+     * @brief Store a new post (the caller delivers it to the followers)
+     * @param author --> const std::string: Author email
+     * @param time --> long long: Publication time
+     * @param text --> const std::string: Post content
+     * @param pushed --> bool: true: The caller delivers it to the followers, false: Pulled on read
+     * @param id --> unsigned long: Post id (0: next id, used when loading from the database)
+     * @return const post& --> Stored post
+    */
+    const timeline::Timeline::post& timeline::Timeline::add_post(const std::string &author, long long time,
+                                                                 const std::string &text, bool pushed,
+                                                                 unsigned long id)
+    {
+        if(!id) id = last_id + 1;
+        last_id = std::max(last_id, id);
+        post &p = posts[id];
+        p = {id, author, time, text, pushed};
+        auto &list = authored[author];
+        list.insert(std::upper_bound(list.begin(), list.end(), id), id);
+        if(!pushed){
+            auto &read = pulled[author];
+            read.insert(std::upper_bound(read.begin(), read.end(), id), id);
+        }
+        return p;
+    }
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name deliver()
+     * @brief Push a post id to a user home timeline (oldest entries are overwritten)
+    */
+    void timeline::Timeline::deliver(const std::string &user, unsigned long id){
+        inboxes[user].push(id);
+    }
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name get()
+     * @brief Get a post by id
+     * @return const post* --> Post, nullptr if it doesn't exist (anymore)
+    */
+    const timeline::Timeline::post* timeline::Timeline::get(unsigned long id) const{
+        auto it = posts.find(id);
+        return it == posts.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name remove_user()
+     * @brief Drop the posts and the home timeline of a removed user.
+     *        Entries in other timelines are skipped on read.
+    */
+    void timeline::Timeline::remove_user(const std::string &user){
+        auto it = authored.find(user);
+        if(it != authored.end()){
+            for(unsigned long id : it->second) posts.erase(id);
+            authored.erase(it);
+        }
+        pulled.erase(user);
+        inboxes.erase(user);
+    }
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name bytes()
+     * @brief Memory used by the posts and the home timelines
+     * @return size_t --> Bytes
+    */
+    size_t timeline::Timeline::bytes() const{
+        auto heap = [](const std::string &s){ return s.capacity() > 15 ? s.capacity() + 1 : 0; };
+        const size_t node = 2 * sizeof(void*);
+        size_t ans = (posts.bucket_count() + authored.bucket_count() + pulled.bucket_count()
+                      + inboxes.bucket_count()) * sizeof(void*);
+        for(const auto &p : posts)
+            ans += sizeof(p) + node + heap(p.second.author) + heap(p.second.text);
+        for(const auto *m : {&authored, &pulled})
+            for(const auto &a : *m)
+                ans += sizeof(a) + node + heap(a.first) + a.second.capacity() * sizeof(unsigned long);
+        for(const auto &i : inboxes)
+            ans += sizeof(i) + node + heap(i.first) + i.second.buf.capacity() * sizeof(unsigned long);
+        return ans;
+    }
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name all()
+     * @brief Every stored post, used to snapshot the posts
+     * @return std::vector<const post*> --> Posts in publication (id) order
+    */
+    std::vector<const timeline::Timeline::post*> timeline::Timeline::all() const{
+        std::vector<const post*> out;
+        out.reserve(posts.size());
+        for(const auto &p : posts) out.push_back(&p.second);
+        std::sort(out.begin(), out.end(), [](const post *a, const post *b){ return a->id < b->id; });
+        return out;
+    }
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name posts_of()
+     * @brief Most recent posts of a user
+     * @param author --> const std::string: Author email
+     * @param limit --> size_t: Maximum number of posts
+     * @return std::vector<const post*> --> Posts, newest first
+    */
+    std::vector<const timeline::Timeline::post*> timeline::Timeline::posts_of(const std::string &author,
+                                                                              size_t limit) const
+    {
+        std::vector<const post*> ans;
+        auto it = authored.find(author);
+        if(it == authored.end()) return ans;
+        for(auto id = it->second.rbegin(); id != it->second.rend() && ans.size() < limit; ++id)
+            ans.push_back(get(*id));
+        return ans;
+    }
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name own_posts()
+     * @brief Ids of every post of an author
+     * @param author --> const std::string: Author email
+     * @return const std::vector<unsigned long>* --> Ids in increasing order, nullptr if there are none
+    */
+    const std::vector<unsigned long>* timeline::Timeline::own_posts(const std::string &author) const{
+        auto it = authored.find(author);
+        return it == authored.end() || it->second.empty() ? nullptr : &it->second;
+    }
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name pulled_posts()
+     * @brief Ids of the posts of an author that were not pushed (read by merge())
+     * @param author --> const std::string: Author email
+     * @return const std::vector<unsigned long>* --> Ids in increasing order, nullptr if there are none
+    */
+    const std::vector<unsigned long>* timeline::Timeline::pulled_posts(const std::string &author) const{
+        auto it = pulled.find(author);
+        return it == pulled.end() || it->second.empty() ? nullptr : &it->second;
+    }
+
+    /**
+     * @namespace timeline
+     * @class Timeline
+     * @name merge()
+     * @brief Build a home timeline: k-way heap merge (newest first) of the user ring buffer
+     *        and the given post lists (own posts, pulled posts of the followed authors).
+     *        Inbox entries whose author isn't allowed anymore (unfollowed) and entries of
+     *        removed posts are skipped.
+     * @param user --> const std::string: Timeline owner
+     * @param lists --> const std::vector<const std::vector<unsigned long>*>: Post id lists read directly
+     * @param allowed --> Allowed: allowed(const post&) --> true: Keep an inbox entry
+     * @param limit --> size_t: Maximum number of posts
+     * @return std::vector<const post*> --> Posts, newest first
+    */
+    template<class Allowed>
+    std::vector<const timeline::Timeline::post*> timeline::Timeline::merge(const std::string &user,
+                                                                           const std::vector<const std::vector<unsigned long>*> &lists,
+                                                                           Allowed allowed, size_t limit) const
+    {
+        std::vector<const post*> ans;
+        const ring *inbox = nullptr;
+        auto in = inboxes.find(user);
+        if(in != inboxes.end()) inbox = &in->second;
+
+        // (post id, source, position from the newest) - source lists.size() is the inbox
+        typedef std::tuple<unsigned long, size_t, size_t> item;
+        std::priority_queue<item> heap;
+        for(size_t i = 0; i < lists.size(); i++) heap.emplace(lists[i]->back(), i, 0);
+        if(inbox && inbox->size()) heap.emplace(inbox->newest(0), lists.size(), 0);
+        unsigned long last = 0;
+        while(!heap.empty() && ans.size() < limit){
+            auto [id, src, pos] = heap.top();
+            heap.pop();
+            size_t next = pos + 1;
+            bool pushed = src == lists.size();
+            if(pushed){
+                if(next < inbox->size()) heap.emplace(inbox->newest(next), src, next);
+            } else if(next < lists[src]->size())
+                heap.emplace((*lists[src])[lists[src]->size() - 1 - next], src, next);
+            if(id == last) continue;
+            last = id;
+            const post *p = get(id);
+            if(p && (!pushed || allowed(*p))) ans.push_back(p);
+        }
+        return ans;
+    }
+
+    /// @brief Append to the ring buffer, overwriting the oldest entry when full
+    void timeline::Timeline::ring::push(unsigned long id){
+        if(buf.size() < INBOX_CAPACITY){
+            buf.push_back(id);
+            return;
+        }
+        buf[head] = id;
+        head = (head + 1) % INBOX_CAPACITY;
+    }
+
+    /// @brief i-th most recent entry of the ring buffer
+    unsigned long timeline::Timeline::ring::newest(size_t i) const{
+        size_t n = buf.size();
+        size_t last = buf.size() < INBOX_CAPACITY ? n - 1 : (head + n - 1) % n;
+        return buf[(last + n - i) % n];
+    }
+
+} // namespace timeline
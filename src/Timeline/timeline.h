@@ -0,0 +1,70 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile timeline.h (header file)
+ * 
+ * Timeline class interface/structure
+ * Posts storage and home timelines. Posts from regular accounts are pushed to the
+ * followers home timelines when published (fan-out on write, bounded ring buffers);
+ * posts from accounts with many followers are pulled when a timeline is read
+ * (fan-out on read). The choice is made once, when the post is published, and kept in
+ * the post. Reads merge all sources with a k-way heap merge.
+ * Include guard
+ * 
+*/
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace timeline{
+
+class Timeline{
+public:
+    struct post{
+        unsigned long id;      // Increasing with publication order
+        std::string author;
+        long long time;        // Unix time (seconds)
+        std::string text;
+        bool pushed;           // Delivered to the follower inboxes (false: pulled on read)
+    };
+
+    static constexpr size_t INBOX_CAPACITY = 512;              // Posts kept per home timeline
+    static constexpr unsigned int CELEBRITY_FOLLOWERS = 1000;  // Above: fan-out on read
+
+    const post& add_post(const std::string &author, long long time, const std::string &text,
+                         bool pushed, unsigned long id = 0);
+    void deliver(const std::string &user, unsigned long id);
+    void remove_user(const std::string &user);
+    const post* get(unsigned long id) const;
+    std::vector<const post*> posts_of(const std::string &author, size_t limit) const;
+    const std::vector<unsigned long>* own_posts(const std::string &author) const;
+    const std::vector<unsigned long>* pulled_posts(const std::string &author) const;
+    template<class Allowed>
+    std::vector<const post*> merge(const std::string &user, const std::vector<const std::vector<unsigned long>*> &lists,
+                                   Allowed allowed, size_t limit) const;
+    std::vector<const post*> all() const;
+    size_t size() const { return posts.size(); } // Inline
+    size_t bytes() const;
+
+private:
+    struct ring{
+        std::vector<unsigned long> buf;
+        size_t head = 0;   // Next write position
+        void push(unsigned long id);
+        size_t size() const { return buf.size(); } // Inline
+        unsigned long newest(size_t i) const;      // i = 0: most recent
+    };
+
+    std::unordered_map<unsigned long, post> posts;
+    unsigned long last_id = 0;
+    std::unordered_map<std::string, std::vector<unsigned long>> authored;
+    std::unordered_map<std::string, std::vector<unsigned long>> pulled;   // Author -> posts not pushed
+    std::unordered_map<std::string, ring> inboxes;
+};
+
+} // namespace timeline
+
+#endif // TIMELINE_H
@@ -0,0 +1,146 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file replay.cpp (.cpp file) (implementation file)
+ *
+ * Replayer class member functions implementation
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include "replay.h"
+#include "../SocialMedia/socialmedia.h"
+#include "../Database/database.h"
+#include "../Storage/logstorage.h"
+
+namespace trace{
+
+    /// @brief Class constructor
+    /// @param records --> const std::vector<record_t>: Trace (must outlive the object)
+    /// @param backend --> const std::string: Storage of the replayers ("memory", "sqlite" or "log")
+    trace::Replayer::Replayer(const std::vector<record_t> &records, const std::string &backend)
+        : records(records), backend(backend){}
+
+    /// @brief Scratch storage file of a replayer (in the temporary directory, never the real database)
+    std::string trace::Replayer::scratch(unsigned int replayer) const{
+        std::string name = "graphsocial_replay_" + std::to_string(getpid()) + "_" + std::to_string(replayer)
+                           + (backend == "log" ? ".log" : ".db");
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    /**
+     * @namespace trace
+     * @class Replayer
+     * @name run()
+     * @brief Replay the trace. At the original speed every operation waits for its recorded
+     *        time and its latency is counted from that time, so an operation delayed by a slow
+     *        one before it shows the delay (no coordinated omission); at the maximum speed the
+     *        operations run back to back. Every replayer has its own network and storage,
+     *        created before the clock starts.
+     * @param speed --> speed_t: ORIGINAL or MAXIMUM
+     * @param replayers --> unsigned int: Concurrent replayers (threads)
+     * @return report_t --> Throughput and latency percentiles per operation type
+    */
+    trace::Replayer::report_t trace::Replayer::run(speed_t speed, unsigned int replayers){
+        using clock = std::chrono::steady_clock;
+        replayers = std::max(1u, replayers);
+        std::vector<std::unique_ptr<socialmedia::SocialMedia>> apps;
+        std::vector<std::unique_ptr<storage::Storage>> dbs;
+        for(unsigned int i = 0; i < replayers; i++){
+            std::string path = scratch(i);
+            std::filesystem::remove(path);
+            apps.push_back(std::make_unique<socialmedia::SocialMedia>());
+            if(backend == "sqlite") dbs.push_back(std::make_unique<database::Database>(*apps[i], path));
+            else if(backend == "log") dbs.push_back(std::make_unique<storage::LogStorage>(*apps[i], path));
+            else dbs.push_back(std::make_unique<storage::MemoryStorage>());
+        }
+        struct local_t{
+            std::vector<std::vector<double>> latency{OPS};   // Microseconds, per operation type
+            std::vector<unsigned long> failures = std::vector<unsigned long>(OPS, 0);
+        };
+        std::vector<local_t> local(replayers);
+        auto start = clock::now();
+        auto replay = [&](unsigned int i){
+            local_t &l = local[i];
+            for(const record_t &r : records){
+                auto begin = clock::now();
+                if(speed == ORIGINAL){
+                    begin = start + std::chrono::microseconds(r.time);
+                    std::this_thread::sleep_until(begin);
+                }
+                if(!apps[i]->execute(r, *dbs[i])) l.failures[r.op]++;
+                l.latency[r.op].push_back(std::chrono::duration<double, std::micro>(clock::now() - begin).count());
+            }
+        };
+        std::vector<std::thread> pool;
+        for(unsigned int i = 1; i < replayers; i++) pool.emplace_back(replay, i);
+        replay(0);
+        for(auto &t : pool) t.join();
+        report_t r;
+        r.speed = speed;
+        r.replayers = replayers;
+        r.seconds = std::chrono::duration<double>(clock::now() - start).count();
+        r.memory = apps[0]->memory_report();
+        for(unsigned int op = USER; op < OPS; op++){
+            std::vector<double> all;
+            stats_t s;
+            s.op = static_cast<op_t>(op);
+            for(auto &l : local){
+                all.insert(all.end(), l.latency[op].begin(), l.latency[op].end());
+                s.failures += l.failures[op];
+            }
+            if(all.empty()) continue;
+            std::sort(all.begin(), all.end());
+            auto percentile = [&](double p){ return all[std::max<size_t>(1, std::ceil(p * all.size())) - 1]; };
+            s.count = all.size();
+            s.throughput = r.seconds > 0 ? s.count / r.seconds : 0;
+            s.p50 = percentile(0.50);
+            s.p90 = percentile(0.90);
+            s.p99 = percentile(0.99);
+            s.max = all.back();
+            r.operations += s.count;
+            r.ops.push_back(s);
+        }
+        dbs.clear();
+        apps.clear();
+        for(unsigned int i = 0; i < replayers; i++){
+            std::string path = scratch(i);
+            for(const char *suffix : {"", "-wal", "-shm", ".compact"}) std::filesystem::remove(path + suffix);
+        }
+        return r;
+    }
+
+    /**
+     * @namespace trace
+     * @overload --> "<<" operator
+     * @brief Bind a replay report in an output stream (one line per operation type)
+     * @param os --> std::ostream: Output stream
+     * @param r --> Replayer::report_t: Report
+     * @return os --> Output stream with the report
+    */
+    std::ostream& operator<<(std::ostream &os, const trace::Replayer::report_t &r){
+        std::ios state(nullptr);
+        state.copyfmt(os);
+        os << std::fixed << std::setprecision(1);
+        os << "Replay (" << (r.speed == Replayer::ORIGINAL ? "velocidade original" : "velocidade máxima") << ", "
+           << r.replayers << (r.replayers == 1 ? " replayer): " : " replayers): ") << r.operations
+           << " operações em " << r.seconds << " s (" << (r.seconds > 0 ? r.operations / r.seconds : 0)
+           << " op/s)" << std::endl;
+        os << "Latência em microssegundos (p50 / p90 / p99 / máx):" << std::endl;
+        for(const auto &s : r.ops){
+            os << "  " << name(s.op) << ": " << s.count << " operações (" << s.failures << " rejeitadas), "
+               << s.throughput << " op/s, " << s.p50 << " / " << s.p90 << " / " << s.p99 << " / " << s.max << std::endl;
+        }
+        os << std::endl << r.memory;
+        os.copyfmt(state);
+        return os;
+    }
+
+} // namespace trace
@@ -0,0 +1,62 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile replay.h (header file)
+ *
+ * Replayer class interface/structure
+ * Runs a recorded trace against fresh instances of the application (a new network and a
+ * new, empty storage per replayer) and reports the throughput and the latency
+ * percentiles of every operation type. Concurrent replayers run the whole trace each,
+ * on their own instances, in parallel.
+ * Include guard
+ *
+*/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "trace.h"
+#include "../Network/memory.h"
+
+namespace trace{
+
+class Replayer{
+public:
+    enum speed_t { ORIGINAL, MAXIMUM };
+
+    static constexpr unsigned int MAX_REPLAYERS = 256;   // Threads (each with its own network and storage)
+
+    struct stats_t{
+        op_t op;
+        unsigned long count = 0;
+        unsigned long failures = 0;   // Rejected operations (missing user, no path...)
+        double throughput = 0;        // Operations per second (all replayers)
+        double p50 = 0, p90 = 0, p99 = 0, max = 0;   // Latency (microseconds)
+    };
+
+    struct report_t{
+        speed_t speed = MAXIMUM;
+        unsigned int replayers = 1;
+        double seconds = 0;              // Wall time of the run
+        unsigned long operations = 0;
+        std::vector<stats_t> ops;        // Operation types present in the trace
+        network::MemoryReport memory;    // Memory of one replayer at the end
+    };
+
+    Replayer(const std::vector<record_t> &records, const std::string &backend = "sqlite");
+    report_t run(speed_t speed = MAXIMUM, unsigned int replayers = 1);
+
+private:
+    const std::vector<record_t> &records;
+    std::string backend;                 // "memory", "sqlite" or "log" (scratch files)
+
+    std::string scratch(unsigned int replayer) const;
+};
+
+std::ostream& operator<<(std::ostream &os, const Replayer::report_t &r);
+
+} // namespace trace
+
+#endif // REPLAY_H
@@ -0,0 +1,133 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @file trace.cpp (.cpp file) (implementation file)
+ *
+ * Recorder class member functions and trace loading implementation
+ *
+*/
+
+#include <algorithm>
+#include <iterator>
+#include "trace.h"
+
+namespace trace{
+
+    /// @brief Class constructor, starts a new trace file (the clock starts here)
+    /// @param path --> const std::string: Trace file (overwritten)
+    trace::Recorder::Recorder(const std::string &path)
+        : file(path, std::ios::binary | std::ios::trunc), last(std::chrono::steady_clock::now())
+    {
+        file.write(MAGIC, sizeof(MAGIC));
+    }
+
+    /// @brief Class destructor --> Write the buffered records
+    trace::Recorder::~Recorder(){
+        flush();
+    }
+
+    /// @brief Append an unsigned integer as a varint (7 bits per byte, low bits first).
+    void trace::Recorder::put(std::string &out, unsigned long long value){
+        while(value >= 0x80){
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    /**
+     * @namespace trace
+     * @class Recorder
+     * @name append()
+     * @brief Append an operation issued now, with its inputs (written in batches)
+     * @param op --> op_t: Operation
+     * @param args --> const Args: Container of operation inputs
+    */
+    template<class Args>
+    void trace::Recorder::append(op_t op, const Args &args){
+        auto now = std::chrono::steady_clock::now();
+        buffer.push_back(static_cast<char>(op));
+        put(buffer, std::chrono::duration_cast<std::chrono::microseconds>(now - last).count());
+        last = now;
+        put(buffer, args.size());
+        for(const auto &a : args){
+            put(buffer, a.size());
+            buffer.append(a);
+        }
+        total++;
+        if(buffer.size() >= FLUSH_BYTES) flush();
+    }
+
+    /// @brief Record an operation issued now (see append())
+    void trace::Recorder::record(op_t op, std::initializer_list<std::string> args){
+        append(op, args);
+    }
+
+    /// @brief Record a batch operation issued now (see append())
+    void trace::Recorder::record(op_t op, const std::vector<std::string> &args){
+        append(op, args);
+    }
+
+    /// @brief Write the buffered records to the file.
+    bool trace::Recorder::flush(){
+        if(!buffer.empty()) file.write(buffer.data(), buffer.size());
+        buffer.clear();
+        file.flush();
+        return file.good();
+    }
+
+    /**
+     * @namespace trace
+     * @name load()
+     * @brief Read a trace file, stopping at the first truncated or invalid record
+     *        (a session that ended abruptly still replays up to its last full record)
+     * @param path --> const std::string: Trace file
+     * @param records --> std::vector<record_t>: Records read, times made absolute
+     * @return bool --> true: Trace file read, false: Missing file or not a trace
+    */
+    bool load(const std::string &path, std::vector<record_t> &records){
+        std::ifstream file(path, std::ios::binary);
+        if(!file.is_open()) return false;
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const char *magic = Recorder::MAGIC;
+        if(data.size() < sizeof(Recorder::MAGIC) || !std::equal(magic, magic + sizeof(Recorder::MAGIC), data.begin()))
+            return false;
+        size_t pos = sizeof(Recorder::MAGIC);
+        auto get = [&](unsigned long long &value){
+            value = 0;
+            for(int shift = 0; pos < data.size() && shift < 64; shift += 7){
+                unsigned char b = data[pos++];
+                value |= (unsigned long long)(b & 0x7F) << shift;
+                if(!(b & 0x80)) return true;
+            }
+            return false;
+        };
+        records.clear();
+        unsigned long long time = 0;
+        while(pos + 1 < data.size()){
+            record_t r;
+            unsigned long long delta, count, len;
+            r.op = static_cast<op_t>(data[pos++]);
+            if(r.op < USER || r.op >= OPS || !get(delta) || !get(count) || count > data.size() - pos) break;
+            bool ok = true;
+            for(unsigned long long i = 0; i < count && ok; i++){
+                ok = get(len) && len <= data.size() - pos;
+                if(ok) r.args.push_back(data.substr(pos, len));
+                if(ok) pos += len;
+            }
+            if(!ok) break;
+            time += delta;
+            r.time = time;
+            records.push_back(std::move(r));
+        }
+        return true;
+    }
+
+    /// @brief Operation name shown in the replay reports
+    const char* name(op_t op){
+        static const char *names[] = {"", "cadastro", "seguir", "deixar de seguir", "consulta", "exclusão",
+                                      "caminho", "ranking", "alcance", "post", "linha do tempo",
+                                      "seguir (lote)", "deixar de seguir (lote)", "exclusão (lote)", "caminho (lote)"};
+        return op < OPS ? names[op] : "?";
+    }
+
+} // namespace trace
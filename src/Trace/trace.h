@@ -0,0 +1,64 @@
+/**
+ * @author Lucas M. T. Friedrich
+ * @headerfile trace.h (header file)
+ *
+ * Workload traces: the operations typed in the menu (or sent by any other front end)
+ * with their inputs and issue times, so a real session can be replayed later by
+ * trace::Replayer. The file starts with MAGIC and every record is
+ * [op][time delta (varint, us)][argument count (varint)][length (varint) + bytes]...
+ * The batch operations carry every pair/user of the batch as arguments.
+ * Include guard
+ *
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace trace{
+
+enum op_t : unsigned char { USER = 1, FOLLOW, UNFOLLOW, LOOKUP, REMOVE, PATH, RANKING, REACH, POST, TIMELINE,
+                           FOLLOW_MANY, UNFOLLOW_MANY, REMOVE_MANY, PATH_MANY, OPS };
+
+struct record_t{
+    op_t op;
+    unsigned long long time;          // Microseconds since the start of the recording
+    std::vector<std::string> args;    // Operation inputs, as typed
+};
+
+class Recorder{
+public:
+    static constexpr char MAGIC[8] = {'G', 'S', 'T', 'R', 'A', 'C', 'E', '1'};
+    static constexpr size_t FLUSH_BYTES = 1 << 16;   // Buffered bytes before a write
+
+    explicit Recorder(const std::string &path);
+    ~Recorder();
+    bool good() const { return file.good(); } // Inline
+    void record(op_t op, std::initializer_list<std::string> args);
+    void record(op_t op, const std::vector<std::string> &args);
+    bool flush();
+    unsigned long records() const { return total; } // Inline
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+private:
+    std::ofstream file;
+    std::string buffer;                              // Records not yet written
+    std::chrono::steady_clock::time_point last;      // Issue time of the previous record
+    unsigned long total = 0;
+
+    static void put(std::string &out, unsigned long long value);
+    template<class Args> void append(op_t op, const Args &args);
+};
+
+bool load(const std::string &path, std::vector<record_t> &records);
+const char* name(op_t op);
+
+} // namespace trace
+
+#endif // TRACE_H